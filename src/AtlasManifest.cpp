@@ -0,0 +1,88 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "AtlasManifest.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace jngl {
+
+namespace {
+
+constexpr int VERSION = 1;
+
+/// Reads the rest of the line without the separating space
+std::string readName(std::istream& in) {
+	std::string name;
+	if (in.get() != ' ' || !std::getline(in, name) || name.empty()) {
+		in.setstate(std::ios::failbit);
+	}
+	return name;
+}
+
+} // namespace
+
+AtlasManifest AtlasManifest::read(std::istream& in, const std::string& filename) {
+	AtlasManifest manifest;
+	std::string line;
+	int lineNumber = 0;
+	const auto error = [&](const std::string& message) {
+		return std::runtime_error(message + " (" + filename + ":" + std::to_string(lineNumber) +
+		                          ")");
+	};
+	while (std::getline(in, line)) {
+		++lineNumber;
+		std::istringstream sstream(line);
+		std::string type;
+		sstream >> type;
+		if (lineNumber == 1) {
+			int version = 0;
+			if (type != "jngl-atlas" || !(sstream >> version)) {
+				throw error("Not a jngl-bake manifest.");
+			}
+			if (version != VERSION) {
+				throw error("Unsupported manifest version " + std::to_string(version) + ".");
+			}
+		} else if (type == "page") {
+			Page page{};
+			sstream >> page.width >> page.height;
+			page.filename = readName(sstream);
+			if (!sstream || page.width <= 0 || page.height <= 0) {
+				throw error("Invalid page.");
+			}
+			manifest.pages.emplace_back(std::move(page));
+		} else if (type == "region") {
+			Region region{};
+			sstream >> region.page >> region.x >> region.y >> region.width >> region.height >>
+			    region.imageWidth >> region.imageHeight;
+			region.name = readName(sstream);
+			if (!sstream || region.page >= manifest.pages.size() || region.x < 0 ||
+			    region.y < 0 || region.width <= 0 || region.height <= 0 ||
+			    region.x + region.width > manifest.pages[region.page].width ||
+			    region.y + region.height > manifest.pages[region.page].height) {
+				throw error("Invalid region.");
+			}
+			manifest.regions.emplace_back(std::move(region));
+		} else if (!type.empty()) {
+			throw error("Unknown entry \"" + type + "\".");
+		}
+	}
+	if (lineNumber == 0) {
+		throw error("Not a jngl-bake manifest.");
+	}
+	return manifest;
+}
+
+void AtlasManifest::write(std::ostream& out) const {
+	out << "jngl-atlas " << VERSION << '\n';
+	for (const auto& page : pages) {
+		out << "page " << page.width << ' ' << page.height << ' ' << page.filename << '\n';
+	}
+	for (const auto& region : regions) {
+		out << "region " << region.page << ' ' << region.x << ' ' << region.y << ' '
+		    << region.width << ' ' << region.height << ' ' << region.imageWidth << ' '
+		    << region.imageHeight << ' ' << region.name << '\n';
+	}
+}
+
+} // namespace jngl
@@ -0,0 +1,54 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace jngl {
+
+/// Text file written by jngl-bake which lists the atlas pages and where each image is on them
+///
+/// \code
+/// jngl-atlas 1
+/// page 1024 512 atlas0.qoi
+/// region 0 2 2 600 300 600 300 player/idle
+/// \endcode
+///
+/// Regions refer to pages by index and are in pixels of the page. Names and filenames come last,
+/// so that they can contain spaces.
+struct AtlasManifest {
+	struct Page {
+		int width;
+		int height;
+		std::string filename; //< relative to the directory of the manifest
+	};
+	struct Region {
+		std::size_t page;
+		int x;
+		int y;
+		int width;
+		int height;
+
+		/// Logical size, differs from width and height when the image has been baked for another
+		/// scale factor
+		int imageWidth;
+		int imageHeight;
+
+		/// Path of the image relative to the baked directory without extension
+		std::string name;
+	};
+	std::vector<Page> pages;
+	std::vector<Region> regions;
+
+	/// \a filename is only used for error messages
+	///
+	/// \throws std::runtime_error if \a in isn't a valid manifest
+	static AtlasManifest read(std::istream& in, const std::string& filename);
+
+	void write(std::ostream&) const;
+};
+
+} // namespace jngl
@@ -0,0 +1,62 @@
+// Copyright 2021-2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "ImageDataDecoded.hpp"
+
+namespace jngl {
+
+ImageDataDecoded::ImageDataDecoded(std::unique_ptr<ImageDecoder> decoder)
+: decoder(std::move(decoder)) {
+#ifndef __EMSCRIPTEN__
+	thread = std::make_unique<std::thread>([this]() { decode(); });
+#else
+	decode();
+#endif
+}
+
+ImageDataDecoded::~ImageDataDecoded() {
+#ifndef __EMSCRIPTEN__
+	if (thread->joinable()) {
+		thread->join();
+	}
+#endif
+}
+
+void ImageDataDecoded::decode() {
+	try {
+		const auto stride = static_cast<std::size_t>(decoder->getWidth()) * 4;
+		data.resize(stride * static_cast<std::size_t>(decoder->getHeight()));
+		decoder->decode(data.data(), stride, true);
+	} catch (...) {
+		error = std::current_exception();
+	}
+}
+
+const uint8_t* ImageDataDecoded::pixels() const {
+#ifndef __EMSCRIPTEN__
+	if (thread->joinable()) {
+		thread->join();
+	}
+#endif
+	if (error) {
+		std::rethrow_exception(error);
+	}
+	return data.data();
+}
+
+int ImageDataDecoded::getWidth() const {
+	return decoder->getWidth();
+}
+
+int ImageDataDecoded::getHeight() const {
+	return decoder->getHeight();
+}
+
+int ImageDataDecoded::getImageWidth() const {
+	return decoder->getImageWidth();
+}
+
+int ImageDataDecoded::getImageHeight() const {
+	return decoder->getImageHeight();
+}
+
+} // namespace jngl
@@ -0,0 +1,44 @@
+// Copyright 2021-2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#pragma once
+
+#include "ImageDecoder.hpp"
+#include "jngl/ImageData.hpp"
+
+#include <thread>
+
+namespace jngl {
+
+/// ImageData of any format supported by ImageDecoder, decoded in a separate thread
+class ImageDataDecoded : public ImageData {
+public:
+	explicit ImageDataDecoded(std::unique_ptr<ImageDecoder>);
+	~ImageDataDecoded() override;
+	ImageDataDecoded(const ImageDataDecoded&) = delete;
+	ImageDataDecoded& operator=(const ImageDataDecoded&) = delete;
+	ImageDataDecoded(ImageDataDecoded&&) = delete;
+	ImageDataDecoded& operator=(ImageDataDecoded&&) = delete;
+
+	/// Blocks until decoding has finished, throws if it failed
+	const uint8_t* pixels() const override;
+
+	int getWidth() const override;
+	int getHeight() const override;
+
+	/// WebP might be scaled while decoding. These functions will return the original image size,
+	/// not the size of the resulting pixel buffer.
+	int getImageWidth() const override;
+	int getImageHeight() const override;
+
+private:
+	void decode();
+
+#ifndef __EMSCRIPTEN__
+	std::unique_ptr<std::thread> thread;
+#endif
+	std::unique_ptr<ImageDecoder> decoder;
+	std::vector<uint8_t> data; //< RGBA without padding
+	std::exception_ptr error;
+};
+
+} // namespace jngl
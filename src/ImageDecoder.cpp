@@ -0,0 +1,368 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "ImageDecoder.hpp"
+
+#include "helper.hpp"
+#include "jngl/Finally.hpp"
+#include "main.hpp"
+
+#ifdef _WIN32
+#include "win32/unicode.hpp"
+#endif
+
+#ifdef ANDROID
+#include "android/fopen.hpp"
+#endif
+
+#if __cplusplus < 202002L
+#include <boost/algorithm/string/predicate.hpp>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+namespace jngl {
+
+namespace {
+
+class BmpDecoder : public ImageDecoder {
+public:
+	BmpDecoder(std::string filename, std::vector<uint8_t> file)
+	: ImageDecoder(std::move(filename), std::move(file)) {
+		// BITMAPFILEHEADER is 14 bytes, the offset of the pixel data is at 10
+		if (this->file.size() < HEADER_END) {
+			throw std::runtime_error("Error reading file. (" + this->filename + ")");
+		}
+		const auto dataOffset = read<uint32_t>(10);
+		if (read<uint32_t>(14) != 40) {
+			throw std::runtime_error("Unsupported header size. (" + this->filename + ")");
+		}
+		imageWidth = width = read<int32_t>(18);
+		height = read<int32_t>(22);
+		if (read<uint16_t>(28) != 24) {
+			throw std::runtime_error("Bpp not supported. (" + this->filename + ")");
+		}
+		if (read<uint32_t>(30) != 0) {
+			throw std::runtime_error("Compression not supported. (" + this->filename + ")");
+		}
+		topDown = height < 0;
+		if (topDown) {
+			height = -height;
+		}
+		imageHeight = height;
+		format = Format::BGR;
+		rowSize = (static_cast<std::size_t>(width) * 3 + 3) & ~std::size_t(3); // padded to 4 bytes
+		if (width <= 0 || dataOffset > this->file.size() ||
+		    (this->file.size() - dataOffset) / rowSize < static_cast<std::size_t>(height)) {
+			throw std::runtime_error("Error reading data. (" + this->filename + ")");
+		}
+		data = this->file.data() + dataOffset;
+	}
+
+	void decode(uint8_t* dst, const std::size_t stride, const bool rgba) override {
+		for (int y = 0; y < height; ++y, dst += stride) {
+			const uint8_t* row = data + rowSize * (topDown ? y : height - 1 - y);
+			if (!rgba) {
+				std::memcpy(dst, row, static_cast<std::size_t>(width) * 3);
+				continue;
+			}
+			for (int x = 0; x < width; ++x, row += 3) {
+				dst[x * 4] = row[2];
+				dst[x * 4 + 1] = row[1];
+				dst[x * 4 + 2] = row[0];
+				dst[x * 4 + 3] = 255;
+			}
+		}
+	}
+
+private:
+	template <class T> T read(const std::size_t offset) const {
+		T value;
+		std::memcpy(&value, &file[offset], sizeof(T)); // BMPs are little endian, like our targets
+		return value;
+	}
+
+	constexpr static std::size_t HEADER_END = 54;
+	const uint8_t* data = nullptr;
+	std::size_t rowSize = 0;
+	bool topDown = false;
+};
+
+/// Decodes the whole image at full resolution and averages boxes of pixels into the destination
+class BoxDownscaler : public ImageDecoder {
+public:
+	BoxDownscaler(std::unique_ptr<ImageDecoder> source, const double scale)
+	: ImageDecoder({}, {}), source(std::move(source)) {
+		imageWidth = this->source->getImageWidth();
+		imageHeight = this->source->getImageHeight();
+		width = std::max(1, static_cast<int>(std::lround(this->source->getWidth() * scale)));
+		height = std::max(1, static_cast<int>(std::lround(this->source->getHeight() * scale)));
+		format = this->source->getFormat();
+	}
+
+	void decode(uint8_t* const dst, const std::size_t stride, const bool rgba) override {
+		const std::size_t channels = bytesPerPixel(rgba ? Format::RGBA : format);
+		const auto srcWidth = static_cast<std::size_t>(source->getWidth());
+		const auto srcHeight = static_cast<std::size_t>(source->getHeight());
+		const std::size_t srcStride = srcWidth * channels;
+		std::vector<uint8_t> src(srcStride * srcHeight);
+		source->decode(src.data(), srcStride, rgba);
+
+		const auto w = static_cast<std::size_t>(width);
+		const auto h = static_cast<std::size_t>(height);
+		const auto boxStart = [](const std::size_t i, const std::size_t srcSize,
+		                         const std::size_t dstSize) { return i * srcSize / dstSize; };
+		// Color channels get weighted by alpha, so that the color of fully transparent pixels
+		// doesn't bleed into the edges:
+		const bool alpha = channels == 4;
+		std::vector<uint64_t> columns(srcStride); // sums of the current box row for each column
+		for (std::size_t dy = 0; dy < h; ++dy) {
+			const std::size_t y0 = boxStart(dy, srcHeight, h);
+			const std::size_t y1 = std::max(y0 + 1, boxStart(dy + 1, srcHeight, h));
+			std::fill(columns.begin(), columns.end(), 0);
+			for (std::size_t y = y0; y < y1; ++y) {
+				const uint8_t* row = &src[y * srcStride];
+				if (alpha) {
+					for (std::size_t i = 0; i < srcStride; i += 4) {
+						const uint64_t a = row[i + 3];
+						columns[i] += row[i] * a;
+						columns[i + 1] += row[i + 1] * a;
+						columns[i + 2] += row[i + 2] * a;
+						columns[i + 3] += a;
+					}
+				} else {
+					for (std::size_t i = 0; i < srcStride; ++i) {
+						columns[i] += row[i];
+					}
+				}
+			}
+			uint8_t* out = dst + dy * stride;
+			for (std::size_t dx = 0; dx < w; ++dx, out += channels) {
+				const std::size_t x0 = boxStart(dx, srcWidth, w);
+				const std::size_t x1 = std::max(x0 + 1, boxStart(dx + 1, srcWidth, w));
+				uint64_t sum[4] = { 0, 0, 0, 0 };
+				for (std::size_t x = x0; x < x1; ++x) {
+					for (std::size_t c = 0; c < channels; ++c) {
+						sum[c] += columns[x * channels + c];
+					}
+				}
+				const uint64_t count = (x1 - x0) * (y1 - y0);
+				if (alpha) {
+					const uint64_t a = sum[3];
+					for (std::size_t c = 0; c < 3; ++c) {
+						out[c] = a == 0 ? 0 : static_cast<uint8_t>((sum[c] + a / 2) / a);
+					}
+					out[3] = static_cast<uint8_t>((a + count / 2) / count);
+				} else {
+					for (std::size_t c = 0; c < channels; ++c) {
+						out[c] = static_cast<uint8_t>((sum[c] + count / 2) / count);
+					}
+				}
+			}
+		}
+	}
+
+private:
+	std::unique_ptr<ImageDecoder> source;
+};
+
+} // namespace
+
+ImageDecoder::ImageDecoder(std::string filename, std::vector<uint8_t> file)
+: filename(std::move(filename)), file(std::move(file)) {
+}
+
+std::unique_ptr<ImageDecoder> ImageDecoder::create(std::string filename, std::vector<uint8_t> file,
+                                                   [[maybe_unused]] const double scaleHint) {
+	const auto startsWith = [&file](const char* magic, const std::size_t offset = 0) {
+		const std::size_t length = std::strlen(magic);
+		return file.size() >= offset + length &&
+		       std::memcmp(file.data() + offset, magic, length) == 0;
+	};
+	std::unique_ptr<ImageDecoder> decoder;
+	if (startsWith("\xABKTX 11\xBB\r\n\x1A\n") || startsWith("\xABKTX 20\xBB\r\n\x1A\n")) {
+		decoder = createKtxDecoder(std::move(filename), std::move(file));
+	} else if (startsWith("qoif")) {
+		decoder = createQoiDecoder(std::move(filename), std::move(file));
+	} else if (startsWith("BM")) {
+		decoder = std::make_unique<BmpDecoder>(std::move(filename), std::move(file));
+	}
+#ifndef NOPNG
+	else if (startsWith("\x89PNG")) {
+		decoder = createPngDecoder(std::move(filename), std::move(file));
+	}
+#endif
+#ifndef NOWEBP
+	else if (startsWith("RIFF") && startsWith("WEBP", 8)) {
+		decoder = createWebPDecoder(std::move(filename), std::move(file), scaleHint);
+	}
+#endif
+	else {
+		throw std::runtime_error("Unsupported image format. (" + filename + ")");
+	}
+	if (scaleHint + 1e-9 < 1 && !decoder->getCompressed() &&
+	    decoder->getWidth() == decoder->getImageWidth() &&
+	    decoder->getHeight() == decoder->getImageHeight()) { // format can't scale by itself
+		decoder = std::make_unique<BoxDownscaler>(std::move(decoder), scaleHint);
+	}
+	return decoder;
+}
+
+std::unique_ptr<ImageDecoder> ImageDecoder::load(const std::string& filename, const double scale) {
+	const char* extensions[] = {
+		".ktx2",
+		".ktx",
+		".qoi",
+#ifndef NOWEBP
+		".webp",
+#endif
+#ifndef NOPNG
+		".png",
+#endif
+		".bmp"
+	};
+	struct Variant {
+		const char* suffix;
+		double scale;
+	};
+	const Variant variants[] = { { "@0.5x", 0.5 }, { "", 1 }, { "@2x", 2 } };
+
+	// Try the smallest variant which is at least as large as needed first, then larger ones and
+	// at last the smaller ones starting with the largest:
+	std::vector<const Variant*> candidates;
+	for (const auto& variant : variants) {
+		if (variant.scale + 1e-9 >= scale) {
+			candidates.push_back(&variant);
+		}
+	}
+	for (auto it = std::rbegin(variants); it != std::rend(variants); ++it) {
+		if (it->scale + 1e-9 < scale) {
+			candidates.push_back(&*it);
+		}
+	}
+
+	const auto fullFilename = pathPrefix + filename;
+	const char* givenExtension = nullptr;
+	for (const char* extension : extensions) {
+#if __cplusplus < 202002L
+		if (boost::algorithm::ends_with(fullFilename, extension)) {
+#else
+		if (fullFilename.ends_with(extension)) {
+#endif
+			givenExtension = extension;
+			break;
+		}
+	}
+	const std::string stem =
+	    givenExtension ? fullFilename.substr(0, fullFilename.size() - std::strlen(givenExtension))
+	                   : fullFilename;
+	std::string path;
+	double variantScale = 1;
+	for (const Variant* variant : candidates) {
+		if (givenExtension) {
+			if (variant->scale == 1) { // not checking if it exists to get "File not found" below
+				path = fullFilename;
+			} else if (std::string tmp = stem + variant->suffix + givenExtension;
+			           fileExists(tmp)) {
+				path = std::move(tmp);
+			}
+		} else {
+			for (const char* extension : extensions) {
+				if (std::string tmp = stem + variant->suffix + extension; fileExists(tmp)) {
+					path = std::move(tmp);
+					break;
+				}
+			}
+		}
+		if (!path.empty()) {
+			variantScale = variant->scale;
+			break;
+		}
+	}
+	if (path.empty()) {
+		std::ostringstream message;
+		message << "No suitable image file found for: " << fullFilename
+		        << "\nSupported file extensions: ";
+		for (size_t i = 0; i < std::size(extensions); ++i) {
+			if (i != 0) {
+				message << ", ";
+			}
+			message << extensions[i];
+		}
+		throw std::runtime_error(message.str());
+	}
+#ifdef _WIN32
+	FILE* const fp = _wfopen(utf8ToUtf16(path).c_str(), L"rb");
+#else
+	FILE* const fp = fopen(path.c_str(), "rb");
+#endif
+	if (fp == nullptr) {
+		throw std::runtime_error("File not found: " + path);
+	}
+	std::vector<uint8_t> file;
+	{
+		Finally closeFile([fp]() { fclose(fp); });
+		file = readFile(fp, path);
+	}
+	auto decoder = create(filename, std::move(file), scale / variantScale);
+	if (variantScale != 1) {
+		decoder->imageWidth =
+		    std::max(1, static_cast<int>(std::lround(decoder->imageWidth / variantScale)));
+		decoder->imageHeight =
+		    std::max(1, static_cast<int>(std::lround(decoder->imageHeight / variantScale)));
+	}
+	return decoder;
+}
+
+std::vector<uint8_t> ImageDecoder::readFile(FILE* const fp, const std::string& filename) {
+	const long start = ftell(fp);
+	if (start < 0 || fseek(fp, 0, SEEK_END) != 0) {
+		throw std::runtime_error("Error reading " + filename);
+	}
+	const long end = ftell(fp);
+	if (end < start || fseek(fp, start, SEEK_SET) != 0) {
+		throw std::runtime_error("Error reading " + filename);
+	}
+	std::vector<uint8_t> buf(static_cast<std::size_t>(end - start));
+	if (!buf.empty() && fread(buf.data(), buf.size(), 1, fp) != 1) {
+		throw std::runtime_error("Error reading " + filename);
+	}
+	return buf;
+}
+
+int ImageDecoder::getWidth() const {
+	return width;
+}
+
+int ImageDecoder::getHeight() const {
+	return height;
+}
+
+int ImageDecoder::getImageWidth() const {
+	return imageWidth;
+}
+
+int ImageDecoder::getImageHeight() const {
+	return imageHeight;
+}
+
+auto ImageDecoder::getFormat() const -> Format {
+	return format;
+}
+
+auto ImageDecoder::getCompressed() const -> const Compressed* {
+	return nullptr;
+}
+
+std::size_t ImageDecoder::bytesPerPixel(const Format format) {
+	return format == Format::RGBA ? 4 : 3;
+}
+
+std::size_t ImageDecoder::alignedStride(const bool rgba) const {
+	return (static_cast<std::size_t>(width) * bytesPerPixel(rgba ? Format::RGBA : format) + 3) &
+	       ~std::size_t(3);
+}
+
+} // namespace jngl
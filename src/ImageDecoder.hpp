@@ -0,0 +1,124 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace jngl {
+
+/// Decodes an image file straight into memory provided by the caller
+///
+/// The file is read into memory with a single fread and parsed from there. decode() writes the
+/// pixels to their final destination, e.g. the buffer passed to glTexImage2D, so there are no
+/// intermediate row buffers or copies.
+class ImageDecoder {
+public:
+	enum class Format : uint8_t {
+		RGB,
+		RGBA,
+		BGR,
+	};
+
+	/// Block-compressed GPU texture formats
+	enum class CompressedFormat : uint8_t {
+		BC1,
+		BC1_ALPHA,
+		BC3,
+		BC7,
+		ETC2_RGB,
+		ETC2_RGB_A1,
+		ETC2_RGBA,
+		ASTC,
+	};
+
+	struct Compressed {
+		CompressedFormat format;
+		uint8_t blockWidth; //< 4 except for ASTC
+		uint8_t blockHeight;
+		const uint8_t* data; //< first mip level, points into the file
+		std::size_t size;
+	};
+
+	/// Finds the image file for \a filename (which may omit the extension) and reads its header
+	///
+	/// If there are pre-authored resolution variants next to the file, e.g. foo@0.5x.png or
+	/// foo@2x.png, the smallest one which is at least \a scale gets used (or the largest one if
+	/// all of them are smaller). Whatever is left to reach \a scale is done while decoding, but
+	/// only when scaling down. getImageWidth() and getImageHeight() always return the size of the
+	/// 1x image, so that the layout doesn't depend on which file has been picked.
+	static std::unique_ptr<ImageDecoder> load(const std::string& filename, double scale);
+
+	/// Chooses the decoder by looking at the first bytes of \a file and reads the header
+	///
+	/// \a filename is only used for error messages. If \a scaleHint is smaller than 1 the image
+	/// gets scaled down while decoding, otherwise it's ignored. Throws std::runtime_error if the
+	/// file is invalid or its format isn't supported.
+	static std::unique_ptr<ImageDecoder> create(std::string filename, std::vector<uint8_t> file,
+	                                            double scaleHint = 1.);
+
+	/// Reads the whole file from the current position
+	static std::vector<uint8_t> readFile(FILE*, const std::string& filename);
+
+	ImageDecoder(const ImageDecoder&) = delete;
+	ImageDecoder& operator=(const ImageDecoder&) = delete;
+	ImageDecoder(ImageDecoder&&) = delete;
+	ImageDecoder& operator=(ImageDecoder&&) = delete;
+	virtual ~ImageDecoder() = default;
+
+	/// Writes getHeight() rows of getWidth() pixels to \a dst, row i starts at dst + i * stride
+	///
+	/// If \a rgba is true the pixels get converted to RGBA (opaque if the image has no alpha
+	/// channel), otherwise they are written in getFormat(). Can only be called once and may be
+	/// called from another thread. Throws std::runtime_error if the file is corrupt.
+	virtual void decode(uint8_t* dst, std::size_t stride, bool rgba) = 0;
+
+	/// Size of the pixels written by decode()
+	int getWidth() const;
+	int getHeight() const;
+
+	/// Logical size of the image, differs from getWidth() and getHeight() when scaling
+	int getImageWidth() const;
+	int getImageHeight() const;
+
+	/// Pixel format written by decode() when not forcing RGBA
+	Format getFormat() const;
+
+	/// Block-compressed data of GPU texture containers (KTX), nullptr for other formats
+	///
+	/// If the GPU supports the format the data can be uploaded as is, otherwise decode() converts
+	/// it to RGBA on the CPU (only for BC1, BC3 and ETC2 without punch-through alpha).
+	virtual const Compressed* getCompressed() const;
+
+	static std::size_t bytesPerPixel(Format);
+
+	/// Smallest stride which is a multiple of 4, so that glTexImage2D can be used with the default
+	/// GL_UNPACK_ALIGNMENT
+	std::size_t alignedStride(bool rgba) const;
+
+protected:
+	ImageDecoder(std::string filename, std::vector<uint8_t> file);
+
+	std::string filename;
+	std::vector<uint8_t> file;
+	int width = 0;
+	int height = 0;
+	int imageWidth = 0;
+	int imageHeight = 0;
+	Format format = Format::RGBA;
+};
+
+std::unique_ptr<ImageDecoder> createQoiDecoder(std::string filename, std::vector<uint8_t> file);
+std::unique_ptr<ImageDecoder> createKtxDecoder(std::string filename, std::vector<uint8_t> file);
+#ifndef NOPNG
+std::unique_ptr<ImageDecoder> createPngDecoder(std::string filename, std::vector<uint8_t> file);
+#endif
+#ifndef NOWEBP
+std::unique_ptr<ImageDecoder> createWebPDecoder(std::string filename, std::vector<uint8_t> file,
+                                                double scaleHint);
+#endif
+
+} // namespace jngl
@@ -0,0 +1,482 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "ImageDecoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace jngl {
+
+namespace {
+
+using CompressedFormat = ImageDecoder::CompressedFormat;
+
+uint8_t clamp255(const int value) {
+	return static_cast<uint8_t>(std::clamp(value, 0, 255));
+}
+
+/// 4x4 block decoded to RGBA, row-major
+using Block = uint8_t[16][4];
+
+void decodeBc1(const uint8_t* const src, Block& out, const bool fourColors, const bool alpha) {
+	const auto expand565 = [](const uint16_t c, uint8_t* rgb) {
+		const int r = (c >> 11) & 0x1f;
+		const int g = (c >> 5) & 0x3f;
+		const int b = c & 0x1f;
+		rgb[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+		rgb[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+		rgb[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+	};
+	const auto c0 = static_cast<uint16_t>(src[0] | (src[1] << 8));
+	const auto c1 = static_cast<uint16_t>(src[2] | (src[3] << 8));
+	uint8_t palette[4][4];
+	expand565(c0, palette[0]);
+	expand565(c1, palette[1]);
+	palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+	for (int i = 0; i < 3; ++i) {
+		if (fourColors || c0 > c1) {
+			palette[2][i] = static_cast<uint8_t>((2 * palette[0][i] + palette[1][i]) / 3);
+			palette[3][i] = static_cast<uint8_t>((palette[0][i] + 2 * palette[1][i]) / 3);
+		} else {
+			palette[2][i] = static_cast<uint8_t>((palette[0][i] + palette[1][i]) / 2);
+			palette[3][i] = 0;
+		}
+	}
+	if (alpha && !fourColors && c0 <= c1) {
+		palette[3][3] = 0;
+	}
+	const uint32_t indices = src[4] | (src[5] << 8) | (src[6] << 16) | (uint32_t(src[7]) << 24);
+	for (int i = 0; i < 16; ++i) {
+		std::memcpy(out[i], palette[(indices >> (2 * i)) & 3], 4);
+	}
+}
+
+void decodeBc3Alpha(const uint8_t* const src, Block& out) {
+	int palette[8] = { src[0], src[1] };
+	if (palette[0] > palette[1]) {
+		for (int i = 1; i < 7; ++i) {
+			palette[i + 1] = ((7 - i) * palette[0] + i * palette[1]) / 7;
+		}
+	} else {
+		for (int i = 1; i < 5; ++i) {
+			palette[i + 1] = ((5 - i) * palette[0] + i * palette[1]) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+	uint64_t indices = 0;
+	for (int i = 0; i < 6; ++i) {
+		indices |= uint64_t(src[2 + i]) << (8 * i);
+	}
+	for (int i = 0; i < 16; ++i) {
+		out[i][3] = static_cast<uint8_t>(palette[(indices >> (3 * i)) & 7]);
+	}
+}
+
+uint64_t readBigEndian64(const uint8_t* const src) {
+	uint64_t value = 0;
+	for (int i = 0; i < 8; ++i) {
+		value = (value << 8) | src[i];
+	}
+	return value;
+}
+
+/// ETC1 and ETC2 RGB, see the OpenGL ES 3.0 specification, section C.1
+void decodeEtc2Rgb(const uint8_t* const src, Block& out) {
+	const uint64_t bits = readBigEndian64(src);
+	const auto field = [bits](const int lsb, const int count) {
+		return static_cast<int>((bits >> lsb) & ((1u << count) - 1));
+	};
+	const auto extend4 = [](const int c) { return (c << 4) | c; };
+	const auto extend5 = [](const int c) { return (c << 3) | (c >> 2); };
+	// Pixels are stored column-major: index i = x * 4 + y
+	const auto pixelIndex = [&field](const int x, const int y) {
+		const int i = x * 4 + y;
+		return (field(16 + i, 1) << 1) | field(i, 1);
+	};
+	const auto set = [&out](const int x, const int y, const int r, const int g, const int b) {
+		out[y * 4 + x][0] = clamp255(r);
+		out[y * 4 + x][1] = clamp255(g);
+		out[y * 4 + x][2] = clamp255(b);
+		out[y * 4 + x][3] = 255;
+	};
+
+	// In differential mode an overflow of the red, green or blue base color selects the T, H or
+	// planar mode respectively
+	const auto overflows = [&field](const int lsb) {
+		const int value = field(lsb + 3, 5) + (field(lsb, 3) ^ 4) - 4;
+		return value < 0 || value > 31;
+	};
+	const bool differential = field(33, 1) != 0;
+	if (!differential || (!overflows(56) && !overflows(48) && !overflows(40))) {
+		// individual or differential mode
+		constexpr static int MODIFIERS[8][2] = { { 2, 8 },   { 5, 17 },  { 9, 29 },   { 13, 42 },
+			                                     { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 } };
+		int base[2][3];
+		if (!differential) {
+			for (int c = 0; c < 3; ++c) {
+				base[0][c] = extend4(field(60 - c * 8, 4));
+				base[1][c] = extend4(field(56 - c * 8, 4));
+			}
+		} else {
+			for (int c = 0; c < 3; ++c) {
+				const int value = field(59 - c * 8, 5);
+				base[0][c] = extend5(value);
+				base[1][c] = extend5(value + (field(56 - c * 8, 3) ^ 4) - 4);
+			}
+		}
+		const int tables[2] = { field(37, 3), field(34, 3) };
+		const bool flip = field(32, 1) != 0;
+		for (int y = 0; y < 4; ++y) {
+			for (int x = 0; x < 4; ++x) {
+				const int subBlock = flip ? (y >= 2) : (x >= 2);
+				const int index = pixelIndex(x, y);
+				int modifier = MODIFIERS[tables[subBlock]][index & 1];
+				if (index & 2) {
+					modifier = -modifier;
+				}
+				set(x, y, base[subBlock][0] + modifier, base[subBlock][1] + modifier,
+				    base[subBlock][2] + modifier);
+			}
+		}
+		return;
+	}
+	constexpr static int DISTANCES[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+	int paint[4][3];
+	if (overflows(56)) {
+		// T mode
+		const int c1[3] = { extend4((field(59, 2) << 2) | field(56, 2)), extend4(field(52, 4)),
+			                extend4(field(48, 4)) };
+		const int c2[3] = { extend4(field(44, 4)), extend4(field(40, 4)), extend4(field(36, 4)) };
+		const int distance = DISTANCES[(field(34, 2) << 1) | field(32, 1)];
+		for (int c = 0; c < 3; ++c) {
+			paint[0][c] = c1[c];
+			paint[1][c] = c2[c] + distance;
+			paint[2][c] = c2[c];
+			paint[3][c] = c2[c] - distance;
+		}
+	} else if (overflows(48)) {
+		// H mode
+		const int r1 = field(59, 4);
+		const int g1 = (field(56, 3) << 1) | field(52, 1);
+		const int b1 = (field(51, 1) << 3) | field(47, 3);
+		const int r2 = field(43, 4);
+		const int g2 = field(39, 4);
+		const int b2 = field(35, 4);
+		const int order = ((r1 << 8) | (g1 << 4) | b1) >= ((r2 << 8) | (g2 << 4) | b2) ? 1 : 0;
+		const int distance = DISTANCES[(field(34, 1) << 2) | (field(32, 1) << 1) | order];
+		const int c1[3] = { extend4(r1), extend4(g1), extend4(b1) };
+		const int c2[3] = { extend4(r2), extend4(g2), extend4(b2) };
+		for (int c = 0; c < 3; ++c) {
+			paint[0][c] = c1[c] + distance;
+			paint[1][c] = c1[c] - distance;
+			paint[2][c] = c2[c] + distance;
+			paint[3][c] = c2[c] - distance;
+		}
+	} else {
+		// planar mode
+		const auto extend6 = [](const int c) { return (c << 2) | (c >> 4); };
+		const auto extend7 = [](const int c) { return (c << 1) | (c >> 6); };
+		const int o[3] = { extend6(field(57, 6)), extend7((field(56, 1) << 6) | field(49, 6)),
+			               extend6((field(48, 1) << 5) | (field(43, 2) << 3) |
+			                       (field(40, 2) << 1) | field(39, 1)) };
+		const int h[3] = { extend6((field(34, 5) << 1) | field(32, 1)), extend7(field(25, 7)),
+			               extend6(field(19, 6)) };
+		const int v[3] = { extend6(field(13, 6)), extend7(field(6, 7)), extend6(field(0, 6)) };
+		for (int y = 0; y < 4; ++y) {
+			for (int x = 0; x < 4; ++x) {
+				int rgb[3];
+				for (int c = 0; c < 3; ++c) {
+					rgb[c] = (x * (h[c] - o[c]) + y * (v[c] - o[c]) + 4 * o[c] + 2) >> 2;
+				}
+				set(x, y, rgb[0], rgb[1], rgb[2]);
+			}
+		}
+		return;
+	}
+	for (int y = 0; y < 4; ++y) {
+		for (int x = 0; x < 4; ++x) {
+			const int* color = paint[pixelIndex(x, y)];
+			set(x, y, color[0], color[1], color[2]);
+		}
+	}
+}
+
+/// EAC alpha of ETC2 RGBA8, see the OpenGL ES 3.0 specification, section C.1.3
+void decodeEacAlpha(const uint8_t* const src, Block& out) {
+	constexpr static int8_t MODIFIERS[16][8] = {
+		{ -3, -6, -9, -15, 2, 5, 8, 14 }, { -3, -7, -10, -13, 2, 6, 9, 12 },
+		{ -2, -5, -8, -13, 1, 4, 7, 12 }, { -2, -4, -6, -13, 1, 3, 5, 12 },
+		{ -3, -6, -8, -12, 2, 5, 7, 11 }, { -3, -7, -9, -11, 2, 6, 8, 10 },
+		{ -4, -7, -8, -11, 3, 6, 7, 10 }, { -3, -5, -8, -11, 2, 4, 7, 10 },
+		{ -2, -6, -8, -10, 1, 5, 7, 9 },  { -2, -5, -8, -10, 1, 4, 7, 9 },
+		{ -2, -4, -8, -10, 1, 3, 7, 9 },  { -2, -5, -7, -10, 1, 4, 6, 9 },
+		{ -3, -4, -7, -10, 2, 3, 6, 9 },  { -1, -2, -3, -10, 0, 1, 2, 9 },
+		{ -4, -6, -8, -9, 3, 5, 7, 8 },   { -3, -5, -7, -9, 2, 4, 6, 8 },
+	};
+	const uint64_t bits = readBigEndian64(src);
+	const int base = src[0];
+	const int multiplier = src[1] >> 4;
+	const int8_t* const modifiers = MODIFIERS[src[1] & 0xf];
+	for (int x = 0; x < 4; ++x) {
+		for (int y = 0; y < 4; ++y) {
+			const int index = static_cast<int>((bits >> (45 - 3 * (x * 4 + y))) & 7);
+			out[y * 4 + x][3] = clamp255(base + modifiers[index] * multiplier);
+		}
+	}
+}
+
+/// Reads KTX 1.1 and KTX 2.0 containers, but only the first mip level of a single 2D image.
+/// Supercompressed KTX2 files (Basis Universal, Zstandard) aren't supported.
+class KtxDecoder : public ImageDecoder {
+public:
+	KtxDecoder(std::string filename, std::vector<uint8_t> file)
+	: ImageDecoder(std::move(filename), std::move(file)) {
+		if (this->file.size() < KTX1_HEADER_SIZE) {
+			throw std::runtime_error("Error reading file. (" + this->filename + ")");
+		}
+		std::size_t dataOffset = 0;
+		std::size_t dataSize = 0;
+		if (this->file[5] == '1') {
+			if (read<uint32_t>(12) != 0x04030201) {
+				throw std::runtime_error("Big endian KTX files aren't supported. (" +
+				                         this->filename + ")");
+			}
+			// glType, pixelDepth, numberOfArrayElements, numberOfFaces:
+			if (read<uint32_t>(16) != 0 || read<uint32_t>(44) > 1 || read<uint32_t>(48) > 0 ||
+			    read<uint32_t>(52) != 1) {
+				throw std::runtime_error("Only compressed 2D KTX textures are supported. (" +
+				                         this->filename + ")");
+			}
+			setFormatFromGl(read<uint32_t>(28));
+			width = static_cast<int>(read<uint32_t>(36));
+			height = static_cast<int>(read<uint32_t>(40));
+			// skip bytesOfKeyValueData and the imageSize of the first level
+			dataOffset = KTX1_HEADER_SIZE + std::size_t(read<uint32_t>(60)) + 4;
+			if (dataOffset > this->file.size()) {
+				throw std::runtime_error("Error reading file. (" + this->filename + ")");
+			}
+			dataSize = read<uint32_t>(dataOffset - 4);
+		} else {
+			if (this->file.size() < KTX2_HEADER_SIZE + KTX2_LEVEL_SIZE) {
+				throw std::runtime_error("Error reading file. (" + this->filename + ")");
+			}
+			if (read<uint32_t>(44) != 0) {
+				throw std::runtime_error("Supercompressed KTX2 files aren't supported. (" +
+				                         this->filename + ")");
+			}
+			// pixelDepth, layerCount, faceCount:
+			if (read<uint32_t>(28) > 1 || read<uint32_t>(32) > 0 || read<uint32_t>(36) != 1) {
+				throw std::runtime_error("Only 2D KTX2 textures are supported. (" +
+				                         this->filename + ")");
+			}
+			setFormatFromVulkan(read<uint32_t>(12));
+			width = static_cast<int>(read<uint32_t>(20));
+			height = static_cast<int>(read<uint32_t>(24));
+			const auto offset = read<uint64_t>(KTX2_HEADER_SIZE);
+			const auto size = read<uint64_t>(KTX2_HEADER_SIZE + 8);
+			if (offset > this->file.size()) {
+				throw std::runtime_error("Error reading file. (" + this->filename + ")");
+			}
+			dataOffset = static_cast<std::size_t>(offset);
+			dataSize = static_cast<std::size_t>(size);
+		}
+		if (width <= 0 || height <= 0) {
+			throw std::runtime_error("Invalid texture size. (" + this->filename + ")");
+		}
+		imageWidth = width;
+		imageHeight = height;
+		format = Format::RGBA;
+		const std::size_t blocksX = (width + compressed.blockWidth - 1) / compressed.blockWidth;
+		const std::size_t blocksY = (height + compressed.blockHeight - 1) / compressed.blockHeight;
+		compressed.size = blocksX * blocksY * blockBytes();
+		if (dataSize < compressed.size || this->file.size() - dataOffset < compressed.size) {
+			throw std::runtime_error("Error reading data. (" + this->filename + ")");
+		}
+		compressed.data = this->file.data() + dataOffset;
+	}
+
+	const Compressed* getCompressed() const override {
+		return &compressed;
+	}
+
+	void decode(uint8_t* const dst, const std::size_t stride, bool /* always RGBA */) override {
+		const char* name = nullptr;
+		switch (compressed.format) {
+			case CompressedFormat::BC7:
+				name = "BC7";
+				break;
+			case CompressedFormat::ETC2_RGB_A1:
+				name = "ETC2 with punch-through alpha";
+				break;
+			case CompressedFormat::ASTC:
+				name = "ASTC";
+				break;
+			default:
+				break;
+		}
+		if (name) {
+			throw std::runtime_error(std::string("The GPU doesn't support ") + name +
+			                         " textures and there's no CPU fallback. (" + filename + ")");
+		}
+		const uint8_t* src = compressed.data;
+		for (int blockY = 0; blockY < height; blockY += 4) {
+			for (int blockX = 0; blockX < width; blockX += 4, src += blockBytes()) {
+				Block block;
+				switch (compressed.format) {
+					case CompressedFormat::BC1:
+						decodeBc1(src, block, false, false);
+						break;
+					case CompressedFormat::BC1_ALPHA:
+						decodeBc1(src, block, false, true);
+						break;
+					case CompressedFormat::BC3:
+						decodeBc1(src + 8, block, true, false);
+						decodeBc3Alpha(src, block);
+						break;
+					case CompressedFormat::ETC2_RGB:
+						decodeEtc2Rgb(src, block);
+						break;
+					case CompressedFormat::ETC2_RGBA:
+						decodeEtc2Rgb(src + 8, block);
+						decodeEacAlpha(src, block);
+						break;
+					default:
+						break;
+				}
+				// Blocks on the right and bottom edge might be cut off:
+				const int columns = std::min(4, width - blockX);
+				for (int y = 0; y < std::min(4, height - blockY); ++y) {
+					std::memcpy(dst + static_cast<std::size_t>(blockY + y) * stride + blockX * 4,
+					            block[y * 4], static_cast<std::size_t>(columns) * 4);
+				}
+			}
+		}
+	}
+
+private:
+	template <class T> T read(const std::size_t offset) const {
+		T value;
+		std::memcpy(&value, &file[offset], sizeof(T)); // little endian, like our targets
+		return value;
+	}
+
+	std::size_t blockBytes() const {
+		switch (compressed.format) {
+			case CompressedFormat::BC1:
+			case CompressedFormat::BC1_ALPHA:
+			case CompressedFormat::ETC2_RGB:
+			case CompressedFormat::ETC2_RGB_A1:
+				return 8;
+			default:
+				return 16;
+		}
+	}
+
+	void setAstc(const uint32_t index) {
+		constexpr static uint8_t BLOCK_SIZES[14][2] = {
+			{ 4, 4 },  { 5, 4 },  { 5, 5 },  { 6, 5 },   { 6, 6 },   { 8, 5 },   { 8, 6 },
+			{ 8, 8 },  { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 },
+		};
+		compressed.format = CompressedFormat::ASTC;
+		compressed.blockWidth = BLOCK_SIZES[index][0];
+		compressed.blockHeight = BLOCK_SIZES[index][1];
+	}
+
+	/// sRGB variants are treated like their UNORM counterparts, just like PNGs
+	void setFormatFromVulkan(const uint32_t vkFormat) {
+		if (vkFormat >= 157 && vkFormat <= 184) { // VK_FORMAT_ASTC_4x4_UNORM_BLOCK ...
+			return setAstc((vkFormat - 157) / 2);
+		}
+		switch (vkFormat) {
+			case 131: // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+			case 132:
+				compressed.format = CompressedFormat::BC1;
+				break;
+			case 133: // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+			case 134:
+				compressed.format = CompressedFormat::BC1_ALPHA;
+				break;
+			case 137: // VK_FORMAT_BC3_UNORM_BLOCK
+			case 138:
+				compressed.format = CompressedFormat::BC3;
+				break;
+			case 145: // VK_FORMAT_BC7_UNORM_BLOCK
+			case 146:
+				compressed.format = CompressedFormat::BC7;
+				break;
+			case 147: // VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK
+			case 148:
+				compressed.format = CompressedFormat::ETC2_RGB;
+				break;
+			case 149: // VK_FORMAT_ETC2_R8G8B8A1_UNORM_BLOCK
+			case 150:
+				compressed.format = CompressedFormat::ETC2_RGB_A1;
+				break;
+			case 151: // VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK
+			case 152:
+				compressed.format = CompressedFormat::ETC2_RGBA;
+				break;
+			default:
+				throw std::runtime_error("Unsupported KTX2 format " + std::to_string(vkFormat) +
+				                         ". (" + filename + ")");
+		}
+	}
+
+	void setFormatFromGl(const uint32_t glInternalFormat) {
+		if (glInternalFormat >= 0x93B0 && glInternalFormat <= 0x93BD) { // GL_COMPRESSED_RGBA_ASTC_*
+			return setAstc(glInternalFormat - 0x93B0);
+		}
+		if (glInternalFormat >= 0x93D0 && glInternalFormat <= 0x93DD) { // ..._SRGB8_ALPHA8_ASTC_*
+			return setAstc(glInternalFormat - 0x93D0);
+		}
+		switch (glInternalFormat) {
+			case 0x83F0: // GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+			case 0x8C4C: // GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+				compressed.format = CompressedFormat::BC1;
+				break;
+			case 0x83F1: // GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+			case 0x8C4D: // GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+				compressed.format = CompressedFormat::BC1_ALPHA;
+				break;
+			case 0x83F3: // GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+			case 0x8C4F: // GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT
+				compressed.format = CompressedFormat::BC3;
+				break;
+			case 0x8E8C: // GL_COMPRESSED_RGBA_BPTC_UNORM
+			case 0x8E8D: // GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM
+				compressed.format = CompressedFormat::BC7;
+				break;
+			case 0x8D64: // GL_ETC1_RGB8_OES, ETC2 is backwards compatible
+			case 0x9274: // GL_COMPRESSED_RGB8_ETC2
+			case 0x9275: // GL_COMPRESSED_SRGB8_ETC2
+				compressed.format = CompressedFormat::ETC2_RGB;
+				break;
+			case 0x9276: // GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+			case 0x9277: // GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2
+				compressed.format = CompressedFormat::ETC2_RGB_A1;
+				break;
+			case 0x9278: // GL_COMPRESSED_RGBA8_ETC2_EAC
+			case 0x9279: // GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC
+				compressed.format = CompressedFormat::ETC2_RGBA;
+				break;
+			default:
+				throw std::runtime_error("Unsupported KTX format " +
+				                         std::to_string(glInternalFormat) + ". (" + filename + ")");
+		}
+	}
+
+	constexpr static std::size_t KTX1_HEADER_SIZE = 64;
+	constexpr static std::size_t KTX2_HEADER_SIZE = 80;
+	constexpr static std::size_t KTX2_LEVEL_SIZE = 24;
+	Compressed compressed{ CompressedFormat::BC1, 4, 4, nullptr, 0 };
+};
+
+} // namespace
+
+std::unique_ptr<ImageDecoder> createKtxDecoder(std::string filename, std::vector<uint8_t> file) {
+	return std::make_unique<KtxDecoder>(std::move(filename), std::move(file));
+}
+
+} // namespace jngl
@@ -0,0 +1,126 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "ImageDecoder.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace jngl {
+
+namespace {
+
+/// Decoder for the "Quite OK Image Format", see https://qoiformat.org/qoi-specification.pdf
+class QoiDecoder : public ImageDecoder {
+public:
+	QoiDecoder(std::string filename, std::vector<uint8_t> file)
+	: ImageDecoder(std::move(filename), std::move(file)) {
+		if (this->file.size() < HEADER_SIZE + PADDING_SIZE) {
+			throw std::runtime_error("Error reading file. (" + this->filename + ")");
+		}
+		const uint32_t w = readBigEndian(4);
+		const uint32_t h = readBigEndian(8);
+		const uint8_t channels = this->file[12];
+		if (w == 0 || h == 0 || h >= MAX_PIXELS / w || (channels != 3 && channels != 4)) {
+			throw std::runtime_error("Invalid QOI header. (" + this->filename + ")");
+		}
+		imageWidth = width = static_cast<int>(w);
+		imageHeight = height = static_cast<int>(h);
+		format = channels == 4 ? Format::RGBA : Format::RGB;
+	}
+
+	void decode(uint8_t* const dst, const std::size_t stride, const bool rgba) override {
+		if (rgba || format == Format::RGBA) {
+			decodeTo<4>(dst, stride);
+		} else {
+			decodeTo<3>(dst, stride);
+		}
+	}
+
+private:
+	uint32_t readBigEndian(const std::size_t offset) const {
+		return (uint32_t(file[offset]) << 24) | (uint32_t(file[offset + 1]) << 16) |
+		       (uint32_t(file[offset + 2]) << 8) | uint32_t(file[offset + 3]);
+	}
+
+	template <std::size_t CHANNELS> void decodeTo(uint8_t* const dst, const std::size_t stride) {
+		struct Pixel {
+			uint8_t r, g, b, a;
+		};
+		Pixel index[64] = {};
+		Pixel px{ 0, 0, 0, 255 };
+		const uint8_t* p = file.data() + HEADER_SIZE;
+		// Every chunk is at most 5 bytes long. Valid files end with 8 bytes of padding, so there's
+		// no need to check the bounds inside a chunk:
+		const uint8_t* const end = file.data() + file.size() - PADDING_SIZE;
+		uint32_t run = 0;
+		for (int y = 0; y < height; ++y) {
+			uint8_t* out = dst + static_cast<std::size_t>(y) * stride;
+			for (int x = 0; x < width; ++x, out += CHANNELS) {
+				if (run > 0) {
+					--run;
+				} else {
+					if (p >= end) {
+						throw std::runtime_error("Unexpected end of file. (" + filename + ")");
+					}
+					const uint8_t b1 = *p++;
+					if (b1 == OP_RGB) {
+						px.r = p[0];
+						px.g = p[1];
+						px.b = p[2];
+						p += 3;
+					} else if (b1 == OP_RGBA) {
+						px = { p[0], p[1], p[2], p[3] };
+						p += 4;
+					} else {
+						switch (b1 & MASK) {
+							case OP_INDEX:
+								px = index[b1];
+								break;
+							case OP_DIFF:
+								px.r += ((b1 >> 4) & 0x03) - 2;
+								px.g += ((b1 >> 2) & 0x03) - 2;
+								px.b += (b1 & 0x03) - 2;
+								break;
+							case OP_LUMA: {
+								const uint8_t b2 = *p++;
+								const int vg = (b1 & 0x3f) - 32;
+								px.r += vg - 8 + ((b2 >> 4) & 0x0f);
+								px.g += vg;
+								px.b += vg - 8 + (b2 & 0x0f);
+								break;
+							}
+							default: // OP_RUN, the bias of -1 accounts for the current pixel
+								run = b1 & 0x3f;
+								break;
+						}
+					}
+					index[(px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64] = px;
+				}
+				out[0] = px.r;
+				out[1] = px.g;
+				out[2] = px.b;
+				if constexpr (CHANNELS == 4) {
+					out[3] = px.a;
+				}
+			}
+		}
+	}
+
+	constexpr static std::size_t HEADER_SIZE = 14;
+	constexpr static std::size_t PADDING_SIZE = 8;
+	constexpr static uint32_t MAX_PIXELS = 400000000;
+	constexpr static uint8_t OP_INDEX = 0x00;
+	constexpr static uint8_t OP_DIFF = 0x40;
+	constexpr static uint8_t OP_LUMA = 0x80;
+	constexpr static uint8_t OP_RGB = 0xfe;
+	constexpr static uint8_t OP_RGBA = 0xff;
+	constexpr static uint8_t MASK = 0xc0;
+};
+
+} // namespace
+
+std::unique_ptr<ImageDecoder> createQoiDecoder(std::string filename, std::vector<uint8_t> file) {
+	return std::make_unique<QoiDecoder>(std::move(filename), std::move(file));
+}
+
+} // namespace jngl
@@ -4,8 +4,11 @@
 #include "Sound.hpp"
 
 #include "audio.hpp"
+#include "audio/StreamingTrack.hpp"
 #include "audio/Track.hpp"
+#include "audio/constants.hpp"
 #include "audio/effect/loop.hpp"
+#include "audio/effect/pitch.hpp"
 #include "audio/effect/volume.hpp"
 
 #include <cassert>
@@ -13,38 +16,79 @@
 namespace jngl {
 
 struct Sound::Impl {
-	std::shared_ptr<PlayingTrack> track;
-	std::shared_ptr<Stream> stream;
+	std::shared_ptr<Track> track;
+	std::shared_ptr<Stream> stream; //< either volumeControl or loopStream
 	std::shared_ptr<audio::volume_control> volumeControl;
-	std::shared_ptr<std::vector<float>> buffer; //< we might outlive our SoundFile
+	std::shared_ptr<Stream> loopStream; //< preallocated for PcmBuffers, so that loop() can be reused
+	std::shared_ptr<PcmBuffer> buffer; //< we might outlive our SoundFile
+	PlayingTrack* playingTrack = nullptr;
+	StreamingTrack* streamingTrack = nullptr;
+	long rate = audio::frequency; //< sample rate of track
+	bool looping = false;
 };
 
-Sound::Sound(std::shared_ptr<std::vector<float>> bufferData)
-: impl(new Impl{ std::make_shared<PlayingTrack>(*bufferData), {}, {}, std::move(bufferData) }) {
+Sound::Sound(std::shared_ptr<PcmBuffer> bufferData) : impl(std::make_unique<Impl>()) {
+	auto track = std::make_shared<PlayingTrack>(*bufferData);
+	impl->playingTrack = track.get();
+	impl->track = std::move(track);
+	impl->buffer = std::move(bufferData);
 	impl->stream = impl->volumeControl = audio::volume(impl->track);
+	impl->loopStream = audio::loop(impl->volumeControl);
+}
+
+Sound::Sound(std::shared_ptr<StreamingTrack> track) : impl(std::make_unique<Impl>()) {
+	impl->track = track;
+	impl->streamingTrack = track.get();
+	impl->rate = track->getRate();
+	std::shared_ptr<Stream> resampled = std::move(track);
+	if (impl->rate != audio::frequency) {
+		resampled = audio::pitch(std::move(resampled),
+		                         static_cast<float>(impl->rate) / audio::frequency);
+	}
+	impl->stream = impl->volumeControl = audio::volume(std::move(resampled));
 }
 
 Sound::~Sound() = default;
 
+void Sound::reset(std::shared_ptr<PcmBuffer> bufferData) {
+	assert(impl->playingTrack);
+	impl->playingTrack->reset(*bufferData);
+	impl->buffer = std::move(bufferData);
+	impl->volumeControl->gain(1.f);
+	impl->stream = impl->volumeControl;
+	impl->looping = false;
+}
+
 bool Sound::isPlaying() const {
 	return impl->stream->isPlaying();
 }
 
 bool Sound::isLooping() const {
-	return impl->stream != impl->volumeControl;
+	return impl->looping;
 }
 
 void Sound::loop() {
 	assert(!isLooping());
-	impl->stream = audio::loop(impl->volumeControl);
+	impl->looping = true;
+	if (impl->streamingTrack) {
+		impl->streamingTrack->setLooping(true); // gapless, without having to rewind
+	} else {
+		impl->loopStream->rewind();
+		impl->stream = impl->loopStream;
+	}
 }
 
 void Sound::setVolume(float v) {
 	impl->volumeControl->gain(v);
 }
 
+void Sound::seek(std::chrono::milliseconds position) {
+	impl->track->seek(static_cast<std::size_t>(position.count() * impl->rate / 1000 * 2));
+}
+
 std::shared_ptr<Stream> Sound::getStream() {
-	return impl->stream;
+	// aliasing constructor, doesn't allocate
+	return { shared_from_this(), impl->stream.get() };
 }
 
 float Sound::progress() const {
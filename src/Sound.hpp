@@ -3,26 +3,44 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
-#include <vector>
 
 namespace jngl {
 
+struct PcmBuffer;
 struct Stream;
 struct SoundParams;
+class StreamingTrack;
 
-class Sound {
+/// Always owned by a std::shared_ptr, the Stream returned by getStream() keeps it alive
+class Sound : public std::enable_shared_from_this<Sound> {
 public:
-	explicit Sound(std::shared_ptr<std::vector<float>> bufferData);
+	explicit Sound(std::shared_ptr<PcmBuffer> bufferData);
+
+	/// Plays a file which is decoded while playing
+	explicit Sound(std::shared_ptr<StreamingTrack>);
+
 	Sound(const Sound&) = delete;
 	Sound& operator=(const Sound&) = delete;
 	Sound(Sound&&) = default;
 	Sound& operator=(Sound&&) = default;
 	~Sound();
+
+	/// Play \a bufferData from the start, reusing the Streams of this Sound
+	///
+	/// Must not be called while this Sound is still added to a Channel. Only works for Sounds
+	/// which have been constructed from a PcmBuffer, too.
+	void reset(std::shared_ptr<PcmBuffer> bufferData);
+
 	bool isPlaying() const;
 	bool isLooping() const;
 	void loop();
 	void setVolume(float v);
+	void seek(std::chrono::milliseconds);
+
+	/// Shares ownership with this Sound, so as long as a Mixer uses the Stream, use_count() of the
+	/// Sound won't be 1
 	std::shared_ptr<Stream> getStream();
 
 	/// returns 0...1 and will reset when looping
@@ -2,7 +2,10 @@
 // For conditions of distribution and use, see copyright notice in LICENSE.txt
 #include "TextureCache.hpp"
 
+#include "helper.hpp"
+
 #include <cassert>
+#include <cstring>
 
 namespace jngl {
 
@@ -18,7 +21,25 @@ std::shared_ptr<Texture> TextureCache::get(std::string_view filename) {
 	return it->second;
 }
 
-void TextureCache::insert(std::string_view filename, std::shared_ptr<Texture> texture) {
+std::shared_ptr<Texture> TextureCache::find(const uint64_t contentHash, const std::size_t bytes) {
+	const auto it = byContent.find(contentHash);
+	if (it == byContent.end()) {
+		return nullptr;
+	}
+	auto texture = it->second.lock();
+	if (!texture) {
+		byContent.erase(it);
+		return nullptr;
+	}
+	bytesSaved += bytes;
+	return texture;
+}
+
+void TextureCache::insert(std::string_view filename, std::shared_ptr<Texture> texture,
+                          const std::optional<uint64_t> contentHash) {
+	if (contentHash) {
+		byContent[*contentHash] = texture;
+	}
 	auto result [[maybe_unused]] = textures.emplace(filename, std::move(texture));
 	assert(result.second);
 }
@@ -32,6 +53,29 @@ void TextureCache::remove(std::string_view filename) {
 	if (it != textures.end()) {
 		textures.erase(it);
 	}
+	std::erase_if(byContent, [](const auto& entry) { return entry.second.expired(); });
+}
+
+uint64_t TextureCache::contentHash(const float preciseWidth, const float preciseHeight,
+                                   const int width, const int height, const unsigned int format,
+                                   const bool trimmed, const uint8_t* data,
+                                   const std::size_t rowBytes, const std::size_t stride,
+                                   const std::size_t rows) {
+	// The vertexes of a Texture depend on the precise size and the hull, so they have to match too:
+	uint32_t header[6] = {
+		static_cast<uint32_t>(width), static_cast<uint32_t>(height), format, 0, 0, trimmed
+	};
+	std::memcpy(&header[3], &preciseWidth, sizeof(float));
+	std::memcpy(&header[4], &preciseHeight, sizeof(float));
+	uint64_t hash = hash64(header, sizeof(header));
+	for (std::size_t y = 0; y < rows; ++y, data += stride) {
+		hash = hash64(data, rowBytes, hash);
+	}
+	return hash;
+}
+
+std::size_t TextureCache::getBytesSaved() const {
+	return bytesSaved;
 }
 
 } // namespace jngl
@@ -4,7 +4,10 @@
 
 #include "jngl/Singleton.hpp"
 
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <unordered_map>
 
 namespace jngl {
 
@@ -13,9 +16,29 @@ class Texture;
 class TextureCache : public Singleton<TextureCache> {
 public:
 	std::shared_ptr<Texture> get(std::string_view filename);
-	void insert(std::string_view filename, std::shared_ptr<Texture>);
+
+	/// Looks up a texture with the same contentHash() which is still in use
+	///
+	/// Returns nullptr if there isn't one. Otherwise \a bytes are added to getBytesSaved().
+	std::shared_ptr<Texture> find(uint64_t contentHash, std::size_t bytes);
+
+	/// \a contentHash makes the texture available to find() as long as it's referenced anywhere
+	void insert(std::string_view filename, std::shared_ptr<Texture>,
+	            std::optional<uint64_t> contentHash = std::nullopt);
 	void remove(std::string_view filename);
 
+	/// Hashes the pixels (or compressed blocks) together with everything else that affects how
+	/// the texture is drawn. Can be called from any thread.
+	///
+	/// \a rows rows of \a rowBytes each are read from \a data, padding up to \a stride is ignored.
+	/// \a trimmed tells whether the texture gets an alpha hull, see Texture::setHull.
+	static uint64_t contentHash(float preciseWidth, float preciseHeight, int width, int height,
+	                            unsigned int format, bool trimmed, const uint8_t* data,
+	                            std::size_t rowBytes, std::size_t stride, std::size_t rows);
+
+	/// Sum of the texture sizes that didn't need to be uploaded thanks to find()
+	std::size_t getBytesSaved() const;
+
 private:
 	// https://www.cppstories.com/2021/heterogeneous-access-cpp20/
 	struct string_hash {
@@ -32,6 +55,10 @@ private:
 	};
 	std::unordered_map<std::string, std::shared_ptr<Texture>, string_hash, std::equal_to<>>
 	    textures;
+
+	/// Secondary index, weak so that the texture is freed when the last Sprite using it is gone
+	std::unordered_map<uint64_t, std::weak_ptr<Texture>> byContent;
+	std::size_t bytesSaved = 0;
 };
 
 } // namespace jngl
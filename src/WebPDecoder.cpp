@@ -0,0 +1,59 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#ifndef NOWEBP
+#include "ImageDecoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <webp/decode.h>
+
+namespace jngl {
+
+namespace {
+
+class WebPDecoder : public ImageDecoder {
+public:
+	WebPDecoder(std::string filename, std::vector<uint8_t> file, const double scaleHint)
+	: ImageDecoder(std::move(filename), std::move(file)) {
+		if (!WebPGetInfo(this->file.data(), this->file.size(), &imageWidth, &imageHeight)) {
+			throw std::runtime_error("Invalid WebP file. (" + this->filename + ")");
+		}
+		WebPInitDecoderConfig(&config);
+		config.options.use_threads = 1;
+		width = imageWidth;
+		height = imageHeight;
+		if (scaleHint + 1e-9 < 1) { // only use WebP's scaler when scaling down, otherwise use OpenGL
+			config.options.use_scaling = 1;
+			config.options.scaled_width = width =
+			    std::max(1, static_cast<int>(std::lround(imageWidth * scaleHint)));
+			config.options.scaled_height = height =
+			    std::max(1, static_cast<int>(std::lround(imageHeight * scaleHint)));
+		}
+		format = Format::RGBA;
+	}
+
+	void decode(uint8_t* const dst, const std::size_t stride, bool /* always RGBA */) override {
+		config.output.colorspace = MODE_RGBA;
+		config.output.is_external_memory = 1;
+		config.output.u.RGBA.rgba = dst;                      // NOLINT
+		config.output.u.RGBA.stride = static_cast<int>(stride); // NOLINT
+		config.output.u.RGBA.size = stride * static_cast<std::size_t>(height); // NOLINT
+		if (WebPDecode(file.data(), file.size(), &config) != VP8_STATUS_OK) {
+			throw std::runtime_error("Can't decode WebP file. (" + filename + ")");
+		}
+	}
+
+private:
+	WebPDecoderConfig config{};
+};
+
+} // namespace
+
+std::unique_ptr<ImageDecoder> createWebPDecoder(std::string filename, std::vector<uint8_t> file,
+                                                const double scaleHint) {
+	return std::make_unique<WebPDecoder>(std::move(filename), std::move(file), scaleHint);
+}
+
+} // namespace jngl
+#endif
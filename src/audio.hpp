@@ -11,12 +11,18 @@
 
 namespace jngl {
 
+struct AudioDeviceParameters;
+struct AudioStatistics;
 class Channel;
 class Mixer;
 class Sound;
 class SoundFile;
+struct PcmBuffer;
 
 namespace audio {
+class OfflineRenderer;
+class SubmixWorkers;
+struct SampleClock;
 struct pitch_control;
 struct volume_control;
 } // namespace audio
@@ -32,22 +38,47 @@ public:
 	Audio& operator=(Audio&&) = delete;
 	~Audio();
 
-	void play(Channel&, std::shared_ptr<Sound> sound);
-	void stop(Channel&, std::shared_ptr<Sound>& sound);
+	/// Returns a Sound which plays \a buffer, recycling a finished one if possible
+	///
+	/// Doesn't allocate as long as there are less than VOICE_POOL_SIZE Sounds in use.
+	std::shared_ptr<Sound> newSound(std::shared_ptr<PcmBuffer> buffer);
+
+	void play(Channel&, const std::shared_ptr<Sound>& sound, int priority = 0,
+	          std::int64_t start = 0);
+	void stop(Channel&, const std::shared_ptr<Sound>& sound, std::int64_t stop = 0);
 	void increasePauseDeviceCount();
 	void decreasePauseDeviceCount();
 	void setPitch(float pitch);
 	float getVolume() const;
 	void setVolume(float volume);
 	Channel& getMainChannel();
-	void registerChannel(std::shared_ptr<Stream>);
-	void unregisterChannel(const Stream&);
+	/// Clock of the main Mixer, Channels use it to schedule their Streams
+	std::shared_ptr<const audio::SampleClock> getClock() const;
+	/// \a mixer is the one of the Channel which ends up in \a stream, used for getStatistics()
+	void registerChannel(std::shared_ptr<Stream> stream, const Mixer& mixer);
+	void unregisterChannel(const Stream&, const Mixer&);
+	/// Returns Sounds which are neither playing nor referenced anymore back to the pool
 	void step();
+
+	/// nullptr unless JNGL_AUDIO_BACKEND=offline, see audio::engine
+	audio::OfflineRenderer* getOfflineRenderer();
+	/// see jngl::setAudioWorkerThreads
+	void setWorkerThreads(unsigned int count);
+	void setDeviceParameters(const AudioDeviceParameters&);
+	AudioStatistics getStatistics() const;
 	std::shared_ptr<SoundFile> getSoundFile(const std::string& filename, std::launch policy);
 
 private:
-	std::vector<std::shared_ptr<Sound>> sounds_;
+	constexpr static std::size_t VOICE_POOL_SIZE = 128;
+
+	/// Preallocated Sounds for in-memory SoundFiles, so that playing one doesn't allocate. Sounds
+	/// with a use_count of 1 are only referenced by this vector.
+	std::vector<std::shared_ptr<Sound>> voices;
+	std::vector<std::size_t> freeVoices; //< indices into voices which can be reset
+	std::vector<std::size_t> busyVoices; //< indices into voices which step() has to check
+	std::unique_ptr<audio::SubmixWorkers> workers; //< only set after setWorkerThreads
 	std::shared_ptr<Mixer> mixer;
+	std::vector<const Mixer*> channelMixers;
 	std::unique_ptr<Channel> mainChannel;
 	std::shared_ptr<audio::pitch_control> pitchControl;
 	std::shared_ptr<audio::volume_control> volumeControl;
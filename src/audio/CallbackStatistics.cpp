@@ -0,0 +1,56 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "CallbackStatistics.hpp"
+
+#include "../jngl/sound.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace jngl::audio {
+
+void CallbackStatistics::record(std::chrono::steady_clock::duration duration,
+                                std::size_t frames, int sampleRate) {
+	const auto nanoseconds = std::min<std::chrono::nanoseconds::rep>(
+	    std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(),
+	    std::numeric_limits<std::uint32_t>::max());
+	const auto index = callbacks.load(std::memory_order_relaxed);
+	durations[index % HISTORY].store(static_cast<std::uint32_t>(nanoseconds),
+	                                 std::memory_order_relaxed);
+	if (sampleRate > 0 &&
+	    nanoseconds * sampleRate > static_cast<std::int64_t>(frames) * 1'000'000'000) {
+		lateCallbacks.fetch_add(1, std::memory_order_relaxed);
+	}
+	bufferFrames.store(static_cast<std::uint32_t>(frames), std::memory_order_relaxed);
+	this->sampleRate.store(sampleRate, std::memory_order_relaxed);
+	callbacks.store(index + 1, std::memory_order_release);
+}
+
+void CallbackStatistics::snapshot(AudioStatistics& statistics) const {
+	const auto count = static_cast<std::size_t>(
+	    std::min<std::uint64_t>(callbacks.load(std::memory_order_acquire), HISTORY));
+	statistics.lateCallbacks = lateCallbacks.load(std::memory_order_relaxed);
+	statistics.bufferFrames = bufferFrames.load(std::memory_order_relaxed);
+	statistics.sampleRate = sampleRate.load(std::memory_order_relaxed);
+	if (count == 0) {
+		return;
+	}
+	std::array<std::uint32_t, HISTORY> copy; // NOLINT
+	std::uint64_t sum = 0;
+	for (std::size_t i = 0; i < count; ++i) {
+		copy[i] = durations[i].load(std::memory_order_relaxed);
+		sum += copy[i];
+	}
+	statistics.minCallback =
+	    std::chrono::nanoseconds(*std::min_element(copy.begin(), copy.begin() + count));
+	statistics.averageCallback = std::chrono::nanoseconds(sum / count);
+	const auto p99 = copy.begin() + (count * 99 + 99) / 100 - 1;
+	std::nth_element(copy.begin(), p99, copy.begin() + count);
+	statistics.p99Callback = std::chrono::nanoseconds(*p99);
+	if (statistics.sampleRate > 0) {
+		const double deadline = 1e9 * statistics.bufferFrames / statistics.sampleRate;
+		statistics.load = static_cast<float>(static_cast<double>(sum) / count / deadline);
+	}
+}
+
+} // namespace jngl::audio
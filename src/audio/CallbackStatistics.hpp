@@ -0,0 +1,42 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace jngl {
+struct AudioStatistics;
+
+namespace audio {
+
+/// Durations of the last callbacks of the audio device
+///
+/// Written by the audio thread and read by the main thread, both without locking: Every entry is
+/// an atomic on its own, so that a snapshot might mix two consecutive callbacks, but never sees a
+/// torn value.
+class CallbackStatistics {
+public:
+	/// Called by the audio thread after it filled a buffer of \a frames at \a sampleRate
+	void record(std::chrono::steady_clock::duration duration, std::size_t frames,
+	            int sampleRate);
+
+	/// Fills everything except the voice counts
+	void snapshot(AudioStatistics&) const;
+
+	/// Enough to cover about three seconds with the default buffer size
+	constexpr static std::size_t HISTORY = 512;
+
+private:
+	std::array<std::atomic<std::uint32_t>, HISTORY> durations{}; //< in nanoseconds
+	std::atomic<std::uint64_t> callbacks{ 0 };
+	std::atomic<std::uint64_t> lateCallbacks{ 0 };
+	std::atomic<std::uint32_t> bufferFrames{ 0 };
+	std::atomic<std::int32_t> sampleRate{ 0 };
+};
+
+} // namespace audio
+} // namespace jngl
@@ -0,0 +1,103 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "OfflineRenderer.hpp"
+
+#include "Stream.hpp"
+#include "constants.hpp"
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+namespace jngl::audio {
+
+double RenderStatistics::realtimeFactor() const {
+	if (total.count() == 0) {
+		return 0;
+	}
+	const std::chrono::duration<double> seconds = total;
+	return static_cast<double>(frames) / frequency / seconds.count();
+}
+
+OfflineRenderer::OfflineRenderer(std::shared_ptr<Stream> output, std::size_t blockFrames)
+: output(std::move(output)), buffer(blockFrames * 2) {
+}
+
+RenderStatistics OfflineRenderer::render(std::size_t frames, std::vector<float>* out) {
+	RenderStatistics statistics;
+	std::vector<std::chrono::nanoseconds> durations;
+	durations.reserve(frames / (buffer.size() / 2) + 1);
+	if (out) {
+		out->reserve(out->size() + frames * 2);
+	}
+	while (statistics.frames < frames) {
+		const auto count = std::min(buffer.size(), (frames - statistics.frames) * 2);
+		const auto start = std::chrono::steady_clock::now();
+		const auto read = output->read(buffer.data(), count);
+		durations.emplace_back(std::chrono::steady_clock::now() - start);
+		std::fill(buffer.begin() + static_cast<std::ptrdiff_t>(read), buffer.end(), 0.f);
+		if (out) {
+			out->insert(out->end(), buffer.begin(),
+			            buffer.begin() + static_cast<std::ptrdiff_t>(count));
+		}
+		statistics.frames += count / 2;
+	}
+
+	statistics.blocks = durations.size();
+	if (durations.empty()) {
+		return statistics;
+	}
+	for (const auto& duration : durations) {
+		statistics.total += duration;
+	}
+	const auto [min, max] = std::minmax_element(durations.begin(), durations.end());
+	statistics.min = *min;
+	statistics.max = *max;
+	const auto p99 = durations.begin() + static_cast<std::ptrdiff_t>(durations.size() * 99 / 100);
+	std::nth_element(durations.begin(), p99, durations.end());
+	statistics.p99 = *p99;
+	return statistics;
+}
+
+namespace {
+void writeLittleEndian(std::ofstream& file, std::uint32_t value, int bytes) {
+	for (int i = 0; i < bytes; ++i) {
+		file.put(static_cast<char>((value >> (8 * i)) & 0xff));
+	}
+}
+} // namespace
+
+void writeWav(const std::string& filename, const std::vector<float>& samples) {
+	std::ofstream file(filename, std::ios::binary);
+	if (!file) {
+		throw std::runtime_error("Couldn't open " + filename + " for writing.");
+	}
+	std::vector<std::int16_t> pcm(samples.size());
+	kernels().to_s16(pcm.data(), samples.data(), samples.size());
+
+	const auto dataSize = static_cast<std::uint32_t>(pcm.size() * sizeof(std::int16_t));
+	const std::uint32_t channels = 2;
+	const std::uint32_t bitsPerSample = 16;
+	file.write("RIFF", 4);
+	writeLittleEndian(file, 36 + dataSize, 4);
+	file.write("WAVEfmt ", 8);
+	writeLittleEndian(file, 16, 4); // size of the fmt chunk
+	writeLittleEndian(file, 1, 2);  // PCM
+	writeLittleEndian(file, channels, 2);
+	writeLittleEndian(file, frequency, 4);
+	writeLittleEndian(file, frequency * channels * bitsPerSample / 8, 4); // bytes per second
+	writeLittleEndian(file, channels * bitsPerSample / 8, 2);             // bytes per frame
+	writeLittleEndian(file, bitsPerSample, 2);
+	file.write("data", 4);
+	writeLittleEndian(file, dataSize, 4);
+	for (const auto sample : pcm) {
+		writeLittleEndian(file, static_cast<std::uint16_t>(sample), 2);
+	}
+	if (!file) {
+		throw std::runtime_error("Couldn't write " + filename + ".");
+	}
+}
+
+} // namespace jngl::audio
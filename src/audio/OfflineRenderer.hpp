@@ -0,0 +1,53 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace jngl {
+struct Stream;
+
+namespace audio {
+
+/// Timing of the blocks rendered by OfflineRenderer::render
+struct RenderStatistics {
+	std::size_t blocks = 0;
+	std::size_t frames = 0;
+	std::chrono::nanoseconds total{ 0 };
+	std::chrono::nanoseconds min{ 0 };
+	std::chrono::nanoseconds max{ 0 };
+	std::chrono::nanoseconds p99{ 0 }; //< 99th percentile of the block durations
+
+	/// How many times faster than a sound card would have needed the frames
+	double realtimeFactor() const;
+};
+
+/// Pulls from a Stream as fast as possible instead of at the speed of a sound card
+///
+/// Used by the offline backend of audio::engine (JNGL_AUDIO_BACKEND=offline) to render or
+/// benchmark the mixing graph without audio hardware.
+class OfflineRenderer {
+public:
+	/// \a blockFrames is the number of stereo frames read at once, like the buffer size of a sound
+	/// card
+	explicit OfflineRenderer(std::shared_ptr<Stream> output, std::size_t blockFrames = 256);
+
+	/// Renders \a frames stereo frames and appends them to \a out unless it's nullptr
+	RenderStatistics render(std::size_t frames, std::vector<float>* out = nullptr);
+
+private:
+	std::shared_ptr<Stream> output;
+	std::vector<float> buffer;
+};
+
+/// Writes interleaved stereo samples at audio::frequency as a 16 bit PCM WAV file
+///
+/// \throws std::runtime_error if the file couldn't be written
+void writeWav(const std::string& filename, const std::vector<float>& samples);
+
+} // namespace audio
+} // namespace jngl
@@ -0,0 +1,147 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "Resampler.hpp"
+
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+namespace jngl::audio {
+
+namespace {
+
+/// Modified Bessel function of the first kind, order 0
+double besselI0(double x) {
+	double sum = 1;
+	double term = 1;
+	for (int k = 1; k < 32; ++k) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+/// Stop band attenuation of about 60 dB
+constexpr double KAISER_BETA = 6;
+
+/// Output frames processed at once, limits the size of the arrays on the stack
+constexpr std::size_t BLOCK_FRAMES = 128;
+
+} // namespace
+
+Resampler::Resampler(float cutoff) : bank((PHASES + 1) * TAPS * 2) {
+	assert(cutoff > 0 && cutoff <= 1);
+	// With only 16 taps the transition band is wide, so start rolling off a bit earlier to keep
+	// aliasing low:
+	const double fc = 0.92 * cutoff;
+	const double half = TAPS / 2.;
+	for (int phase = 0; phase <= PHASES; ++phase) {
+		const double frac = static_cast<double>(phase) / PHASES;
+		float* const coefficients = &bank[static_cast<std::size_t>(phase) * TAPS * 2];
+		double sum = 0;
+		double h[TAPS];
+		for (int k = 0; k < TAPS; ++k) {
+			// distance between input frame k and the position we want to interpolate
+			const double x = k - FRAMES_BEFORE - frac;
+			const double sinc =
+			    x == 0 ? 1 : std::sin(std::numbers::pi * fc * x) / (std::numbers::pi * fc * x);
+			const double r = x / half;
+			const double window = std::abs(r) >= 1 ? 0
+			                                       : besselI0(KAISER_BETA * std::sqrt(1 - r * r)) /
+			                                             besselI0(KAISER_BETA);
+			h[k] = sinc * window;
+			sum += h[k];
+		}
+		for (int k = 0; k < TAPS; ++k) {
+			// normalize so that DC passes with a gain of exactly 1:
+			coefficients[2 * k] = coefficients[2 * k + 1] = static_cast<float>(h[k] / sum);
+		}
+	}
+}
+
+const Resampler& Resampler::forCutoff(const float cutoff) {
+	constexpr int STEPS = 8;
+	static const std::vector<Resampler> banks = [] {
+		std::vector<Resampler> banks;
+		for (int i = 1; i <= STEPS; ++i) {
+			banks.emplace_back(static_cast<float>(i) / STEPS);
+		}
+		return banks;
+	}();
+	const auto step = std::clamp(static_cast<int>(std::floor(cutoff * STEPS)), 1, STEPS);
+	return banks[static_cast<std::size_t>(step - 1)];
+}
+
+const float* Resampler::coefficients(float frac) const {
+	const auto phase = static_cast<std::size_t>(frac * PHASES + 0.5f);
+	assert(phase <= PHASES);
+	return &bank[phase * TAPS * 2];
+}
+
+void Resampler::process(float* dst, const float* src, const std::uint32_t* index,
+                        const float* frac, std::size_t frame_count) const {
+	const auto fir = kernels().fir_stereo;
+	std::uint32_t start[BLOCK_FRAMES];
+	const float* coefficientsPerFrame[BLOCK_FRAMES];
+	while (frame_count > 0) {
+		const auto frames = std::min(frame_count, BLOCK_FRAMES);
+		for (std::size_t i = 0; i < frames; ++i) {
+			assert(index[i] >= FRAMES_BEFORE);
+			start[i] = index[i] - FRAMES_BEFORE;
+			coefficientsPerFrame[i] = coefficients(frac[i]);
+		}
+		fir(dst, src, start, coefficientsPerFrame, frames, TAPS);
+		dst += 2 * frames;
+		index += frames;
+		frac += frames;
+		frame_count -= frames;
+	}
+}
+
+std::vector<float> Resampler::convert(const std::vector<float>& input, int channels, long inRate,
+                                      long outRate) {
+	assert(channels == 1 || channels == 2);
+	if (inRate == outRate) {
+		return input; // the filter isn't transparent at phase 0, so don't apply it needlessly
+	}
+	const auto frames = input.size() / static_cast<std::size_t>(channels);
+	const Resampler resampler(
+	    std::min(1.f, static_cast<float>(outRate) / static_cast<float>(inRate)));
+
+	// interleaved stereo with silence before and after, so that every tap has an input frame
+	std::vector<float> padded((FRAMES_BEFORE + frames + FRAMES_AFTER + 1) * 2, 0.f);
+	for (std::size_t i = 0; i < frames; ++i) {
+		padded[(FRAMES_BEFORE + i) * 2] = input[i * channels];
+		padded[(FRAMES_BEFORE + i) * 2 + 1] = input[i * channels + channels - 1];
+	}
+
+	const auto outFrames =
+	    static_cast<std::size_t>(static_cast<std::int64_t>(frames) * outRate / inRate);
+	std::vector<float> stereo(outFrames * 2);
+	std::uint32_t index[BLOCK_FRAMES];
+	float frac[BLOCK_FRAMES];
+	for (std::size_t done = 0; done < outFrames;) {
+		const auto count = std::min(outFrames - done, BLOCK_FRAMES);
+		for (std::size_t i = 0; i < count; ++i) {
+			// exact integer arithmetic, so that there's no drift even for long files
+			const auto numerator = static_cast<std::int64_t>(done + i) * inRate;
+			index[i] = static_cast<std::uint32_t>(numerator / outRate + FRAMES_BEFORE);
+			frac[i] = static_cast<float>(numerator % outRate) / static_cast<float>(outRate);
+		}
+		resampler.process(&stereo[done * 2], padded.data(), index, frac, count);
+		done += count;
+	}
+	if (channels == 2) {
+		return stereo;
+	}
+	std::vector<float> mono(outFrames);
+	for (std::size_t i = 0; i < outFrames; ++i) {
+		mono[i] = stereo[i * 2];
+	}
+	return mono;
+}
+
+} // namespace jngl::audio
@@ -0,0 +1,58 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jngl::audio {
+
+/// Windowed-sinc polyphase resampler
+///
+/// The filter bank is computed once in the constructor, after that interpolating is just an inner
+/// product per output frame which is done in blocks by kernel_table::fir_stereo.
+class Resampler {
+public:
+	/// Length of the filter in input frames
+	constexpr static int TAPS = 16;
+
+	/// An output frame at position index + frac needs this many input frames before index ...
+	constexpr static int FRAMES_BEFORE = TAPS / 2 - 1;
+
+	/// ... and this many after it (including index + 1)
+	constexpr static int FRAMES_AFTER = TAPS / 2;
+
+	/// Number of fractional positions between two input frames which have their own filter
+	constexpr static int PHASES = 256;
+
+	/// \a cutoff is relative to the Nyquist frequency of the input, should be the ratio of output
+	/// to input sample rate when downsampling to avoid aliasing and 1 otherwise.
+	explicit Resampler(float cutoff = 1.f);
+
+	/// Returns one of the filter banks for the cutoffs 1/8, 2/8, ..., 1, namely the largest one
+	/// which isn't above \a cutoff (but at least 1/8), so that it's safe against aliasing
+	///
+	/// The banks are computed on the first call and shared, so that changing the cutoff while
+	/// playing neither allocates nor recomputes coefficients.
+	static const Resampler& forCutoff(float cutoff);
+
+	/// Interpolates \a frame_count stereo frames: dst[i] = src at position index[i] + frac[i]
+	///
+	/// frac has to be in [0, 1]. src must contain FRAMES_BEFORE frames before and FRAMES_AFTER
+	/// frames after each index.
+	void process(float* dst, const float* src, const std::uint32_t* index, const float* frac,
+	             std::size_t frame_count) const;
+
+	/// Converts a whole interleaved mono or stereo buffer from \a inRate to \a outRate
+	static std::vector<float> convert(const std::vector<float>& input, int channels, long inRate,
+	                                  long outRate);
+
+private:
+	const float* coefficients(float frac) const;
+
+	/// (PHASES + 1) * TAPS * 2 coefficients, each one twice for interleaved stereo
+	std::vector<float> bank;
+};
+
+} // namespace jngl::audio
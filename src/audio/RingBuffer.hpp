@@ -0,0 +1,85 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+namespace jngl::audio {
+
+/// Wait-free single-producer/single-consumer ring buffer with a fixed capacity
+///
+/// One thread may call write(), another one read() and discardUntil(). Neither will block or
+/// allocate memory.
+template <class T> class RingBuffer {
+public:
+	/// \a capacity will be rounded up to the next power of two
+	explicit RingBuffer(std::size_t capacity) {
+		while (capacity_ < capacity) {
+			capacity_ *= 2;
+		}
+		data = std::make_unique<T[]>(capacity_); // NOLINT
+	}
+
+	std::size_t capacity() const {
+		return capacity_;
+	}
+
+	/// Number of elements which can be read right now
+	std::size_t size() const {
+		return static_cast<std::size_t>(writeIndex.load(std::memory_order_acquire) -
+		                                readIndex.load(std::memory_order_acquire));
+	}
+
+	/// Producer only: Appends up to \a count elements and returns how many were written
+	std::size_t write(const T* source, std::size_t count) {
+		const auto w = writeIndex.load(std::memory_order_relaxed);
+		const auto r = readIndex.load(std::memory_order_acquire);
+		count = std::min(count, capacity_ - static_cast<std::size_t>(w - r));
+		const auto offset = static_cast<std::size_t>(w) & (capacity_ - 1);
+		const auto first = std::min(count, capacity_ - offset);
+		std::copy(source, source + first, data.get() + offset);
+		std::copy(source + first, source + count, data.get());
+		writeIndex.store(w + count, std::memory_order_release);
+		return count;
+	}
+
+	/// Consumer only: Removes up to \a count elements and returns how many were read
+	std::size_t read(T* destination, std::size_t count) {
+		const auto r = readIndex.load(std::memory_order_relaxed);
+		const auto w = writeIndex.load(std::memory_order_acquire);
+		count = std::min(count, static_cast<std::size_t>(w - r));
+		const auto offset = static_cast<std::size_t>(r) & (capacity_ - 1);
+		const auto first = std::min(count, capacity_ - offset);
+		std::copy(data.get() + offset, data.get() + offset + first, destination);
+		std::copy(data.get(), data.get() + (count - first), destination + first);
+		readIndex.store(r + count, std::memory_order_release);
+		return count;
+	}
+
+	/// Producer only: Total number of elements ever written, can be passed to discardUntil
+	std::uint64_t written() const {
+		return writeIndex.load(std::memory_order_relaxed);
+	}
+
+	/// Consumer only: Drops everything that has been written before written() returned \a index
+	void discardUntil(std::uint64_t index) {
+		if (index > readIndex.load(std::memory_order_relaxed)) {
+			assert(index <= writeIndex.load(std::memory_order_acquire));
+			readIndex.store(index, std::memory_order_release);
+		}
+	}
+
+private:
+	std::size_t capacity_ = 1;
+	std::unique_ptr<T[]> data; // NOLINT
+
+	// Both only ever increase, the position inside the buffer is index & (capacity_ - 1)
+	alignas(64) std::atomic<std::uint64_t> writeIndex{ 0 };
+	alignas(64) std::atomic<std::uint64_t> readIndex{ 0 };
+};
+
+} // namespace jngl::audio
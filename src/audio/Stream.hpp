@@ -4,7 +4,9 @@
 // https://lisyarus.github.io/blog/programming/2022/10/15/audio-mixing.html
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <iterator>
 
 namespace jngl {
 
@@ -16,6 +18,32 @@ struct Stream {
 	virtual void rewind() = 0;
 	virtual bool isPlaying() const = 0;
 
+	/// Advances like read() without returning any samples, used for virtual voices
+	///
+	/// The default implementation has to read and discard the samples, override it when this can
+	/// be done cheaper.
+	virtual std::size_t skip(std::size_t sample_count) {
+		float discard[512];
+		std::size_t result = 0;
+		while (result < sample_count) {
+			const auto count = std::min(sample_count - result, std::size(discard));
+			const auto read = this->read(discard, count);
+			result += read;
+			if (read < count) {
+				break;
+			}
+		}
+		return result;
+	}
+
+	/// Rough estimate of how loud this Stream is in [0, ∞], e.g. the gain of a volume_control
+	///
+	/// Streams which aren't audible (or have a low priority) might only be skipped instead of
+	/// mixed. Must be called from mixing thread.
+	virtual float audibility() const {
+		return 1.f;
+	}
+
 	virtual ~Stream() = default;
 };
 
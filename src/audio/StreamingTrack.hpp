@@ -0,0 +1,75 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#pragma once
+
+#include "RingBuffer.hpp"
+#include "Track.hpp"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace jngl {
+
+/// Plays an OGG file without decoding it into memory first
+///
+/// A decoder thread keeps the OggVorbis_File open and stays a fraction of a second ahead of
+/// playback. The samples are passed to the mixer thread through a lock-free ring buffer. Output is
+/// interleaved stereo at the sample rate of the file, so it has to be resampled if that doesn't
+/// match audio::frequency.
+class StreamingTrack : public Track {
+public:
+	/// \throws std::runtime_error if \a filename can't be opened
+	explicit StreamingTrack(const std::string& filename);
+	~StreamingTrack() override;
+	StreamingTrack(const StreamingTrack&) = delete;
+	StreamingTrack& operator=(const StreamingTrack&) = delete;
+	StreamingTrack(StreamingTrack&&) = delete;
+	StreamingTrack& operator=(StreamingTrack&&) = delete;
+
+	/// Restart at the beginning without a gap once the end of the file has been reached
+	void setLooping(bool);
+
+	/// Sample rate of the file
+	long getRate() const;
+
+	float progress() const override;
+	void seek(std::size_t sample) override;
+
+	size_t read(float* data, std::size_t sample_count) override;
+	void rewind() override;
+	bool isPlaying() const override;
+
+private:
+	void decode();
+
+	struct Decoder;
+	std::unique_ptr<Decoder> decoder;
+
+	audio::RingBuffer<float> ring;
+
+	std::atomic<bool> looping{ false };
+	std::atomic<bool> quit{ false };
+	std::atomic<bool> finished{ false }; //< decoder reached the end and won't write anymore
+	std::atomic<bool> ended{ false };    //< mixer thread has played the last sample
+
+	static constexpr std::int64_t NO_SEEK = -1;
+	std::atomic<std::int64_t> seekRequest{ NO_SEEK }; //< in stereo frames
+
+	// published by the decoder thread after a seek, so that the mixer thread can drop stale data
+	std::atomic<std::uint64_t> seekEpoch{ 0 };
+	std::atomic<std::uint64_t> seekDiscardUntil{ 0 };
+	std::atomic<std::size_t> seekPlayed{ 0 };
+	std::uint64_t seenSeekEpoch = 0; //< only used on mixer thread
+
+	std::atomic<std::size_t> played_{ 0 };
+	std::size_t totalSamples;
+
+	std::mutex mutex;
+	std::condition_variable wakeUp;
+	std::thread thread;
+};
+
+} // namespace jngl
@@ -0,0 +1,135 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "SubmixWorkers.hpp"
+
+#include "Stream.hpp"
+
+#include <cassert>
+#include <chrono>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace jngl::audio {
+
+namespace {
+
+void relax() {
+#if defined(__SSE2__) || defined(_M_X64)
+	_mm_pause();
+#endif
+}
+
+/// How long a worker checks for new jobs before going to sleep. A block is about 5 ms and workers
+/// may run with SCHED_FIFO, so this has to stay well below that to not starve other threads.
+constexpr auto SPIN_DURATION = std::chrono::microseconds(200);
+
+/// Reading the clock is more expensive than a pause, so only do it every few spins
+constexpr int SPINS_PER_CLOCK_CHECK = 64;
+
+void makeRealtime(std::thread& thread) {
+#if defined(_WIN32)
+	SetThreadPriority(thread.native_handle(), THREAD_PRIORITY_TIME_CRITICAL);
+#elif !defined(__EMSCRIPTEN__)
+	sched_param param{};
+	param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+	// usually fails without the right privileges, we simply keep the normal priority then
+	pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param);
+#else
+	(void)thread;
+#endif
+}
+
+} // namespace
+
+SubmixWorkers::SubmixWorkers(unsigned count) {
+	threads.reserve(count);
+	for (unsigned i = 0; i < count; ++i) {
+		threads.emplace_back([this]() { work(); });
+		makeRealtime(threads.back());
+	}
+}
+
+SubmixWorkers::~SubmixWorkers() {
+	quit = true;
+	generation.fetch_add(1);
+	generation.notify_all();
+	for (auto& thread : threads) {
+		thread.join();
+	}
+}
+
+void SubmixWorkers::run(Job* jobs, std::size_t count) {
+	assert(count <= MAX_JOBS);
+	const std::uint32_t block = generation.load(std::memory_order_relaxed) + 1;
+	this->jobs = jobs;
+	finishedJobs.store(0, std::memory_order_relaxed);
+	nextJob.store(static_cast<std::uint64_t>(block) << 32 | count << 16, std::memory_order_release);
+	generation.store(block, std::memory_order_release);
+	if (sleeping.load() > 0) {
+		generation.notify_all(); // no lock, at worst a syscall
+	}
+
+	std::size_t finished = takeJobs(block);
+	if (finished > 0) {
+		finishedJobs.fetch_add(finished, std::memory_order_acq_rel);
+	}
+	while (finishedJobs.load(std::memory_order_acquire) < count) { // barrier
+		relax();
+	}
+}
+
+std::size_t SubmixWorkers::takeJobs(std::uint32_t block) {
+	std::size_t finished = 0;
+	auto value = nextJob.load(std::memory_order_acquire);
+	while (true) {
+		const auto index = value & 0xffff;
+		if (value >> 32 != block || index >= (value >> 16 & 0xffff)) {
+			return finished;
+		}
+		if (!nextJob.compare_exchange_weak(value, value + 1, std::memory_order_acq_rel)) {
+			continue; // another thread took it, value has been updated
+		}
+		// run() can't return and overwrite the jobs before we've increased finishedJobs
+		auto& job = jobs[index];
+		job.result = job.stream->read(job.buffer, job.sampleCount);
+		++finished;
+		value = nextJob.load(std::memory_order_acquire);
+	}
+}
+
+void SubmixWorkers::work() {
+	auto seen = generation.load(std::memory_order_acquire);
+	while (true) {
+		int spins = 0;
+		const auto spinUntil = std::chrono::steady_clock::now() + SPIN_DURATION;
+		std::uint32_t current; // NOLINT
+		while ((current = generation.load(std::memory_order_acquire)) == seen) {
+			if (++spins % SPINS_PER_CLOCK_CHECK != 0 ||
+			    std::chrono::steady_clock::now() < spinUntil) {
+				relax();
+				continue;
+			}
+			++sleeping;
+			generation.wait(seen, std::memory_order_acquire);
+			--sleeping;
+		}
+		seen = current;
+		if (quit) {
+			return;
+		}
+		if (const auto finished = takeJobs(current); finished > 0) {
+			finishedJobs.fetch_add(finished, std::memory_order_acq_rel);
+		}
+	}
+}
+
+} // namespace jngl::audio
@@ -0,0 +1,68 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace jngl {
+struct Stream;
+
+namespace audio {
+
+/// Fixed set of threads which read Streams in parallel for the Mixer
+///
+/// The mixer thread and the workers take jobs from a shared counter and wait for each other with a
+/// spin barrier after every block. Workers which didn't get anything to do for a while go to sleep
+/// using std::atomic::wait, so that they don't burn a core when nothing is playing. Neither run()
+/// nor the workers allocate or lock.
+class SubmixWorkers {
+public:
+	struct Job {
+		Stream* stream;
+		float* buffer;
+		std::size_t sampleCount;
+		std::size_t result; //< return value of Stream::read
+	};
+
+	constexpr static std::size_t MAX_JOBS = 0xffff;
+
+	/// Starts \a count threads with realtime priority (if the OS allows it)
+	explicit SubmixWorkers(unsigned count);
+	~SubmixWorkers();
+	SubmixWorkers(const SubmixWorkers&) = delete;
+	SubmixWorkers& operator=(const SubmixWorkers&) = delete;
+	SubmixWorkers(SubmixWorkers&&) = delete;
+	SubmixWorkers& operator=(SubmixWorkers&&) = delete;
+
+	/// Runs all jobs, the calling thread helps out. Returns once every job has been finished.
+	///
+	/// Only ever call this from one thread at a time.
+	void run(Job* jobs, std::size_t count);
+
+private:
+	void work();
+
+	/// Takes jobs of \a block until there are none left, returns how many have been done
+	std::size_t takeJobs(std::uint32_t block);
+
+	std::vector<std::thread> threads;
+
+	alignas(64) std::atomic<std::uint32_t> generation{ 0 }; //< incremented for every block
+
+	/// generation << 32 | job count << 16 | index of the next job. Having all of them in one atomic
+	/// makes sure that a worker which is late can't take jobs of the next block.
+	alignas(64) std::atomic<std::uint64_t> nextJob{ 0 };
+
+	alignas(64) std::atomic<std::size_t> finishedJobs{ 0 };
+	std::atomic<unsigned> sleeping{ 0 };
+	std::atomic<bool> quit{ false };
+
+	Job* jobs = nullptr;
+};
+
+} // namespace audio
+} // namespace jngl
@@ -5,24 +5,60 @@
 #include "Stream.hpp"
 
 #include <atomic>
-#include <gsl/span>
+#include <cstdint>
+#include <vector>
 
 namespace jngl {
 
-class PlayingTrack : public Stream {
+/// Decoded samples of a SoundFile at audio::frequency
+///
+/// Stored as 16 bit integers in the channel count of the file, i.e. a mono sound effect only needs
+/// a quarter of the memory compared to interleaved float stereo.
+struct PcmBuffer {
+	/// Value of a full-scale sample, used to convert from and to floats in [-1, 1]
+	constexpr static float FULL_SCALE = 32767.f;
+
+	std::vector<std::int16_t> samples; //< interleaved if channels == 2
+	int channels = 2;                  //< 1 or 2
+
+	/// number of samples per channel
+	std::size_t frames() const {
+		return samples.size() / static_cast<std::size_t>(channels);
+	}
+};
+
+/// Stream which plays a SoundFile from the start to the end
+class Track : public Stream {
+public:
+	/// percentage of samples that have been returned by read, resets to 0 after calling rewind()
+	virtual float progress() const = 0;
+
+	/// Continue playback at \a sample (interleaved, i.e. counted like the size passed to read)
+	///
+	/// Can be called from the main thread.
+	virtual void seek(std::size_t sample) = 0;
+};
+
+/// Plays a PcmBuffer, expanding it to float stereo on the fly
+class PlayingTrack : public Track {
 public:
 	/// doesn't copy the samples, so they must outlive this object
-	explicit PlayingTrack(gsl::span<const float> samples);
+	explicit PlayingTrack(const PcmBuffer&);
 
-	/// percentage of samples that have been returned by read, resets to 0 after calling rewind()
-	float progress() const;
+	/// Start over with other samples, must not be called while a Mixer reads from this
+	void reset(const PcmBuffer&);
+
+	float progress() const override;
+	void seek(std::size_t sample) override;
 
 private:
 	size_t read(float* data, std::size_t sample_count) override;
+	size_t skip(std::size_t sample_count) override;
 	void rewind() override;
 	bool isPlaying() const override;
 
-	gsl::span<const float> samples;
+	const PcmBuffer* pcm;
+	std::size_t size; //< in interleaved stereo samples
 	std::atomic<std::size_t> played_{ 0 };
 };
 
@@ -1,6 +1,7 @@
 // Copyright 2023-2024 Jan Niklas Hasse <jhasse@bixense.com>
 // For conditions of distribution and use, see copyright notice in LICENSE.txt
 #include "../engine.hpp"
+#include "../CallbackStatistics.hpp"
 #include "../constants.hpp"
 #include "../Stream.hpp"
 #include "../../jngl/debug.hpp"
@@ -8,6 +9,7 @@
 #include <oboe/Oboe.h>
 
 #include <cassert>
+#include <chrono>
 #include <mutex>
 #include <atomic>
 #include <vector>
@@ -17,6 +19,7 @@ namespace jngl::audio {
 
 struct engine::Impl {
 	std::shared_ptr<Stream> output;
+	CallbackStatistics statistics;
 
 	Impl(std::shared_ptr<Stream> output);
 
@@ -44,10 +47,13 @@ struct engine::Impl {
 		}
 
 	private:
-		oboe::DataCallbackResult onAudioReady(oboe::AudioStream*, void* data,
+		oboe::DataCallbackResult onAudioReady(oboe::AudioStream* stream, void* data,
 		                                      int32_t len) override {
+			const auto start = std::chrono::steady_clock::now();
 			float* dst = reinterpret_cast<float*>(data);
 			self.output->read(dst, len * 2);
+			self.statistics.record(std::chrono::steady_clock::now() - start, len,
+			                       stream->getSampleRate());
 			return oboe::DataCallbackResult::Continue;
 		}
 
@@ -80,7 +86,8 @@ engine::Impl::Impl(std::shared_ptr<Stream> output) : output(std::move(output)),
 	start();
 }
 
-engine::engine(std::shared_ptr<Stream> output) : impl(std::make_unique<Impl>(std::move(output))) {
+engine::engine(std::shared_ptr<Stream> output, const AudioDeviceParameters&)
+: impl(std::make_unique<Impl>(std::move(output))) {
 }
 
 engine::~engine() {
@@ -98,4 +105,15 @@ void engine::setPause(bool pause) {
 void engine::step() {
 }
 
+void engine::setParameters(const AudioDeviceParameters&) {
+}
+
+const CallbackStatistics& engine::statistics() const {
+	return impl->statistics;
+}
+
+OfflineRenderer* engine::offlineRenderer() {
+	return nullptr;
+}
+
 } // namespace jngl::audio
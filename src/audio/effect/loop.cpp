@@ -29,6 +29,23 @@ struct loop_impl : Stream {
 		return result;
 	}
 
+	std::size_t skip(std::size_t sample_count) override {
+		std::size_t result = 0;
+		while (result < sample_count && (!count_ || repeated_ < *count_)) {
+			auto count = stream_->skip(sample_count - result);
+			result += count;
+			if (count == 0) {
+				++repeated_;
+				stream_->rewind();
+			}
+		}
+		return result;
+	}
+
+	float audibility() const override {
+		return stream_->audibility();
+	}
+
 	void rewind() override {
 		repeated_ = 0;
 	}
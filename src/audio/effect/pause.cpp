@@ -58,6 +58,23 @@ struct pause_control_impl : pause_control {
 		return result;
 	}
 
+	std::size_t skip(std::size_t sample_count) override {
+		if (paused_.load()) {
+			level_ -= stream_->skip(std::min(sample_count, level_));
+			return sample_count;
+		}
+		auto result = stream_->skip(sample_count);
+		level_ = std::min(level_ + result, static_cast<std::size_t>(length_.samples()));
+		return result;
+	}
+
+	float audibility() const override {
+		if (level_ == 0) {
+			return 0.f; // completely faded out
+		}
+		return stream_->audibility();
+	}
+
 	void rewind() override {
 		stream_->rewind();
 	}
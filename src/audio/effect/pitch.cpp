@@ -4,17 +4,12 @@
 // https://lisyarus.github.io/blog/programming/2022/10/15/audio-mixing.html
 #include "pitch.hpp"
 
+#include "../Resampler.hpp"
+
+#include <algorithm>
 #include <atomic>
 #include <cassert>
-#include <cmath>
-
-#if __cplusplus < 202002L
-float lerp(float a, float b, float t) {
-	return a + t * (b - a);
-}
-#else
-using std::lerp;
-#endif
+#include <cstdint>
 
 namespace jngl::audio {
 
@@ -22,7 +17,8 @@ namespace {
 
 struct pitch_control_impl : pitch_control {
 	pitch_control_impl(std::shared_ptr<Stream> stream, float ratio)
-	: stream_(std::move(stream)), ratio(1.f / ratio) {
+	: stream_(std::move(stream)), resampler(&Resampler::forCutoff(std::min(1.f, 1.f / ratio))),
+	  ratio(1.f / ratio) {
 	}
 
 	// N.B. resampler ratio is in terms of sampling frequency, while
@@ -34,67 +30,139 @@ struct pitch_control_impl : pitch_control {
 	}
 
 	float pitch(float ratio) override {
+		// a higher pitch needs a lower cutoff, otherwise it would alias
+		resampler = &Resampler::forCutoff(std::min(1.f, 1.f / ratio));
 		return this->ratio = 1.f / ratio;
 	}
 
 	std::size_t read(float* data, std::size_t sample_count) override {
+		return process(data, sample_count);
+	}
+
+	/// Still has to pull from the source, but doesn't interpolate
+	std::size_t skip(std::size_t sample_count) override {
+		return process(nullptr, sample_count);
+	}
+
+	float audibility() const override {
+		return stream_->audibility();
+	}
+
+	void rewind() override {
+		stream_->rewind();
+		sourceFrames = 0;
+		endOfStream = false;
+	}
+
+	bool isPlaying() const override {
+		return stream_->isPlaying();
+	}
+
+private:
+	/// Skips the interpolation if \a data is nullptr
+	std::size_t process(float* data, std::size_t sample_count) {
 		assert(sample_count % 2 == 0);
 		std::size_t result = 0;
 
-		if (sourceBufferSize == 0) {
-			sourceBufferSize = stream_->read(sourceBuffer, MAX_SOURCE_BUFFER_SIZE);
-			if (sourceBufferSize == 0) { return 0; }
-			assert(sourceBufferSize % 2 == 0);
+		if (sourceFrames == 0) {
+			// silence before the first frame, so that the filter has something to look back at
+			std::fill(sourceBuffer, sourceBuffer + 2 * Resampler::FRAMES_BEFORE, 0.f);
+			sourceFrames = position = Resampler::FRAMES_BEFORE;
+			positionFrac = 0;
+			if (!refill()) {
+				return 0;
+			}
 		}
 
 		while (result < sample_count) {
-			// assert(2 * (position + 1) <= sourceBufferSize);
-			if (2 * (position + 1) >= sourceBufferSize) {
-				static_assert(MAX_SOURCE_BUFFER_SIZE % 2 == 0);
-				sourceBuffer[0] = sourceBuffer[sourceBufferSize - 2];
-				sourceBuffer[1] = sourceBuffer[sourceBufferSize - 1];
-				position = 0;
-				sourceBufferSize = stream_->read(sourceBuffer + 2, MAX_SOURCE_BUFFER_SIZE - 2) + 2;
-				if (sourceBufferSize == 2) {
+			if (position + Resampler::FRAMES_AFTER >= sourceFrames) {
+				if (endOfStream) {
 					break;
 				}
-				assert(sourceBufferSize % 2 == 0);
+				// only keep the frames the filter still needs
+				const auto keep = std::min(position - Resampler::FRAMES_BEFORE, sourceFrames);
+				std::copy(sourceBuffer + 2 * keep, sourceBuffer + 2 * sourceFrames, sourceBuffer);
+				sourceFrames -= keep;
+				position -= keep;
+				refill();
+				continue;
 			}
-			data[result] =
-			    lerp(sourceBuffer[2 * position], sourceBuffer[2 * (position + 1)], positionFrac);
-			++result;
-			data[result] = lerp(sourceBuffer[2 * position + 1],
-			                    sourceBuffer[2 * (position + 1) + 1], positionFrac);
-			++result;
-
-			positionFrac += 1.f / ratio;
-			while (positionFrac > 1.f) {
-				++position;
-				positionFrac -= 1.f;
+
+			if (ratio == 1.f) {
+				// The filter isn't transparent, so pass the source through unchanged like
+				// Resampler::convert does. After other pitches the position has to be snapped to
+				// the nearest frame first, otherwise the fraction would never become 0 again. That
+				// shifts the sound by less than half a frame, switching back is seamless.
+				if (positionFrac >= 0.5f) {
+					++position;
+				}
+				positionFrac = 0.f;
+				const auto frames = std::min((sample_count - result) / 2,
+				                             sourceFrames - Resampler::FRAMES_AFTER - position);
+				if (data) {
+					std::copy_n(sourceBuffer + 2 * position, 2 * frames, data + result);
+				}
+				position += frames;
+				result += 2 * frames;
+				continue;
 			}
+
+			// Advancing the position is inherently serial, so we first collect which frames to
+			// interpolate and then let the resampler do the actual work for the whole block.
+			size_t frames = 0;
+			while (frames < MAX_BLOCK_FRAMES && result + 2 * frames < sample_count &&
+			       position + Resampler::FRAMES_AFTER < sourceFrames) {
+				blockIndex[frames] = static_cast<std::uint32_t>(position);
+				blockFrac[frames] = positionFrac;
+				++frames;
+
+				positionFrac += 1.f / ratio;
+				while (positionFrac > 1.f) {
+					++position;
+					positionFrac -= 1.f;
+				}
+			}
+			if (data) {
+				resampler.load()->process(data + result, sourceBuffer, blockIndex, blockFrac,
+				                          frames);
+			}
+			result += 2 * frames;
 		}
 		played_ += result;
 		return result;
 	}
 
-	void rewind() override {
-		stream_->rewind();
-		position = 0;
-		sourceBufferSize = 0;
-	}
-
-	bool isPlaying() const override {
-		return stream_->isPlaying();
+	/// Appends to sourceBuffer, returns false if the stream ended
+	bool refill() {
+		// leave room to append silence, so that the end of the stream passes through the filter
+		const auto space = MAX_SOURCE_BUFFER_SIZE - 2 * (sourceFrames + Resampler::FRAMES_AFTER);
+		const auto read = stream_->read(sourceBuffer + 2 * sourceFrames, space);
+		assert(read % 2 == 0);
+		sourceFrames += read / 2;
+		if (read < space) {
+			endOfStream = true;
+			std::fill(sourceBuffer + 2 * sourceFrames,
+			          sourceBuffer + 2 * (sourceFrames + Resampler::FRAMES_AFTER), 0.f);
+			sourceFrames += Resampler::FRAMES_AFTER;
+		}
+		return read > 0;
 	}
 
-private:
 	std::shared_ptr<Stream> stream_;
 
+	/// Set by pitch(float) while the mixer thread reads it, see Resampler::forCutoff
+	std::atomic<const Resampler*> resampler;
+
 	constexpr static size_t MAX_SOURCE_BUFFER_SIZE = 996;
-	size_t position = 0;
-	size_t sourceBufferSize = 0;
+	size_t position = 0;     //< frame in sourceBuffer
+	size_t sourceFrames = 0; //< number of valid frames in sourceBuffer
+	bool endOfStream = false;
 	float sourceBuffer[MAX_SOURCE_BUFFER_SIZE] = { 0 };
 
+	constexpr static size_t MAX_BLOCK_FRAMES = 256;
+	std::uint32_t blockIndex[MAX_BLOCK_FRAMES] = { 0 };
+	float blockFrac[MAX_BLOCK_FRAMES] = { 0 };
+
 	float positionFrac = 0; //< 0 = left sample, 1 = right sample
 
 	float ratio; // 1. / ratio
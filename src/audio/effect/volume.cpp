@@ -43,6 +43,15 @@ struct volume_control_impl : volume_control {
 		return result;
 	}
 
+	std::size_t skip(std::size_t sample_count) override {
+		base_.skip();
+		return stream_->skip(sample_count);
+	}
+
+	float audibility() const override {
+		return base_.audibility() * stream_->audibility();
+	}
+
 private:
 	volume_base base_;
 	std::shared_ptr<Stream> stream_;
@@ -88,6 +97,15 @@ struct volume_control_stereo_impl : volume_control_stereo {
 		return result;
 	}
 
+	std::size_t skip(std::size_t sample_count) override {
+		base_.skip();
+		return stream_->skip(sample_count);
+	}
+
+	float audibility() const override {
+		return base_.audibility() * stream_->audibility();
+	}
+
 private:
 	volume_base base_;
 	std::shared_ptr<Stream> stream_;
@@ -4,8 +4,10 @@
 // https://lisyarus.github.io/blog/programming/2022/10/15/audio-mixing.html
 #include "volume_base.hpp"
 #include "../constants.hpp"
+#include "../kernels.hpp"
 #include "../smooth.hpp"
 
+#include <algorithm>
 #include <cmath>
 
 namespace jngl::audio {
@@ -29,13 +31,26 @@ void volume_base::apply(float* data, std::size_t sample_count) {
 	float smoothness_multiplier = smoothness_multiplier_.load();
 
 	auto end = data + sample_count;
-	for (auto p = data; p < end;) {
+	auto p = data;
+	// Once the smoothed gain has reached its target smooth_update doesn't change it anymore, so the
+	// rest can be done with a constant gain:
+	while (p < end && (real_gain_[0] != gain[0] || real_gain_[1] != gain[1])) {
 		*p++ *= real_gain_[0];
 		*p++ *= real_gain_[1];
 
 		smooth_update(real_gain_[0], gain[0], smoothness_multiplier);
 		smooth_update(real_gain_[1], gain[1], smoothness_multiplier);
 	}
+	kernels().gain_stereo(p, static_cast<std::size_t>(end - p), real_gain_[0], real_gain_[1]);
+}
+
+void volume_base::skip() {
+	real_gain_[0] = gain_[0].load();
+	real_gain_[1] = gain_[1].load();
+}
+
+float volume_base::audibility() const {
+	return std::max(std::abs(gain_[0].load()), std::abs(gain_[1].load()));
 }
 
 } // namespace jngl::audio
@@ -32,6 +32,12 @@ struct volume_base {
 
 	void apply(float* data, std::size_t sample_count);
 
+	/// Called instead of apply() for virtual voices, jumps to the target gain
+	void skip();
+
+	/// Larger one of the two target gains
+	float audibility() const;
+
 private:
 	std::atomic<float> gain_[2]; // NOLINT: workaround for clang-tidy bug???
 	std::atomic<float> smoothness_multiplier_;
@@ -7,17 +7,31 @@
 #include <memory>
 
 namespace jngl {
+struct AudioDeviceParameters;
 struct Stream;
 
 namespace audio {
+class CallbackStatistics;
+class OfflineRenderer;
 
 struct engine {
-	explicit engine(std::shared_ptr<Stream> output);
+	/// Setting the environment variable JNGL_AUDIO_BACKEND=offline selects a backend which doesn't
+	/// output anything on its own, see offlineRenderer()
+	engine(std::shared_ptr<Stream> output, const AudioDeviceParameters&);
 	~engine();
 
 	void setPause(bool);
 	void step();
 
+	/// Reopens the device, not supported by every backend
+	void setParameters(const AudioDeviceParameters&);
+
+	/// Recorded by the audio thread, can be read from any thread
+	const CallbackStatistics& statistics() const;
+
+	/// Only set when the offline backend is used, renders \a output faster than realtime
+	OfflineRenderer* offlineRenderer();
+
 private:
 	struct Impl;
 	std::unique_ptr<Impl> impl;
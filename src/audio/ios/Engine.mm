@@ -2,11 +2,13 @@
 // For conditions of distribution and use, see copyright notice in LICENSE.txt
 #include "../engine.hpp"
 
+#include "../CallbackStatistics.hpp"
 #include "../constants.hpp"
 #include "../Stream.hpp"
 
 #include <AudioUnit/AudioUnit.h>
 #include <cassert>
+#include <chrono>
 #include <string>
 
 namespace jngl::audio {
@@ -78,19 +80,25 @@ struct engine::Impl {
 	static OSStatus callback(void* refCon, AudioUnitRenderActionFlags* ioActionFlags,
 	                         const AudioTimeStamp* inTimeStamp, UInt32 inBusNumber,
 	                         UInt32 inNumberFrames, AudioBufferList* ioData) noexcept {
+		const auto start = std::chrono::steady_clock::now();
+		auto self = static_cast<Impl*>(refCon);
 		for (size_t i = 0; i < ioData->mNumberBuffers; ++i) {
 			auto& buffer = ioData->mBuffers[i];
-			static_cast<Impl*>(refCon)->output->read(static_cast<float*>(buffer.mData),
-			                                         buffer.mDataByteSize / sizeof(float));
+			self->output->read(static_cast<float*>(buffer.mData),
+			                   buffer.mDataByteSize / sizeof(float));
 		}
+		self->statistics.record(std::chrono::steady_clock::now() - start, inNumberFrames,
+		                        frequency);
 		return noErr;
 	}
 
 	std::shared_ptr<Stream> output;
+	CallbackStatistics statistics;
 	AudioUnit audioUnit;
 };
 
-engine::engine(std::shared_ptr<Stream> output) : impl(std::make_unique<Impl>(std::move(output))) {
+engine::engine(std::shared_ptr<Stream> output, const AudioDeviceParameters&)
+: impl(std::make_unique<Impl>(std::move(output))) {
 	setPause(false);
 }
 
@@ -105,4 +113,15 @@ void engine::setPause(bool pause) {
 void engine::step() {
 }
 
+void engine::setParameters(const AudioDeviceParameters&) {
+}
+
+const CallbackStatistics& engine::statistics() const {
+	return impl->statistics;
+}
+
+OfflineRenderer* engine::offlineRenderer() {
+	return nullptr;
+}
+
 } // namespace jngl::audio
@@ -0,0 +1,316 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "kernels.hpp"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JNGL_AUDIO_SSE2
+#include <emmintrin.h>
+#if !defined(__EMSCRIPTEN__)
+#define JNGL_AUDIO_AVX2
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define JNGL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#include <intrin.h>
+#define JNGL_TARGET_AVX2
+#endif
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(_M_ARM64)
+#define JNGL_AUDIO_NEON
+#include <arm_neon.h>
+#endif
+
+namespace jngl::audio {
+
+namespace {
+
+// Scalar fallbacks. These define the exact results all other implementations have to match.
+// Note that this file is compiled with -ffp-contract=off, so that e.g. a + t * (b - a) doesn't get
+// fused differently depending on the instruction set.
+
+void mix_add_scalar(float* dst, const float* src, std::size_t sample_count) {
+	for (std::size_t i = 0; i < sample_count; ++i) {
+		dst[i] += src[i];
+	}
+}
+
+void gain_stereo_scalar(float* data, std::size_t sample_count, float left, float right) {
+	for (std::size_t i = 0; i + 1 < sample_count; i += 2) {
+		data[i] *= left;
+		data[i + 1] *= right;
+	}
+}
+
+void lerp_stereo_scalar(float* dst, const float* src, const std::uint32_t* index,
+                        const float* frac, std::size_t frame_count) {
+	for (std::size_t i = 0; i < frame_count; ++i) {
+		const float* a = src + 2 * static_cast<std::size_t>(index[i]);
+		dst[2 * i] = a[0] + frac[i] * (a[2] - a[0]);
+		dst[2 * i + 1] = a[1] + frac[i] * (a[3] - a[1]);
+	}
+}
+
+// Accumulates in four lanes like the SIMD versions, so that the order of additions is the same
+void fir_stereo_scalar(float* dst, const float* src, const std::uint32_t* index,
+                       const float* const* coefficients, std::size_t frame_count,
+                       std::size_t taps) {
+	for (std::size_t i = 0; i < frame_count; ++i) {
+		const float* s = src + 2 * static_cast<std::size_t>(index[i]);
+		const float* h = coefficients[i];
+		float acc[4] = { 0, 0, 0, 0 };
+		for (std::size_t j = 0; j < 2 * taps; j += 4) {
+			for (std::size_t lane = 0; lane < 4; ++lane) {
+				acc[lane] += s[j + lane] * h[j + lane];
+			}
+		}
+		dst[2 * i] = acc[0] + acc[2];
+		dst[2 * i + 1] = acc[1] + acc[3];
+	}
+}
+
+void to_s16_scalar(std::int16_t* dst, const float* src, std::size_t sample_count) {
+	for (std::size_t i = 0; i < sample_count; ++i) {
+		dst[i] = static_cast<std::int16_t>(
+		    std::max(std::min((65535.f * src[i] - 1.f) / 2.f, 32767.f), -32768.f));
+	}
+}
+
+#ifdef JNGL_AUDIO_SSE2
+void mix_add_sse2(float* dst, const float* src, std::size_t sample_count) {
+	std::size_t i = 0;
+	for (; i + 4 <= sample_count; i += 4) {
+		_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+	}
+	mix_add_scalar(dst + i, src + i, sample_count - i);
+}
+
+void gain_stereo_sse2(float* data, std::size_t sample_count, float left, float right) {
+	const __m128 gain = _mm_setr_ps(left, right, left, right);
+	std::size_t i = 0;
+	for (; i + 4 <= sample_count; i += 4) {
+		_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain));
+	}
+	gain_stereo_scalar(data + i, sample_count - i, left, right);
+}
+
+void lerp_stereo_sse2(float* dst, const float* src, const std::uint32_t* index, const float* frac,
+                      std::size_t frame_count) {
+	std::size_t i = 0;
+	for (; i + 2 <= frame_count; i += 2) {
+		// [aL, aR, bL, bR] of both frames
+		const __m128 first = _mm_loadu_ps(src + 2 * static_cast<std::size_t>(index[i]));
+		const __m128 second = _mm_loadu_ps(src + 2 * static_cast<std::size_t>(index[i + 1]));
+		const __m128 a = _mm_movelh_ps(first, second);
+		const __m128 b = _mm_movehl_ps(second, first);
+		const __m128 t = _mm_setr_ps(frac[i], frac[i], frac[i + 1], frac[i + 1]);
+		_mm_storeu_ps(dst + 2 * i, _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a))));
+	}
+	lerp_stereo_scalar(dst + 2 * i, src, index + i, frac + i, frame_count - i);
+}
+
+void fir_stereo_sse2(float* dst, const float* src, const std::uint32_t* index,
+                     const float* const* coefficients, std::size_t frame_count, std::size_t taps) {
+	for (std::size_t i = 0; i < frame_count; ++i) {
+		const float* s = src + 2 * static_cast<std::size_t>(index[i]);
+		const float* h = coefficients[i];
+		__m128 acc = _mm_setzero_ps();
+		for (std::size_t j = 0; j < 2 * taps; j += 4) {
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(s + j), _mm_loadu_ps(h + j)));
+		}
+		_mm_storel_pi(reinterpret_cast<__m64*>(dst + 2 * i), // NOLINT
+		              _mm_add_ps(acc, _mm_movehl_ps(acc, acc)));
+	}
+}
+
+void to_s16_sse2(std::int16_t* dst, const float* src, std::size_t sample_count) {
+	const __m128 scale = _mm_set1_ps(65535.f);
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 upper = _mm_set1_ps(32767.f);
+	const __m128 lower = _mm_set1_ps(-32768.f);
+	auto convert = [&](const float* p) {
+		__m128 v = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(scale, _mm_loadu_ps(p)), one), half);
+		v = _mm_max_ps(_mm_min_ps(v, upper), lower);
+		return _mm_cvttps_epi32(v);
+	};
+	std::size_t i = 0;
+	for (; i + 8 <= sample_count; i += 8) {
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), // NOLINT
+		                 _mm_packs_epi32(convert(src + i), convert(src + i + 4)));
+	}
+	to_s16_scalar(dst + i, src + i, sample_count - i);
+}
+
+const kernel_table SSE2{ "SSE2", &mix_add_sse2, &gain_stereo_sse2, &lerp_stereo_sse2,
+	                     &fir_stereo_sse2, &to_s16_sse2 };
+#endif
+
+#ifdef JNGL_AUDIO_AVX2
+// Every AVX2 kernel has to end with _mm256_zeroupper(), otherwise the SSE code running afterwards
+// (e.g. sinf from libm) gets slowed down by AVX-SSE transition penalties.
+JNGL_TARGET_AVX2 void mix_add_avx2(float* dst, const float* src, std::size_t sample_count) {
+	std::size_t i = 0;
+	for (; i + 8 <= sample_count; i += 8) {
+		_mm256_storeu_ps(dst + i,
+		                 _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i)));
+	}
+	_mm256_zeroupper();
+	mix_add_sse2(dst + i, src + i, sample_count - i);
+}
+
+JNGL_TARGET_AVX2 void gain_stereo_avx2(float* data, std::size_t sample_count, float left,
+                                       float right) {
+	const __m256 gain = _mm256_setr_ps(left, right, left, right, left, right, left, right);
+	std::size_t i = 0;
+	for (; i + 8 <= sample_count; i += 8) {
+		_mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), gain));
+	}
+	_mm256_zeroupper();
+	gain_stereo_sse2(data + i, sample_count - i, left, right);
+}
+
+JNGL_TARGET_AVX2 void to_s16_avx2(std::int16_t* dst, const float* src, std::size_t sample_count) {
+	const __m256 scale = _mm256_set1_ps(65535.f);
+	const __m256 one = _mm256_set1_ps(1.f);
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256 upper = _mm256_set1_ps(32767.f);
+	const __m256 lower = _mm256_set1_ps(-32768.f);
+	std::size_t i = 0;
+	for (; i + 8 <= sample_count; i += 8) {
+		__m256 v =
+		    _mm256_mul_ps(_mm256_sub_ps(_mm256_mul_ps(scale, _mm256_loadu_ps(src + i)), one), half);
+		v = _mm256_max_ps(_mm256_min_ps(v, upper), lower);
+		const __m256i converted = _mm256_cvttps_epi32(v);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), // NOLINT
+		                 _mm_packs_epi32(_mm256_castsi256_si128(converted),
+		                                 _mm256_extracti128_si256(converted, 1)));
+	}
+	_mm256_zeroupper();
+	to_s16_sse2(dst + i, src + i, sample_count - i);
+}
+
+// Interpolation needs two unaligned loads per frame pair, so 256 bit registers don't gain
+// anything over SSE2 there. Wider FIR accumulators would change the order of additions.
+const kernel_table AVX2{ "AVX2", &mix_add_avx2, &gain_stereo_avx2, &lerp_stereo_sse2,
+	                     &fir_stereo_sse2, &to_s16_avx2 };
+
+bool cpuSupportsAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_cpu_supports("avx2");
+#else
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return false;
+	}
+	__cpuid(info, 1);
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) { // OS has to save the YMM registers
+		return false;
+	}
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+#endif
+}
+#endif
+
+#ifdef JNGL_AUDIO_NEON
+void mix_add_neon(float* dst, const float* src, std::size_t sample_count) {
+	std::size_t i = 0;
+	for (; i + 4 <= sample_count; i += 4) {
+		vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+	}
+	mix_add_scalar(dst + i, src + i, sample_count - i);
+}
+
+void gain_stereo_neon(float* data, std::size_t sample_count, float left, float right) {
+	const float pattern[4] = { left, right, left, right };
+	const float32x4_t gain = vld1q_f32(pattern);
+	std::size_t i = 0;
+	for (; i + 4 <= sample_count; i += 4) {
+		vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), gain));
+	}
+	gain_stereo_scalar(data + i, sample_count - i, left, right);
+}
+
+void lerp_stereo_neon(float* dst, const float* src, const std::uint32_t* index, const float* frac,
+                      std::size_t frame_count) {
+	std::size_t i = 0;
+	for (; i + 2 <= frame_count; i += 2) {
+		const float32x4_t first = vld1q_f32(src + 2 * static_cast<std::size_t>(index[i]));
+		const float32x4_t second = vld1q_f32(src + 2 * static_cast<std::size_t>(index[i + 1]));
+		const float32x4_t a = vcombine_f32(vget_low_f32(first), vget_low_f32(second));
+		const float32x4_t b = vcombine_f32(vget_high_f32(first), vget_high_f32(second));
+		const float32x4_t t = vcombine_f32(vdup_n_f32(frac[i]), vdup_n_f32(frac[i + 1]));
+		vst1q_f32(dst + 2 * i, vaddq_f32(a, vmulq_f32(t, vsubq_f32(b, a))));
+	}
+	lerp_stereo_scalar(dst + 2 * i, src, index + i, frac + i, frame_count - i);
+}
+
+void fir_stereo_neon(float* dst, const float* src, const std::uint32_t* index,
+                     const float* const* coefficients, std::size_t frame_count, std::size_t taps) {
+	for (std::size_t i = 0; i < frame_count; ++i) {
+		const float* s = src + 2 * static_cast<std::size_t>(index[i]);
+		const float* h = coefficients[i];
+		float32x4_t acc = vdupq_n_f32(0.f);
+		for (std::size_t j = 0; j < 2 * taps; j += 4) {
+			acc = vaddq_f32(acc, vmulq_f32(vld1q_f32(s + j), vld1q_f32(h + j)));
+		}
+		vst1_f32(dst + 2 * i, vadd_f32(vget_low_f32(acc), vget_high_f32(acc)));
+	}
+}
+
+void to_s16_neon(std::int16_t* dst, const float* src, std::size_t sample_count) {
+	const float32x4_t scale = vdupq_n_f32(65535.f);
+	const float32x4_t one = vdupq_n_f32(1.f);
+	const float32x4_t half = vdupq_n_f32(0.5f);
+	const float32x4_t upper = vdupq_n_f32(32767.f);
+	const float32x4_t lower = vdupq_n_f32(-32768.f);
+	auto convert = [&](const float* p) {
+		float32x4_t v = vmulq_f32(vsubq_f32(vmulq_f32(scale, vld1q_f32(p)), one), half);
+		v = vmaxq_f32(vminq_f32(v, upper), lower);
+		return vmovn_s32(vcvtq_s32_f32(v)); // rounds towards zero like static_cast
+	};
+	std::size_t i = 0;
+	for (; i + 8 <= sample_count; i += 8) {
+		vst1q_s16(dst + i, vcombine_s16(convert(src + i), convert(src + i + 4)));
+	}
+	to_s16_scalar(dst + i, src + i, sample_count - i);
+}
+
+const kernel_table NEON{ "NEON", &mix_add_neon, &gain_stereo_neon, &lerp_stereo_neon,
+	                     &fir_stereo_neon, &to_s16_neon };
+#endif
+
+const kernel_table SCALAR{ "scalar", &mix_add_scalar, &gain_stereo_scalar, &lerp_stereo_scalar,
+	                       &fir_stereo_scalar, &to_s16_scalar };
+
+} // namespace
+
+const kernel_table& kernels() {
+	static const kernel_table& best = *available_kernels().back();
+	return best;
+}
+
+std::vector<const kernel_table*> available_kernels() {
+	std::vector<const kernel_table*> rtn{ &SCALAR };
+#ifdef JNGL_AUDIO_SSE2
+	rtn.emplace_back(&SSE2);
+#endif
+#ifdef JNGL_AUDIO_AVX2
+	if (cpuSupportsAvx2()) {
+		rtn.emplace_back(&AVX2);
+	}
+#endif
+#ifdef JNGL_AUDIO_NEON
+	rtn.emplace_back(&NEON);
+#endif
+	return rtn;
+}
+
+} // namespace jngl::audio
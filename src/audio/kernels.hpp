@@ -0,0 +1,42 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jngl::audio {
+
+/// Inner loops of the audio thread. Every implementation produces bit-identical results to the
+/// scalar one, so which one gets picked only affects speed.
+struct kernel_table {
+	const char* name;
+
+	/// dst[i] += src[i]
+	void (*mix_add)(float* dst, const float* src, std::size_t sample_count);
+
+	/// Multiplies interleaved stereo samples with a constant gain per channel
+	void (*gain_stereo)(float* data, std::size_t sample_count, float left, float right);
+
+	/// dst[2i + c] = a + frac[i] * (b - a) with a = src[2 * index[i] + c] and
+	/// b = src[2 * index[i] + 2 + c], i.e. linear interpolation between two stereo frames
+	void (*lerp_stereo)(float* dst, const float* src, const std::uint32_t* index,
+	                    const float* frac, std::size_t frame_count);
+
+	/// Inner product of 2 * taps interleaved stereo samples starting at frame index[i] with the
+	/// filter coefficients[i] (every coefficient twice, once for each channel). taps must be even.
+	void (*fir_stereo)(float* dst, const float* src, const std::uint32_t* index,
+	                   const float* const* coefficients, std::size_t frame_count, std::size_t taps);
+
+	/// Converts [-1, 1] floats to signed 16 bit integers, clamping values out of range
+	void (*to_s16)(std::int16_t* dst, const float* src, std::size_t sample_count);
+};
+
+/// Fastest implementation supported by the CPU we're running on, detected once
+const kernel_table& kernels();
+
+/// All implementations which can be run on this CPU, the first one is always the scalar fallback
+std::vector<const kernel_table*> available_kernels();
+
+} // namespace jngl::audio
@@ -4,24 +4,85 @@
 // https://lisyarus.github.io/blog/programming/2022/10/15/audio-mixing.html
 #include "mixer.hpp"
 
+#include "SubmixWorkers.hpp"
+#include "kernels.hpp"
+
 #include <atomic_queue/atomic_queue.h>
 
 #include <algorithm>
 #include <atomic>
+#include <cassert>
+#include <limits>
 #include <memory>
 #include <vector>
 
 namespace jngl {
 
+namespace {
+/// Streams quieter than about -80 dB are never mixed
+constexpr float INAUDIBLE = 1e-4f;
+} // namespace
+
 struct Mixer::Impl {
-	atomic_queue::AtomicQueue<Stream*, 10> streamsToRemoveOnMainThread;
+	atomic_queue::AtomicQueue<Stream*, 256> streamsToRemoveOnMainThread;
 	std::vector<Stream*> streamsToRemoveLater;
 
-	constexpr static uintptr_t REMOVE_FLAG = 1;
-	atomic_queue::AtomicQueue<uintptr_t, 20> commands;
+	struct Command {
+		Stream* stream = nullptr;
+		int priority = 0;
+		bool remove = false;
+		std::int64_t at = 0; //< start or stop on the SampleClock
+	};
+	atomic_queue::AtomicQueue2<Command, 256> commands;
+
+	/// Commands which didn't fit into the queue, e.g. because the audio device is paused and
+	/// nothing pops from it. Only used on main thread.
+	std::vector<Command> pendingCommands;
+
+	void push(const Command& command) {
+		// once something is pending, everything after it has to wait, too, to keep the order
+		if (!pendingCommands.empty() || !commands.try_push(Command(command))) {
+			pendingCommands.emplace_back(command);
+		}
+	}
+
+	void flush() {
+		auto it = pendingCommands.begin();
+		while (it != pendingCommands.end() && commands.try_push(Command(*it))) {
+			++it;
+		}
+		pendingCommands.erase(pendingCommands.begin(), it);
+	}
+
+	/// Everything needed to read Streams in parallel, only allocated when setWorkers() is called
+	struct Parallel {
+		audio::SubmixWorkers* workers;
+		std::vector<float> buffers; //< BUFFER_SIZE floats for every job
+		std::vector<audio::SubmixWorkers::Job> jobs;
+	};
+	std::unique_ptr<Parallel> parallelOnMainThread;
+	std::atomic<Parallel*> parallel{ nullptr };
+
+	/// Hands the Stream back to the main thread, only called on mixer thread
+	void release(Stream* stream) {
+		if (!streamsToRemoveOnMainThread.try_push(stream)) {
+			// we shall never ever block in this thread. Therefore only use try_push and lets hope
+			// that the main thread will GC at some point.
+			streamsToRemoveLater.emplace_back(stream);
+		}
+	}
 };
 
-Mixer::Mixer() : impl(std::make_unique<Impl>()) {
+Mixer::Mixer() : Mixer(nullptr) {
+}
+
+Mixer::Mixer(std::shared_ptr<const audio::SampleClock> clock)
+: impl(std::make_unique<Impl>()), clock_(std::move(clock)) {
+	if (!clock_) {
+		ownClock = std::make_shared<audio::SampleClock>();
+		clock_ = ownClock;
+	}
+	streamsOnMainThread.reserve(MAX_ACTIVE_STREAMS); // so that add() doesn't have to allocate
 }
 Mixer::~Mixer() = default;
 
@@ -33,12 +94,32 @@ void Mixer::gc() {
 		assert(it != streamsOnMainThread.end());
 		streamsOnMainThread.erase(it);
 	}
+	impl->flush();
 }
 
-void Mixer::remove(const Stream* stream) {
+void Mixer::remove(const Stream* stream, std::int64_t stop) {
 	gc();
-	assert(reinterpret_cast<uintptr_t>(stream) % 2 == 0); // NOLINT
-	impl->commands.push(reinterpret_cast<uintptr_t>(stream) + Impl::REMOVE_FLAG); // NOLINT
+	impl->push({ const_cast<Stream*>(stream), 0, true, stop }); // NOLINT
+}
+
+std::shared_ptr<const audio::SampleClock> Mixer::clock() const {
+	return clock_;
+}
+
+void Mixer::setWorkers(audio::SubmixWorkers* workers) {
+	assert(!impl->parallelOnMainThread);
+	impl->parallelOnMainThread = std::make_unique<Impl::Parallel>(
+	    Impl::Parallel{ workers, std::vector<float>(MAX_MIXED_STREAMS * BUFFER_SIZE),
+	                    std::vector<audio::SubmixWorkers::Job>(MAX_MIXED_STREAMS) });
+	impl->parallel.store(impl->parallelOnMainThread.get(), std::memory_order_release);
+}
+
+size_t Mixer::activeStreamCount() const {
+	return active_.load(std::memory_order_relaxed);
+}
+
+size_t Mixer::mixedStreamCount() const {
+	return mixed_.load(std::memory_order_relaxed);
 }
 
 void Mixer::rewind() {
@@ -54,19 +135,13 @@ bool Mixer::isPlaying() const {
 	return false;
 }
 
-void Mixer::add(std::shared_ptr<Stream> stream) {
+void Mixer::add(std::shared_ptr<Stream> stream, int priority, std::int64_t start) {
 	gc();
-	assert(reinterpret_cast<uintptr_t>(stream.get()) % 2 == 0); // NOLINT
-	impl->commands.push(reinterpret_cast<uintptr_t>(stream.get())); // NOLINT
+	impl->push({ stream.get(), priority, false, start });
 	streamsOnMainThread.emplace_back(std::move(stream));
 }
 
-size_t Mixer::read(float* data, size_t sample_count) {
-	if (sample_count > BUFFER_SIZE) {
-		size_t first = read(data, BUFFER_SIZE);
-		return first + read(data + BUFFER_SIZE, sample_count - BUFFER_SIZE);
-	}
-
+void Mixer::processCommands(std::int64_t blockStart) {
 	auto end = impl->streamsToRemoveLater.end();
 	for (auto it = impl->streamsToRemoveLater.begin(); it != end;) {
 		if (*it) {
@@ -85,61 +160,150 @@ size_t Mixer::read(float* data, size_t sample_count) {
 		}
 	}
 
-	uintptr_t tmp;
-	while (impl->commands.try_pop(tmp)) {
-		if (tmp % 2 == 0) { // REMOVE_FLAG not set, means we have to add a new Stream*
-			if (numberOfActiveStreams < MAX_ACTIVE_STREAMS) {
-				activeStreams[numberOfActiveStreams++] = reinterpret_cast<Stream*>(tmp); // NOLINT
+	Impl::Command command;
+	while (impl->commands.try_pop(command)) {
+		const auto activeEnd = activeStreams + numberOfActiveStreams;
+		if (command.remove) {
+			auto it = std::find_if(activeStreams, activeEnd, [&command](const auto& active) {
+				return active.stream == command.stream;
+			});
+			if (it != activeEnd) {
+				if (command.at > blockStart) {
+					it->stop = command.at; // process() will release it
+				} else {
+					*it = activeStreams[--numberOfActiveStreams]; // move the last element to the
+					                                              // one to be erased
+					impl->release(command.stream);
+				}
 			}
-		} else { // REMOVE_FLAG set
-			auto stream = reinterpret_cast<Stream*>(tmp - Impl::REMOVE_FLAG); // NOLINT
-			auto it = std::find(activeStreams, activeStreams + numberOfActiveStreams, stream);
-			if (it != activeStreams + numberOfActiveStreams) {
-				*it = activeStreams[--numberOfActiveStreams]; // move the last element to the one to
-				                                              // be erased
-				if (!impl->streamsToRemoveOnMainThread.try_push(stream)) {
-					// we shall never ever block in this thread. Therefore only use try_push and
-					// lets hope that the main thread will GC at some point.
-					impl->streamsToRemoveLater.emplace_back(stream);
+		} else {
+			ActiveStream added{ command.stream, command.priority, 0.f, command.at,
+				                std::numeric_limits<std::int64_t>::max() };
+			if (numberOfActiveStreams == MAX_ACTIVE_STREAMS) {
+				// steal the voice with the lowest priority, which might be the new one
+				auto lowest = std::min_element(
+				    activeStreams, activeEnd,
+				    [](const auto& a, const auto& b) { return a.priority < b.priority; });
+				if (lowest->priority < added.priority) {
+					std::swap(*lowest, added);
 				}
+				impl->release(added.stream);
+			} else {
+				activeStreams[numberOfActiveStreams++] = added;
 			}
 		}
 	}
+}
 
-	std::fill(data, data + sample_count, 0.f);
+size_t Mixer::prioritize(std::int64_t blockEnd) {
+	const auto begin = activeStreams;
+	const auto end = activeStreams + numberOfActiveStreams;
+	for (auto it = begin; it != end; ++it) {
+		it->audibility = it->start < blockEnd ? it->stream->audibility() : 0.f;
+	}
+	const auto audibleEnd = std::partition(
+	    begin, end, [](const ActiveStream& active) { return active.audibility > INAUDIBLE; });
+	const auto audible = static_cast<size_t>(audibleEnd - begin);
+	if (audible <= MAX_MIXED_STREAMS) {
+		return audible;
+	}
+	std::nth_element(begin, begin + MAX_MIXED_STREAMS, audibleEnd,
+	                 [](const ActiveStream& a, const ActiveStream& b) {
+		                 if (a.priority != b.priority) {
+			                 return a.priority > b.priority;
+		                 }
+		                 return a.audibility > b.audibility;
+	                 });
+	return MAX_MIXED_STREAMS;
+}
 
-	for (auto it = activeStreams; it != activeStreams + numberOfActiveStreams;) {
-		auto& stream = *it;
-		if (!stream) {
-			continue;
-		}
+void Mixer::process(float* data, size_t sample_count) {
+	const auto blockStart = clock_->frames.load(std::memory_order_acquire);
+	const auto blockFrames = static_cast<std::int64_t>(sample_count / 2);
+	const auto blockEnd = blockStart + blockFrames;
+	processCommands(blockStart);
 
-		auto read = stream->read(buffer, sample_count);
+	size_t mixed = 0;
+	if (data) {
+		mixed = prioritize(blockEnd);
+		std::fill(data, data + sample_count, 0.f);
+	}
 
-		{
-			auto begin = buffer;
-			auto end = begin + read;
-			auto dst = data;
-			for (; begin < end;) {
-				*dst++ += *begin++;
-			}
+	// Part of the block in which a Stream plays, as offset in samples and sample count. Streams
+	// which haven't been scheduled play during the whole block.
+	struct Range {
+		size_t offset;
+		size_t count;
+	};
+	const auto range = [blockStart, blockFrames](const ActiveStream& active) {
+		const auto begin = std::clamp<std::int64_t>(active.start - blockStart, 0, blockFrames);
+		const auto end = std::clamp<std::int64_t>(active.stop - blockStart, begin, blockFrames);
+		return Range{ static_cast<size_t>(2 * begin), static_cast<size_t>(2 * (end - begin)) };
+	};
+	const auto finish = [this, blockEnd](ActiveStream& active, size_t count, size_t expected) {
+		if (count < expected || active.stop <= blockEnd) {
+			impl->release(active.stream);
+			active.stream = nullptr;
 		}
+	};
 
-		if (read < sample_count) {
-			if (!impl->streamsToRemoveOnMainThread.try_push(*it)) {
-				// we shall never ever block in this thread. Therefore only use try_push and lets
-				// hope that the main thread will GC at some point. (see above)
-				impl->streamsToRemoveLater.emplace_back(*it);
-			}
-			*it = activeStreams[--numberOfActiveStreams]; // move the last element to the one to be
-			                                              // erased
+	const auto mixAdd = audio::kernels().mix_add;
+	size_t i = 0;
+	if (const auto parallel = impl->parallel.load(std::memory_order_acquire);
+	    parallel && mixed > 1) {
+		for (; i < mixed; ++i) {
+			parallel->jobs[i] = { activeStreams[i].stream, &parallel->buffers[i * BUFFER_SIZE],
+				                  range(activeStreams[i]).count, 0 };
+		}
+		parallel->workers->run(parallel->jobs.data(), mixed);
+		// summing up in a fixed order keeps the result independent of the scheduling
+		for (size_t j = 0; j < mixed; ++j) {
+			const auto& job = parallel->jobs[j];
+			mixAdd(data + range(activeStreams[j]).offset, job.buffer, job.result);
+			finish(activeStreams[j], job.result, job.sampleCount);
+		}
+	}
+	for (; i < numberOfActiveStreams; ++i) {
+		auto& active = activeStreams[i];
+		if (active.start >= blockEnd) {
+			continue; // hasn't started yet
+		}
+		const auto [offset, expected] = range(active);
+		size_t count; // NOLINT
+		if (i < mixed) {
+			count = active.stream->read(buffer, expected);
+			mixAdd(data + offset, buffer, count);
 		} else {
-			++it;
+			count = active.stream->skip(expected);
 		}
+		finish(active, count, expected);
 	}
+	// erase finished Streams after the loop, moving them around while iterating would mix up
+	// which ones are virtual
+	numberOfActiveStreams = static_cast<size_t>(
+	    std::remove_if(activeStreams, activeStreams + numberOfActiveStreams,
+	                   [](const ActiveStream& active) { return active.stream == nullptr; }) -
+	    activeStreams);
+	active_.store(numberOfActiveStreams, std::memory_order_relaxed);
+	mixed_.store(std::min(mixed, numberOfActiveStreams), std::memory_order_relaxed);
+	if (ownClock) {
+		ownClock->frames.store(blockEnd, std::memory_order_release);
+	}
+}
 
+size_t Mixer::read(float* data, size_t sample_count) {
+	if (sample_count > BUFFER_SIZE) {
+		size_t first = read(data, BUFFER_SIZE);
+		return first + read(data + BUFFER_SIZE, sample_count - BUFFER_SIZE);
+	}
+	process(data, sample_count);
 	played_.fetch_add(sample_count);
+	return sample_count;
+}
 
+size_t Mixer::skip(size_t sample_count) {
+	process(nullptr, sample_count);
+	played_.fetch_add(sample_count);
 	return sample_count;
 }
 
@@ -7,26 +7,79 @@
 #include "Stream.hpp"
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <vector>
 
 namespace jngl {
+namespace audio {
+class SubmixWorkers;
+
+/// Frames mixed by the main Mixer, the time base for scheduling Streams sample-accurately
+struct SampleClock {
+	std::atomic<std::int64_t> frames{ 0 };
+};
+} // namespace audio
 
 class Mixer : public Stream {
 public:
+	/// Creates a Mixer with its own SampleClock, which advances with every read() and skip()
 	Mixer();
+
+	/// Uses the SampleClock of another Mixer which reads this one, e.g. for the Mixer of a Channel
+	/// that ends up in the main Mixer. Doesn't advance \a clock.
+	explicit Mixer(std::shared_ptr<const audio::SampleClock> clock);
+
 	~Mixer() override;
 
-	void add(std::shared_ptr<Stream> stream);
-	void remove(const Stream*);
+	/// Streams with a higher \a priority are preferred when there are more than MAX_MIXED_STREAMS
+	///
+	/// The Stream starts exactly at frame \a start of the SampleClock, or as soon as the command
+	/// gets processed if that's already in the past.
+	void add(std::shared_ptr<Stream> stream, int priority = 0, std::int64_t start = 0);
+
+	/// Stops the Stream at frame \a stop of the SampleClock or as soon as possible
+	void remove(const Stream*, std::int64_t stop = 0);
+
+	std::shared_ptr<const audio::SampleClock> clock() const;
+
+	/// Read the mixed Streams in parallel, e.g. the Channels in the main Mixer
+	///
+	/// Can only be set once and \a workers must outlive this Mixer.
+	void setWorkers(audio::SubmixWorkers* workers);
+
+	/// Streams which are still playing after the last read() or skip(), including virtual ones.
+	/// Can be called from any thread.
+	size_t activeStreamCount() const;
+
+	/// Streams which have actually been mixed (i.e. not skipped) by the last read()
+	size_t mixedStreamCount() const;
 
 	void rewind() override;
 	bool isPlaying() const override;
 	size_t read(float*, size_t) override;
+	size_t skip(size_t) override;
+
+	/// At most this many Streams get mixed, the rest become virtual: They only advance using
+	/// Stream::skip
+	constexpr static size_t MAX_MIXED_STREAMS = 64;
+
+	/// When even more Streams are added the one with the lowest priority gets stopped
+	constexpr static size_t MAX_ACTIVE_STREAMS = 1024;
 
 private:
 	void gc();
 
+	/// Executes the commands from add() and remove(), only called on mixer thread
+	void processCommands(std::int64_t blockStart);
+
+	/// Sorts activeStreams, so that the returned number of Streams at the start should be mixed.
+	/// Streams which start at \a blockEnd or later are never mixed.
+	size_t prioritize(std::int64_t blockEnd);
+
+	/// data == nullptr means that all Streams should only be skipped
+	void process(float* data, size_t sample_count);
+
 	struct Impl;
 	std::unique_ptr<Impl> impl;
 
@@ -35,10 +88,21 @@ private:
 	constexpr static size_t BUFFER_SIZE = 996;
 	float buffer[BUFFER_SIZE] = { 0 };
 
-	constexpr static size_t MAX_ACTIVE_STREAMS = 256;
-	Stream* activeStreams[MAX_ACTIVE_STREAMS] = { nullptr }; //< only used on mixer thread
+	struct ActiveStream {
+		Stream* stream;
+		int priority;
+		float audibility;   //< only valid during prioritize()
+		std::int64_t start; //< frame of the SampleClock, might be in the past
+		std::int64_t stop;  //< frame of the SampleClock, INT64_MAX if not scheduled
+	};
+	ActiveStream activeStreams[MAX_ACTIVE_STREAMS] = {}; //< only used on mixer thread
 
 	std::atomic<std::size_t> played_{ 0 };
+	std::atomic<std::size_t> active_{ 0 };
+	std::atomic<std::size_t> mixed_{ 0 };
+
+	std::shared_ptr<audio::SampleClock> ownClock; //< only set when this Mixer advances the clock
+	std::shared_ptr<const audio::SampleClock> clock_;
 
 	std::vector<std::shared_ptr<Stream>> streamsOnMainThread;
 };
@@ -6,33 +6,86 @@
 
 #include "../../jngl/debug.hpp"
 #include "../../jngl/other.hpp"
+#include "../../jngl/sound.hpp"
 #include "../../log.hpp"
+#include "../CallbackStatistics.hpp"
+#include "../OfflineRenderer.hpp"
 #include "../Stream.hpp"
 #include "../constants.hpp"
+#include "../effect/pitch.hpp"
+#include "../kernels.hpp"
 
 #include <SDL.h>
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <string_view>
 #include <vector>
 
 namespace jngl::audio {
 
 struct engine::Impl {
-	explicit Impl(std::shared_ptr<Stream> output) {
+	Impl(std::shared_ptr<Stream> output, const AudioDeviceParameters& parameters)
+	: output(std::move(output)) {
+		if (const char* const requested = std::getenv("JNGL_AUDIO_BACKEND");
+		    requested && std::string_view(requested) == "offline") {
+			internal::debug("Using offline audio backend");
+			backend = std::make_unique<OfflineImpl>(this->output);
+			return;
+		}
+		openDevice(parameters);
+	}
+
+	void openDevice(const AudioDeviceParameters& parameters) {
 		try {
-			backend = std::make_unique<SdlImpl>(output);
+			backend = std::make_unique<SdlImpl>(output, parameters, statistics);
 		} catch (std::exception& e) {
 			debugLn(e.what());
-			backend = std::make_unique<DummyImpl>(std::move(output));
+			backend = std::make_unique<DummyImpl>(output);
+		}
+		if (paused) {
+			backend->setPause(true);
+		}
+	}
+
+	void setParameters(const AudioDeviceParameters& parameters) {
+		if (dynamic_cast<OfflineImpl*>(backend.get())) {
+			return;
 		}
+		backend.reset(); // closes the old device before opening a new one
+		openDevice(parameters);
 	}
+
+	std::shared_ptr<Stream> output;
+	CallbackStatistics statistics;
+	bool paused = false;
+
 	struct Backend {
 		virtual ~Backend() = default;
 		virtual void setPause(bool) = 0;
 		virtual void step() {}
+		virtual OfflineRenderer* offlineRenderer() {
+			return nullptr;
+		}
 	};
 	std::unique_ptr<Backend> backend;
 
+	/// Only advances when OfflineRenderer::render is called
+	struct OfflineImpl : public Backend {
+		explicit OfflineImpl(std::shared_ptr<Stream> output) : renderer(std::move(output)) {
+		}
+		void setPause(bool) override {
+		}
+		OfflineRenderer* offlineRenderer() override {
+			return &renderer;
+		}
+
+		OfflineRenderer renderer;
+	};
+
 	struct DummyImpl : public Backend {
 		explicit DummyImpl(std::shared_ptr<Stream> output)
 		: output(std::move(output)) {
@@ -85,27 +138,46 @@ struct engine::Impl {
 
 		std::shared_ptr<Stream> output;
 
-		explicit SdlImpl(std::shared_ptr<Stream> output) : output(std::move(output)) {
+		CallbackStatistics& statistics;
+
+		int sampleRate;
+
+		SdlImpl(std::shared_ptr<Stream> output, const AudioDeviceParameters& parameters,
+		        CallbackStatistics& statistics)
+		: output(std::move(output)), statistics(statistics),
+		  sampleRate(parameters.sampleRate > 0 ? parameters.sampleRate : frequency) {
 			if (SDL_Init(SDL_INIT_AUDIO) < 0) {
 				throw std::runtime_error(SDL_GetError());
 			}
+			if (sampleRate != frequency) {
+				// the pitch effect reads the mix at audio::frequency and resamples it
+				this->output = pitch(this->output, static_cast<float>(frequency) /
+				                                       static_cast<float>(sampleRate));
+			}
 			SDL_AudioSpec desired, obtained;
-			desired.freq = frequency;
+			desired.freq = sampleRate;
 			desired.channels = 2;
 			desired.format = AUDIO_S16SYS;
+			if (parameters.bufferFrames > 0) {
+				// SDL expects a power of two, the largest that fits into Uint16 is 32768
+				desired.samples =
+				    static_cast<Uint16>(std::bit_ceil(std::min(parameters.bufferFrames, 32768u)));
+			} else {
 #ifdef __EMSCRIPTEN__
-			desired.samples = 2048;
+				desired.samples = 2048;
 #else
-			desired.samples = 256;
+				desired.samples = 256;
 #endif
+			}
 			desired.callback = &callback;
 			desired.userdata = this;
 			if (device = SDL_OpenAudioDevice(nullptr, 0, &desired, &obtained, 0); device == 0) {
 				throw std::runtime_error(SDL_GetError());
 			}
 
-			internal::debug("Initialized audio: {} channels, {} Hz, {} samples",
-			                static_cast<int>(obtained.channels), obtained.freq, obtained.samples);
+			internal::debug("Initialized audio: {} channels, {} Hz, {} samples, {} kernels",
+			                static_cast<int>(obtained.channels), obtained.freq, obtained.samples,
+			                kernels().name);
 
 			buffer.resize(obtained.samples * obtained.channels);
 			SDL_PauseAudioDevice(device, 0);
@@ -118,6 +190,7 @@ struct engine::Impl {
 			static std::string const profiler_str = "audio";
 			// prof::profiler prof(profiler_str);
 
+			const auto start = std::chrono::steady_clock::now();
 			auto self = static_cast<SdlImpl*>(userdata);
 			std::int16_t* dst = reinterpret_cast<std::int16_t*>(dst_u8);
 
@@ -126,10 +199,9 @@ struct engine::Impl {
 			read = self->output->read(self->buffer.data(), size);
 			std::fill(self->buffer.data() + read, self->buffer.data() + size, 0.f);
 
-			for (auto s : self->buffer) {
-				*dst++ = static_cast<std::int16_t>(
-				    std::max(std::min((65535.f * s - 1.f) / 2.f, 32767.f), -32768.f));
-			}
+			kernels().to_s16(dst, self->buffer.data(), self->buffer.size());
+			self->statistics.record(std::chrono::steady_clock::now() - start, size / 2,
+			                        self->sampleRate);
 		}
 
 		void setPause(bool pause) override {
@@ -138,17 +210,31 @@ struct engine::Impl {
 	};
 };
 
-engine::engine(std::shared_ptr<Stream> output) : impl(std::make_unique<Impl>(std::move(output))) {
+engine::engine(std::shared_ptr<Stream> output, const AudioDeviceParameters& parameters)
+: impl(std::make_unique<Impl>(std::move(output), parameters)) {
 }
 
 engine::~engine() = default;
 
 void engine::setPause(bool pause) {
+	impl->paused = pause;
 	impl->backend->setPause(pause);
 }
 
+void engine::setParameters(const AudioDeviceParameters& parameters) {
+	impl->setParameters(parameters);
+}
+
+const CallbackStatistics& engine::statistics() const {
+	return impl->statistics;
+}
+
 void engine::step() {
 	impl->backend->step();
 }
 
+OfflineRenderer* engine::offlineRenderer() {
+	return impl->backend->offlineRenderer();
+}
+
 } // namespace jngl::audio
@@ -24,8 +24,14 @@ inline float multiplier_to_smoothness(float multiplier) {
 	return -inv_frequency / std::log1p(-multiplier);
 }
 
+/// Moves \a value towards \a target_value, reaching it exactly after a finite number of calls
+///
+/// With a multiplier below 1 the exponential approach would stall within a few ulps of the target
+/// due to rounding, so it snaps once the distance is inaudible or there's no progress anymore.
 inline void smooth_update(float& value, float target_value, float smoothness_multiplier) {
-	value += (target_value - value) * smoothness_multiplier;
+	constexpr float EPSILON = 1e-5f; // -100 dB
+	const float next = value + (target_value - value) * smoothness_multiplier;
+	value = (next == value || std::abs(target_value - next) < EPSILON) ? target_value : next;
 }
 
 } // namespace jngl::audio
@@ -4,33 +4,68 @@
 // https://lisyarus.github.io/blog/programming/2022/10/15/audio-mixing.html
 #include "Track.hpp"
 
+#include <algorithm>
+#include <cassert>
+
 namespace jngl {
 
-PlayingTrack::PlayingTrack(gsl::span<const float> samples) : samples(samples) {
+PlayingTrack::PlayingTrack(const PcmBuffer& pcm) : pcm(&pcm), size(pcm.frames() * 2) {
+	assert(pcm.channels == 1 || pcm.channels == 2);
+}
+
+void PlayingTrack::reset(const PcmBuffer& pcm) {
+	assert(pcm.channels == 1 || pcm.channels == 2);
+	this->pcm = &pcm;
+	size = pcm.frames() * 2;
+	played_ = 0;
 }
 
 float PlayingTrack::progress() const {
-	return static_cast<float>(played_) / static_cast<float>(samples.size());
+	if (size == 0) {
+		return 0;
+	}
+	return static_cast<float>(played_) / static_cast<float>(size);
 }
 
 std::size_t PlayingTrack::read(float* data, std::size_t sample_count) {
 	auto played = played_.load();
+	assert(played % 2 == 0);
+
+	auto count = std::min(size - played, sample_count);
+	constexpr float scale = 1.f / PcmBuffer::FULL_SCALE;
+	if (pcm->channels == 1) {
+		const std::int16_t* src = pcm->samples.data() + played / 2;
+		for (std::size_t i = 0; i < count / 2; ++i) {
+			data[2 * i] = data[2 * i + 1] = static_cast<float>(src[i]) * scale;
+		}
+	} else {
+		const std::int16_t* src = pcm->samples.data() + played;
+		for (std::size_t i = 0; i < count; ++i) {
+			data[i] = static_cast<float>(src[i]) * scale;
+		}
+	}
+	// if seek() has been called in the meantime it wins:
+	played_.compare_exchange_strong(played, played + count);
+	return count;
+}
 
-	auto count = std::min(samples.size() - played, sample_count);
-	std::copy(samples.begin() + static_cast<decltype(samples)::difference_type>(played),
-	          samples.begin() + static_cast<decltype(samples)::difference_type>(played) +
-	              static_cast<decltype(samples)::difference_type>(count),
-	          data);
-	played_.fetch_add(count);
+std::size_t PlayingTrack::skip(std::size_t sample_count) {
+	auto played = played_.load();
+	const auto count = std::min(size - played, sample_count);
+	played_.compare_exchange_strong(played, played + count);
 	return count;
 }
 
+void PlayingTrack::seek(std::size_t sample) {
+	played_ = std::min(sample - sample % 2, size);
+}
+
 void PlayingTrack::rewind() {
 	played_ = 0;
 }
 
 bool PlayingTrack::isPlaying() const {
-	return samples.size() - played_ > 0;
+	return size - played_ > 0;
 }
 
 } // namespace jngl
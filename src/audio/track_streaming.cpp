@@ -0,0 +1,179 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "StreamingTrack.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+#define OV_EXCLUDE_STATIC_CALLBACKS
+#include <vorbis/vorbisfile.h>
+
+#ifdef ANDROID
+#include "../android/fopen.hpp"
+#endif
+
+namespace jngl {
+
+namespace {
+/// Number of stereo frames decoded at once
+constexpr int CHUNK_FRAMES = 1024;
+
+/// How far the decoder thread stays ahead of playback, about 370 ms at 44.1 kHz
+constexpr std::size_t BUFFERED_FRAMES = 16384;
+} // namespace
+
+struct StreamingTrack::Decoder {
+	OggVorbis_File file{};
+	int channels = 0;
+	long rate = 0;
+	std::vector<float> interleaved = std::vector<float>(CHUNK_FRAMES * 2);
+};
+
+StreamingTrack::StreamingTrack(const std::string& filename)
+: decoder(std::make_unique<Decoder>()), ring(BUFFERED_FRAMES * 2) {
+#ifdef _WIN32
+	FILE* const f = fopen(filename.c_str(), "rb");
+#else
+	FILE* const f = fopen(filename.c_str(), "rbe");
+#endif
+	if (f == nullptr) {
+		throw std::runtime_error("File not found (" + filename + ").");
+	}
+	if (ov_open(f, &decoder->file, nullptr, 0) != 0) {
+		fclose(f); // If [and only if] an ov_open() call fails, the application must explicitly
+		           // fclose() the FILE * pointer itself.
+		throw std::runtime_error("Could not open OGG file (" + filename + ").");
+	}
+	const vorbis_info* const info = ov_info(&decoder->file, -1);
+	decoder->channels = info->channels;
+	decoder->rate = info->rate;
+	totalSamples =
+	    static_cast<std::size_t>(std::max<ogg_int64_t>(0, ov_pcm_total(&decoder->file, -1))) * 2;
+	thread = std::thread([this]() { decode(); });
+}
+
+StreamingTrack::~StreamingTrack() {
+	{
+		std::lock_guard lock(mutex);
+		quit = true;
+	}
+	wakeUp.notify_one();
+	thread.join();
+	ov_clear(&decoder->file); /* calls fclose */
+}
+
+void StreamingTrack::decode() {
+	while (!quit) {
+		if (seekRequest.load() != NO_SEEK) {
+			// Cleared before taking the request, so that read() always sees one of both:
+			finished = false;
+			const auto target = seekRequest.exchange(NO_SEEK);
+			ov_pcm_seek(&decoder->file, target);
+			seekPlayed = static_cast<std::size_t>(target) * 2;
+			seekDiscardUntil = ring.written();
+			seekEpoch.fetch_add(1, std::memory_order_release);
+		}
+		if (finished || ring.capacity() - ring.size() < CHUNK_FRAMES * 2) {
+			// The mixer thread isn't allowed to lock, so it can't notify us. Polling at this
+			// interval is still way below the amount of audio buffered.
+			std::unique_lock lock(mutex);
+			wakeUp.wait_for(lock, std::chrono::milliseconds(5), [this]() {
+				return quit.load() || seekRequest.load() != NO_SEEK;
+			});
+			continue;
+		}
+		float** pcm = nullptr;
+		int bitStream;
+		const long frames = ov_read_float(&decoder->file, &pcm, CHUNK_FRAMES, &bitStream);
+		if (frames == OV_HOLE) {
+			continue; // recoverable, there was just an interruption in the data
+		}
+		if (frames <= 0) {
+			std::lock_guard lock(mutex); // setLooping might be called at the same time
+			if (frames == 0 && looping && totalSamples > 0) {
+				ov_pcm_seek(&decoder->file, 0);
+				continue;
+			}
+			finished.store(true, std::memory_order_release);
+			continue;
+		}
+		const float* const right = pcm[decoder->channels == 1 ? 0 : 1];
+		for (long i = 0; i < frames; ++i) {
+			decoder->interleaved[2 * i] = pcm[0][i];
+			decoder->interleaved[2 * i + 1] = right[i];
+		}
+		[[maybe_unused]] const auto written =
+		    ring.write(decoder->interleaved.data(), static_cast<std::size_t>(frames) * 2);
+		assert(written == static_cast<std::size_t>(frames) * 2);
+	}
+}
+
+void StreamingTrack::setLooping(bool value) {
+	std::lock_guard lock(mutex);
+	looping = value;
+	if (value) {
+		finished = false; // reading at the end will return 0 again and cause the decoder to loop
+	}
+}
+
+long StreamingTrack::getRate() const {
+	return decoder->rate;
+}
+
+float StreamingTrack::progress() const {
+	if (totalSamples == 0) {
+		return 0;
+	}
+	return static_cast<float>(played_ % totalSamples) / static_cast<float>(totalSamples);
+}
+
+void StreamingTrack::seek(std::size_t sample) {
+	{
+		std::lock_guard lock(mutex);
+		seekRequest = static_cast<std::int64_t>(std::min(sample, totalSamples) / 2);
+		ended = false;
+	}
+	wakeUp.notify_one();
+}
+
+size_t StreamingTrack::read(float* data, std::size_t sample_count) {
+	if (const auto epoch = seekEpoch.load(std::memory_order_acquire); epoch != seenSeekEpoch) {
+		seenSeekEpoch = epoch;
+		ring.discardUntil(seekDiscardUntil.load());
+		played_ = seekPlayed.load();
+	}
+	auto count = ring.read(data, sample_count);
+	if (count < sample_count) {
+		// A pending seek (e.g. rewind() of a looping Sound) will make the decoder continue. Check
+		// it before finished, which the decoder clears before taking the request:
+		const bool seekPending = seekRequest.load() != NO_SEEK;
+		if (!seekPending && finished.load()) {
+			// the decoder might have written its last samples right before setting finished
+			count += ring.read(data + count, sample_count - count);
+			if (count < sample_count) {
+				ended = true;
+			}
+			played_ += count;
+			return count;
+		}
+		// Decoder thread didn't keep up, play silence instead of ending the stream
+		std::fill(data + count, data + sample_count, 0.f);
+	}
+	played_ += count;
+	return sample_count;
+}
+
+void StreamingTrack::rewind() {
+	// called from the mixer thread, so we can't notify the decoder thread here
+	seekRequest = 0;
+	ended = false;
+}
+
+bool StreamingTrack::isPlaying() const {
+	return !ended;
+}
+
+} // namespace jngl
@@ -0,0 +1,92 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "AtlasPacker.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace jngl::bake {
+
+namespace {
+
+struct Shelf {
+	int y;
+	int height;
+	int x; //< where the next rectangle goes
+};
+
+struct Page {
+	std::vector<Shelf> shelves;
+	int bottom = 0; //< of the last shelf
+	bool full = false;
+};
+
+} // namespace
+
+PackedAtlas packAtlas(const std::vector<Size>& sizes, const int maxSize, const int padding) {
+	// Tallest first, so that every rectangle fits into the height of all previous shelves. Ties
+	// are broken by the index to stay deterministic:
+	std::vector<std::size_t> order(sizes.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&sizes](const std::size_t a, const std::size_t b) {
+		if (sizes[a].height != sizes[b].height) {
+			return sizes[a].height > sizes[b].height;
+		}
+		if (sizes[a].width != sizes[b].width) {
+			return sizes[a].width > sizes[b].width;
+		}
+		return a < b;
+	});
+
+	PackedAtlas atlas;
+	atlas.placements.resize(sizes.size());
+	std::vector<Page> pages;
+	const auto place = [&](const std::size_t index, const std::size_t page, const int x,
+	                       const int y) {
+		atlas.placements[index] = Placement{ page, x + padding, y + padding };
+		auto& pageSize = atlas.pages[page];
+		pageSize.width = std::max(pageSize.width, x + sizes[index].width + 2 * padding);
+		pageSize.height = std::max(pageSize.height, y + sizes[index].height + 2 * padding);
+	};
+	for (const std::size_t index : order) {
+		const int width = sizes[index].width + 2 * padding;
+		const int height = sizes[index].height + 2 * padding;
+		if (width > maxSize || height > maxSize) {
+			pages.emplace_back().full = true;
+			atlas.pages.emplace_back();
+			place(index, pages.size() - 1, 0, 0);
+			continue;
+		}
+		bool placed = false;
+		for (std::size_t i = 0; i < pages.size() && !placed; ++i) {
+			auto& page = pages[i];
+			if (page.full) {
+				continue;
+			}
+			for (auto& shelf : page.shelves) {
+				if (shelf.height >= height && shelf.x + width <= maxSize) {
+					place(index, i, shelf.x, shelf.y);
+					shelf.x += width;
+					placed = true;
+					break;
+				}
+			}
+			if (!placed && page.bottom + height <= maxSize) {
+				page.shelves.push_back(Shelf{ page.bottom, height, width });
+				place(index, i, 0, page.bottom);
+				page.bottom += height;
+				placed = true;
+			}
+		}
+		if (!placed) {
+			auto& page = pages.emplace_back();
+			page.shelves.push_back(Shelf{ 0, height, width });
+			page.bottom = height;
+			atlas.pages.emplace_back();
+			place(index, pages.size() - 1, 0, 0);
+		}
+	}
+	return atlas;
+}
+
+} // namespace jngl::bake
@@ -0,0 +1,37 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace jngl::bake {
+
+struct Size {
+	int width;
+	int height;
+};
+
+/// Position of a rectangle packed by packAtlas
+struct Placement {
+	std::size_t page;
+	int x; //< of the rectangle itself, i.e. without padding
+	int y;
+};
+
+struct PackedAtlas {
+	/// Same order as the sizes passed to packAtlas
+	std::vector<Placement> placements;
+
+	/// Each page is only as large as needed to fit its rectangles including their padding
+	std::vector<Size> pages;
+};
+
+/// Packs rectangles into pages of at most \a maxSize x \a maxSize pixels using shelves
+///
+/// \a padding pixels are kept free around each rectangle. Rectangles which are too large get a
+/// page of their own. The result only depends on the arguments, so that baking the same files
+/// twice results in identical atlases.
+PackedAtlas packAtlas(const std::vector<Size>& sizes, int maxSize, int padding);
+
+} // namespace jngl::bake
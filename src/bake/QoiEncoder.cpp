@@ -0,0 +1,90 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "QoiEncoder.hpp"
+
+#include <cstddef>
+
+namespace jngl::bake {
+
+namespace {
+
+struct Pixel {
+	uint8_t r, g, b, a;
+
+	bool operator==(const Pixel&) const = default;
+};
+
+void appendBigEndian(std::vector<uint8_t>& out, const uint32_t value) {
+	for (int shift = 24; shift >= 0; shift -= 8) {
+		out.push_back(static_cast<uint8_t>(value >> shift));
+	}
+}
+
+} // namespace
+
+std::vector<uint8_t> encodeQoi(const uint8_t* const rgba, const int width, const int height) {
+	constexpr uint8_t OP_INDEX = 0x00;
+	constexpr uint8_t OP_DIFF = 0x40;
+	constexpr uint8_t OP_LUMA = 0x80;
+	constexpr uint8_t OP_RUN = 0xc0;
+	constexpr uint8_t OP_RGB = 0xfe;
+	constexpr uint8_t OP_RGBA = 0xff;
+	constexpr int MAX_RUN = 62;
+
+	std::vector<uint8_t> out{ 'q', 'o', 'i', 'f' };
+	appendBigEndian(out, static_cast<uint32_t>(width));
+	appendBigEndian(out, static_cast<uint32_t>(height));
+	out.push_back(4); // channels
+	out.push_back(0); // sRGB with linear alpha
+
+	Pixel index[64] = {};
+	Pixel previous{ 0, 0, 0, 255 };
+	int run = 0;
+	const std::size_t count = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+	for (std::size_t i = 0; i < count; ++i) {
+		const uint8_t* const p = rgba + i * 4;
+		const Pixel px{ p[0], p[1], p[2], p[3] };
+		if (px == previous) {
+			if (++run == MAX_RUN || i == count - 1) {
+				out.push_back(static_cast<uint8_t>(OP_RUN | (run - 1)));
+				run = 0;
+			}
+			continue;
+		}
+		if (run > 0) {
+			out.push_back(static_cast<uint8_t>(OP_RUN | (run - 1)));
+			run = 0;
+		}
+		const int hash = (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+		if (index[hash] == px) {
+			out.push_back(static_cast<uint8_t>(OP_INDEX | hash));
+		} else {
+			index[hash] = px;
+			if (px.a == previous.a) {
+				// Differences wrap around, just like the decoder's uint8_t arithmetic:
+				const auto vr = static_cast<int8_t>(px.r - previous.r);
+				const auto vg = static_cast<int8_t>(px.g - previous.g);
+				const auto vb = static_cast<int8_t>(px.b - previous.b);
+				const int vgr = vr - vg;
+				const int vgb = vb - vg;
+				if (vr >= -2 && vr <= 1 && vg >= -2 && vg <= 1 && vb >= -2 && vb <= 1) {
+					out.push_back(
+					    static_cast<uint8_t>(OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)));
+				} else if (vgr >= -8 && vgr <= 7 && vg >= -32 && vg <= 31 && vgb >= -8 &&
+				           vgb <= 7) {
+					out.push_back(static_cast<uint8_t>(OP_LUMA | (vg + 32)));
+					out.push_back(static_cast<uint8_t>((vgr + 8) << 4 | (vgb + 8)));
+				} else {
+					out.insert(out.end(), { OP_RGB, px.r, px.g, px.b });
+				}
+			} else {
+				out.insert(out.end(), { OP_RGBA, px.r, px.g, px.b, px.a });
+			}
+		}
+		previous = px;
+	}
+	out.insert(out.end(), { 0, 0, 0, 0, 0, 0, 0, 1 }); // end marker
+	return out;
+}
+
+} // namespace jngl::bake
@@ -0,0 +1,15 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace jngl::bake {
+
+/// Encodes \a width x \a height tightly packed RGBA pixels as a QOI file with 4 channels
+///
+/// QOI decodes several times faster than PNG, see https://qoiformat.org
+std::vector<uint8_t> encodeQoi(const uint8_t* rgba, int width, int height);
+
+} // namespace jngl::bake
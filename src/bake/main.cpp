@@ -0,0 +1,196 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+
+// jngl-bake: Packs all images of a directory into texture atlases, see jngl::loadAtlas
+
+#include "../AtlasManifest.hpp"
+#include "../ImageDecoder.hpp"
+#include "AtlasPacker.hpp"
+#include "QoiEncoder.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+/// In the order ImageDecoder::load prefers them. KTX files aren't packed, since they are already
+/// in a format which can be uploaded as is.
+const char* const EXTENSIONS[] = {
+	".qoi",
+#ifndef NOWEBP
+	".webp",
+#endif
+#ifndef NOPNG
+	".png",
+#endif
+	".bmp"
+};
+
+struct Options {
+	fs::path input;
+	fs::path output;
+	int maxSize = 2048;
+	int padding = 2;
+	double scale = 1;
+};
+
+void printUsage() {
+	std::cerr << "Usage: jngl-bake [--max-size 2048] [--padding 2] [--scale 1] <input directory> "
+	             "<output directory>\n\n"
+	             "Packs all images in <input directory> into texture atlases and writes them as\n"
+	             "QOI files together with manifest.txt to <output directory>. Load them using\n"
+	             "jngl::loadAtlas(\"<output directory>/manifest.txt\").\n";
+}
+
+Options parseArgs(const int argc, char** argv) {
+	Options options;
+	std::vector<std::string> positional;
+	for (int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--max-size" || arg == "--padding" || arg == "--scale") {
+			if (++i == argc) {
+				throw std::runtime_error("Missing value for " + arg);
+			}
+			const std::string value = argv[i];
+			if (arg == "--max-size") {
+				options.maxSize = std::stoi(value);
+			} else if (arg == "--padding") {
+				options.padding = std::stoi(value);
+			} else {
+				options.scale = std::stod(value);
+			}
+		} else if (!arg.empty() && arg[0] == '-') {
+			throw std::runtime_error("Unknown option " + arg);
+		} else {
+			positional.push_back(arg);
+		}
+	}
+	if (positional.size() != 2 || options.maxSize <= 0 || options.padding < 0 ||
+	    options.scale <= 0) {
+		printUsage();
+		throw std::runtime_error("Invalid arguments.");
+	}
+	options.input = positional[0];
+	options.output = positional[1];
+	return options;
+}
+
+/// Paths relative to \a directory without extension, sorted and without resolution variants
+std::set<std::string> findImages(const fs::path& directory) {
+	std::set<std::string> names;
+	for (const auto& entry : fs::recursive_directory_iterator(directory)) {
+		if (!entry.is_regular_file()) {
+			continue;
+		}
+		const auto extension = entry.path().extension().string();
+		if (std::none_of(std::begin(EXTENSIONS), std::end(EXTENSIONS),
+		                 [&extension](const char* e) { return extension == e; })) {
+			continue;
+		}
+		auto name = fs::relative(entry.path(), directory).replace_extension().generic_string();
+		if (name.ends_with("@0.5x") || name.ends_with("@2x")) {
+			continue; // picked by ImageDecoder::load depending on --scale
+		}
+		names.emplace(std::move(name));
+	}
+	return names;
+}
+
+/// Copies \a image into \a page and repeats its outermost pixels into the padding, so that linear
+/// filtering doesn't blend in the neighbours
+void blit(const std::vector<uint8_t>& image, const jngl::bake::Size size,
+          std::vector<uint8_t>& page, const int pageWidth, const jngl::bake::Placement placement,
+          const int padding) {
+	for (int y = -padding; y < size.height + padding; ++y) {
+		const int sourceY = std::clamp(y, 0, size.height - 1);
+		for (int x = -padding; x < size.width + padding; ++x) {
+			const int sourceX = std::clamp(x, 0, size.width - 1);
+			const auto source = (static_cast<std::size_t>(sourceY) * size.width + sourceX) * 4;
+			const auto target =
+			    (static_cast<std::size_t>(placement.y + y) * pageWidth + placement.x + x) * 4;
+			std::copy_n(&image[source], 4, &page[target]);
+		}
+	}
+}
+
+void writeFile(const fs::path& path, const char* data, const std::size_t size) {
+	std::ofstream file(path, std::ios::binary);
+	file.write(data, static_cast<std::streamsize>(size));
+	if (!file) {
+		throw std::runtime_error("Couldn't write " + path.string());
+	}
+}
+
+void bake(const Options& options) {
+	std::vector<std::vector<uint8_t>> images;
+	std::vector<jngl::bake::Size> sizes;
+	jngl::AtlasManifest manifest;
+	for (const auto& name : findImages(options.input)) {
+		const auto stem = (options.input / name).generic_string();
+		const char* const* extension =
+		    std::find_if(std::begin(EXTENSIONS), std::end(EXTENSIONS),
+		                 [&stem](const char* e) { return fs::exists(stem + e); });
+		const auto decoder = jngl::ImageDecoder::load(stem + *extension, options.scale);
+		const jngl::bake::Size size{ decoder->getWidth(), decoder->getHeight() };
+		std::vector<uint8_t> pixels(static_cast<std::size_t>(size.width) * size.height * 4);
+		decoder->decode(pixels.data(), static_cast<std::size_t>(size.width) * 4, true);
+		images.emplace_back(std::move(pixels));
+		sizes.push_back(size);
+		manifest.regions.push_back(jngl::AtlasManifest::Region{
+		    0, 0, 0, size.width, size.height, decoder->getImageWidth(), decoder->getImageHeight(),
+		    name });
+	}
+
+	const auto atlas = jngl::bake::packAtlas(sizes, options.maxSize, options.padding);
+	std::vector<std::vector<uint8_t>> pages;
+	for (std::size_t i = 0; i < atlas.pages.size(); ++i) {
+		const auto& pageSize = atlas.pages[i];
+		pages.emplace_back(static_cast<std::size_t>(pageSize.width) * pageSize.height * 4, 0);
+		manifest.pages.push_back(jngl::AtlasManifest::Page{
+		    pageSize.width, pageSize.height, "atlas" + std::to_string(i) + ".qoi" });
+	}
+	for (std::size_t i = 0; i < images.size(); ++i) {
+		const auto& placement = atlas.placements[i];
+		blit(images[i], sizes[i], pages[placement.page], atlas.pages[placement.page].width,
+		     placement, options.padding);
+		auto& region = manifest.regions[i];
+		region.page = placement.page;
+		region.x = placement.x;
+		region.y = placement.y;
+	}
+
+	fs::create_directories(options.output);
+	for (std::size_t i = 0; i < pages.size(); ++i) {
+		const auto qoi = jngl::bake::encodeQoi(pages[i].data(), atlas.pages[i].width,
+		                                       atlas.pages[i].height);
+		writeFile(options.output / manifest.pages[i].filename,
+		          reinterpret_cast<const char*>(qoi.data()), qoi.size()); // NOLINT
+	}
+	std::ostringstream sstream;
+	manifest.write(sstream);
+	const auto text = sstream.str();
+	writeFile(options.output / "manifest.txt", text.data(), text.size());
+	std::cout << "Packed " << images.size() << " images into " << pages.size() << " pages."
+	          << std::endl;
+}
+
+} // namespace
+
+int main(const int argc, char** argv) {
+	try {
+		bake(parseArgs(argc, argv));
+	} catch (const std::exception& e) {
+		std::cerr << "jngl-bake: " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
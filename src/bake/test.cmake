@@ -0,0 +1,20 @@
+# Bakes INPUT twice and checks that the results are identical, so that baked atlases can be diffed
+foreach(RUN a b)
+	file(REMOVE_RECURSE ${OUTPUT}/${RUN})
+	execute_process(COMMAND ${BAKE} ${INPUT} ${OUTPUT}/${RUN} RESULT_VARIABLE RESULT)
+	if(NOT RESULT EQUAL 0)
+		message(FATAL_ERROR "jngl-bake failed: ${RESULT}")
+	endif()
+endforeach()
+file(GLOB FILES RELATIVE ${OUTPUT}/a ${OUTPUT}/a/*)
+list(LENGTH FILES COUNT)
+if(COUNT LESS 2)
+	message(FATAL_ERROR "Expected the manifest and at least one page, got: ${FILES}")
+endif()
+foreach(FILE ${FILES})
+	execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files ${OUTPUT}/a/${FILE}
+		${OUTPUT}/b/${FILE} RESULT_VARIABLE RESULT)
+	if(NOT RESULT EQUAL 0)
+		message(FATAL_ERROR "${FILE} differs between two runs")
+	endif()
+endforeach()
@@ -0,0 +1,70 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+/// Compares loading the same image from QOI and PNG, including reading the file
+///
+/// On Linux every iteration reads the file from disk instead of the page cache. Elsewhere only the
+/// first load is cold, so "average" mostly measures decoding.
+
+#include "../ImageDecoder.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+/// Drops the file's pages from the OS cache so that the next read has to hit the disk. Returns
+/// false if that isn't supported.
+bool evictFromPageCache(const std::string& filename) {
+#ifdef __linux__
+	const int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0) {
+		return false;
+	}
+	fdatasync(fd);
+	const bool evicted = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(fd);
+	return evicted;
+#else
+	(void)filename;
+	return false;
+#endif
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	constexpr int ITERATIONS = 50;
+	const std::vector<std::string> files =
+	    argc > 1 ? std::vector<std::string>(argv + 1, argv + argc)
+	             : std::vector<std::string>{ "jngl.qoi", "jngl.png" };
+
+	for (const auto& filename : files) {
+		std::vector<uint8_t> pixels;
+		double first = 0;
+		double total = 0;
+		bool cold = true;
+		for (int i = 0; i < ITERATIONS; ++i) {
+			cold = evictFromPageCache(filename) && cold; // not part of the measurement
+			const auto iterationStart = std::chrono::steady_clock::now();
+			const auto decoder = jngl::ImageDecoder::load(filename, 1);
+			const std::size_t stride = decoder->alignedStride(false);
+			pixels.resize(stride * static_cast<std::size_t>(decoder->getHeight()));
+			decoder->decode(pixels.data(), stride, false);
+			const std::chrono::duration<double, std::milli> duration =
+			    std::chrono::steady_clock::now() - iterationStart;
+			total += duration.count();
+			if (i == 0) {
+				first = duration.count();
+			}
+		}
+		std::cout << filename << ": first load " << first << " ms, average "
+		          << total / ITERATIONS << " ms" << (cold ? "" : " (warm page cache)") << " ("
+		          << int(pixels[pixels.size() / 2]) << ")\n";
+	}
+}
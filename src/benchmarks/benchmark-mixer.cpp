@@ -0,0 +1,73 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+/// Renders a mixing graph with many voices offline and prints how long each block took
+///
+/// Usage: benchmark-mixer [voices] [output.wav]
+
+#include "../audio/OfflineRenderer.hpp"
+#include "../audio/constants.hpp"
+#include "../audio/effect/pitch.hpp"
+#include "../audio/effect/volume.hpp"
+#include "../audio/mixer.hpp"
+
+#include <iostream>
+#include <string>
+
+namespace {
+
+/// Endless sawtooth wave, cheap to generate so that mostly the mixing graph gets measured
+class Sawtooth : public jngl::Stream {
+public:
+	explicit Sawtooth(float hz) : step(hz / jngl::audio::frequency) {
+	}
+	std::size_t read(float* data, std::size_t sample_count) override {
+		for (std::size_t i = 0; i < sample_count; i += 2) {
+			data[i] = data[i + 1] = 0.1f * (2 * phase - 1);
+			phase += step;
+			if (phase >= 1) {
+				phase -= 1;
+			}
+		}
+		return sample_count;
+	}
+	void rewind() override {
+		phase = 0;
+	}
+	bool isPlaying() const override {
+		return true;
+	}
+
+private:
+	float step;
+	float phase = 0;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+	using namespace jngl::audio;
+	const int voices = argc > 1 ? std::stoi(argv[1]) : 200;
+	auto mixer = std::make_shared<jngl::Mixer>();
+	for (int i = 0; i < voices; ++i) {
+		// every voice gets resampled, like a streamed file at another sample rate would be
+		mixer->add(volume(pitch(std::make_shared<Sawtooth>(110.f + i), 1.f + 0.01f * (i % 10)),
+		                  i % 4 == 0 ? 0.f : 1.f),
+		           i % 3);
+	}
+	auto output = volume(pitch(mixer));
+	OfflineRenderer renderer(output);
+
+	std::vector<float> samples;
+	const auto statistics = renderer.render(60 * frequency, argc > 2 ? &samples : nullptr);
+	const auto us = [](auto duration) {
+		return std::chrono::duration<double, std::micro>(duration).count();
+	};
+	std::cout << voices << " voices, " << statistics.blocks << " blocks of 256 frames\n"
+	          << "min: " << us(statistics.min) << " µs, average: "
+	          << us(statistics.total) / statistics.blocks << " µs, p99: " << us(statistics.p99)
+	          << " µs, max: " << us(statistics.max) << " µs\n"
+	          << statistics.realtimeFactor() << "x realtime\n";
+	if (argc > 2) {
+		writeWav(argv[2], samples);
+	}
+}
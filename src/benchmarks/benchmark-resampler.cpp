@@ -0,0 +1,54 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+/// Compares the throughput of the polyphase resampler to plain linear interpolation
+
+#include "../audio/Resampler.hpp"
+#include "../audio/kernels.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main() {
+	using namespace jngl::audio;
+	constexpr std::size_t FRAMES = 1024;
+	constexpr int ITERATIONS = 20000;
+	constexpr double RATIO = 22050. / 44100.;
+
+	std::mt19937 gen(42); // NOLINT
+	std::uniform_real_distribution<float> dist(-1.f, 1.f);
+	std::vector<float> src((FRAMES + Resampler::TAPS) * 2);
+	for (auto& s : src) { s = dist(gen); }
+	std::vector<std::uint32_t> index(FRAMES);
+	std::vector<float> frac(FRAMES);
+	for (std::size_t i = 0; i < FRAMES; ++i) {
+		const double position = i * RATIO;
+		index[i] = static_cast<std::uint32_t>(position) + Resampler::FRAMES_BEFORE;
+		frac[i] = static_cast<float>(position - static_cast<std::uint32_t>(position));
+	}
+	std::vector<float> dst(FRAMES * 2);
+
+	auto measure = [&](const char* name, auto&& function) {
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < ITERATIONS; ++i) {
+			function();
+		}
+		const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+		// frames per second divided by 44.1 kHz: how many realtime streams one core can handle
+		std::cout << name << ": " << FRAMES * ITERATIONS / seconds.count() / 44100.
+		          << "x realtime (" << dst[0] << ")\n";
+	};
+
+	for (const auto* kernel : available_kernels()) {
+		std::cout << kernel->name << '\n';
+		measure("  lerp", [&] {
+			kernel->lerp_stereo(dst.data(), src.data(), index.data(), frac.data(), FRAMES);
+		});
+	}
+	const Resampler resampler;
+	std::cout << kernels().name << '\n';
+	measure("  polyphase", [&] {
+		resampler.process(dst.data(), src.data(), index.data(), frac.data(), FRAMES);
+	});
+}
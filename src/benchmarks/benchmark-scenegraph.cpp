@@ -0,0 +1,62 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+/// Compares SceneGraph::update with recomputing all world matrices every frame
+
+#include "../jngl/Pixels.hpp"
+#include "../jngl/SceneGraph.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+int main() {
+	constexpr std::size_t NODES = 10000;
+	constexpr int ITERATIONS = 1000;
+
+	std::mt19937 gen(42); // NOLINT
+	std::uniform_real_distribution<float> dist(-100.f, 100.f);
+	jngl::SceneGraph scene;
+	std::vector<jngl::SceneGraph::Node> nodes{ jngl::SceneGraph::ROOT };
+	std::vector<std::size_t> parents{ 0 };
+	for (std::size_t i = 1; i < NODES; ++i) {
+		// random tree in which most nodes are several levels deep
+		parents.push_back(std::uniform_int_distribution<std::size_t>(i > 100 ? i - 100 : 0,
+		                                                             i - 1)(gen));
+		nodes.push_back(scene.add(
+		    nodes[parents.back()],
+		    jngl::Mat3().translate(jngl::Pixels(dist(gen)), jngl::Pixels(dist(gen))).rotate(0.1f)));
+	}
+	scene.update();
+
+	auto measure = [&](const char* name, auto&& function) {
+		std::size_t recomputed = 0;
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < ITERATIONS; ++i) {
+			function(i);
+			scene.update();
+			recomputed += scene.getRecomputed();
+		}
+		const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+		std::cout << name << ": " << seconds.count() * 1e6 / ITERATIONS << " µs per frame, "
+		          << recomputed / ITERATIONS << " of " << scene.size() << " matrices recomputed ("
+		          << scene.getWorld(nodes.back()).data[6] << ")\n";
+	};
+
+	measure("static", [](int) {});
+	measure("one leaf moves", [&](const int i) {
+		scene.setLocal(nodes.back(), jngl::Mat3().translate(jngl::Pixels(i), jngl::Pixels(0)));
+	});
+	measure("everything moves", [&](const int i) {
+		scene.setLocal(jngl::SceneGraph::ROOT,
+		               jngl::Mat3().translate(jngl::Pixels(i), jngl::Pixels(0)));
+	});
+	std::vector<jngl::Mat3> flat(NODES);
+	measure("without cache", [&](int) {
+		// what pushMatrix/translate/popMatrix amounts to: every matrix every frame
+		for (std::size_t i = 1; i < NODES; ++i) {
+			flat[i] = flat[parents[i]];
+			flat[i] *= scene.getLocal(nodes[i]);
+		}
+	});
+}
@@ -0,0 +1,64 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+
+#include "culling.hpp"
+
+#include "jngl/other.hpp"
+#include "opengl.hpp"
+
+#include <cmath>
+
+namespace jngl {
+
+namespace {
+
+bool gCulling = true;
+CullingStatistics gCullingStatistics;
+
+} // namespace
+
+void setCulling(const bool enabled) {
+	gCulling = enabled;
+}
+
+bool getCulling() {
+	return gCulling;
+}
+
+CullingStatistics getCullingStatistics() {
+	return gCullingStatistics;
+}
+
+bool cull(const Mat3& modelview, const Vec2 topLeft, const Vec2 bottomRight) {
+	if (!gCulling) {
+		++gCullingStatistics.drawn;
+		return false;
+	}
+	// Instead of transforming all four corners, transform the center and get the half extents of
+	// the bounding box from the absolute values of the matrix:
+	const float* const m = modelview.data;
+	const auto centerX = static_cast<float>(topLeft.x + bottomRight.x) / 2.f;
+	const auto centerY = static_cast<float>(topLeft.y + bottomRight.y) / 2.f;
+	const auto halfWidth = std::abs(static_cast<float>(bottomRight.x - topLeft.x)) / 2.f;
+	const auto halfHeight = std::abs(static_cast<float>(bottomRight.y - topLeft.y)) / 2.f;
+	const float x = m[0] * centerX + m[3] * centerY + m[6];
+	const float y = m[1] * centerX + m[4] * centerY + m[7];
+	const float extentX = std::abs(m[0]) * halfWidth + std::abs(m[3]) * halfHeight;
+	const float extentY = std::abs(m[1]) * halfWidth + std::abs(m[4]) * halfHeight;
+
+	// The projection only scales and translates, the viewport is [-1, 1] in clip space:
+	const float* const p = opengl::projection.data;
+	const float clipX = p[0] * x + p[12];
+	const float clipY = p[5] * y + p[13];
+	const float clipExtentX = std::abs(p[0]) * extentX;
+	const float clipExtentY = std::abs(p[5]) * extentY;
+	if (clipX - clipExtentX > 1.f || clipX + clipExtentX < -1.f || clipY - clipExtentY > 1.f ||
+	    clipY + clipExtentY < -1.f) {
+		++gCullingStatistics.culled;
+		return true;
+	}
+	++gCullingStatistics.drawn;
+	return false;
+}
+
+} // namespace jngl
@@ -0,0 +1,18 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+
+#pragma once
+
+#include "jngl/Mat3.hpp"
+#include "jngl/Vec2.hpp"
+
+namespace jngl {
+
+/// Returns whether the rectangle from \a topLeft to \a bottomRight, transformed by \a modelview
+/// and opengl::projection, lies entirely outside of the viewport
+///
+/// Always returns false if culling has been disabled using setCulling. Counts the result in the
+/// CullingStatistics.
+bool cull(const Mat3& modelview, Vec2 topLeft, Vec2 bottomRight);
+
+} // namespace jngl
@@ -11,6 +11,8 @@
 #include "android/fopen.hpp"
 #endif
 
+#include <cstring>
+
 namespace jngl {
 
 std::vector<std::string> splitlines(const std::string& text) {
@@ -70,4 +72,58 @@ std::string sanitizePath(std::string path) {
 	return path;
 }
 
+uint64_t hash64(const void* const data, const std::size_t size, const uint64_t seed) {
+	constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87;
+	constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4F;
+	constexpr uint64_t PRIME3 = 0x165667B19E3779F9;
+	constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63;
+	constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5;
+	const auto rotl = [](const uint64_t x, const int r) { return (x << r) | (x >> (64 - r)); };
+	const auto round = [rotl](uint64_t acc, const uint64_t input) {
+		acc += input * PRIME2;
+		return rotl(acc, 31) * PRIME1;
+	};
+	const auto read64 = [](const uint8_t* p) {
+		uint64_t value;
+		std::memcpy(&value, p, sizeof(value)); // little endian, like our targets
+		return value;
+	};
+	const auto* p = static_cast<const uint8_t*>(data);
+	const uint8_t* const end = p + size;
+	uint64_t h;
+	if (size >= 32) {
+		uint64_t v[4] = { seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1 };
+		for (; end - p >= 32; p += 32) {
+			for (int i = 0; i < 4; ++i) {
+				v[i] = round(v[i], read64(p + 8 * i));
+			}
+		}
+		h = rotl(v[0], 1) + rotl(v[1], 7) + rotl(v[2], 12) + rotl(v[3], 18);
+		for (const uint64_t lane : v) {
+			h = (h ^ round(0, lane)) * PRIME1 + PRIME4;
+		}
+	} else {
+		h = seed + PRIME5;
+	}
+	h += size;
+	for (; end - p >= 8; p += 8) {
+		h = rotl(h ^ round(0, read64(p)), 27) * PRIME1 + PRIME4;
+	}
+	if (end - p >= 4) {
+		uint32_t value;
+		std::memcpy(&value, p, sizeof(value));
+		h = rotl(h ^ (value * PRIME1), 23) * PRIME2 + PRIME3;
+		p += 4;
+	}
+	for (; p < end; ++p) {
+		h = rotl(h ^ (*p * PRIME5), 11) * PRIME1;
+	}
+	h ^= h >> 33;
+	h *= PRIME2;
+	h ^= h >> 29;
+	h *= PRIME3;
+	h ^= h >> 32;
+	return h;
+}
+
 } // namespace jngl
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -21,4 +22,7 @@ bool fileExists(const std::string& path);
 /// ././/././foo.bar => foo.bar
 std::string sanitizePath(std::string);
 
+/// Fast non-cryptographic 64 bit hash, same result as XXH64 from https://xxhash.com
+uint64_t hash64(const void* data, std::size_t size, uint64_t seed = 0);
+
 } // namespace jngl
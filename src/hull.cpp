@@ -0,0 +1,141 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "hull.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace jngl {
+
+namespace {
+
+double cross(const Vec2 a, const Vec2 b) {
+	return a.x * b.y - a.y * b.x;
+}
+
+/// Cross product of the vectors from \a origin to \a a and \a b, positive for a left turn
+double cross(const Vec2 origin, const Vec2 a, const Vec2 b) {
+	return cross(Vec2(a.x - origin.x, a.y - origin.y), Vec2(b.x - origin.x, b.y - origin.y));
+}
+
+/// Andrew's monotone chain algorithm, drops duplicate and collinear points
+std::vector<Vec2> convexHull(std::vector<Vec2> points) {
+	std::sort(points.begin(), points.end(), [](const Vec2 a, const Vec2 b) {
+		return a.x < b.x || (a.x == b.x && a.y < b.y);
+	});
+	if (points.size() < 3) {
+		return points;
+	}
+	std::vector<Vec2> hull(2 * points.size());
+	std::size_t k = 0;
+	for (const Vec2 point : points) { // lower half
+		while (k >= 2 && cross(hull[k - 2], hull[k - 1], point) <= 0) {
+			--k;
+		}
+		hull[k++] = point;
+	}
+	const std::size_t lowerSize = k + 1;
+	for (auto it = points.rbegin() + 1; it != points.rend(); ++it) { // upper half
+		while (k >= lowerSize && cross(hull[k - 2], hull[k - 1], *it) <= 0) {
+			--k;
+		}
+		hull[k++] = *it;
+	}
+	hull.resize(k - 1); // the last point is the same as the first one
+	return hull;
+}
+
+/// Removes corners until there are only \a maxVertices left. Each step replaces one edge by
+/// extending its two neighbouring edges until they meet, so that the polygon only grows. The
+/// edge which adds the least area and keeps the polygon inside \a width x \a height is chosen.
+bool simplify(std::vector<Vec2>& hull, const std::size_t maxVertices, const double width,
+              const double height) {
+	constexpr double EPSILON = 1e-6;
+	while (hull.size() > maxVertices) {
+		const std::size_t n = hull.size();
+		double bestArea = std::numeric_limits<double>::infinity();
+		std::size_t best = 0;
+		Vec2 bestCorner;
+		for (std::size_t i = 0; i < n; ++i) {
+			const Vec2 previous = hull[(i + n - 1) % n];
+			const Vec2 a = hull[i];
+			const Vec2 b = hull[(i + 1) % n];
+			const Vec2 next = hull[(i + 2) % n];
+			const Vec2 d1(a.x - previous.x, a.y - previous.y);
+			const Vec2 d2(next.x - b.x, next.y - b.y);
+			const double denominator = cross(d1, d2);
+			if (denominator <= EPSILON) {
+				continue; // the neighbouring edges don't meet in front of this one
+			}
+			const double t = cross(Vec2(b.x - a.x, b.y - a.y), d2) / denominator;
+			const Vec2 corner(a.x + t * d1.x, a.y + t * d1.y);
+			if (corner.x < -EPSILON || corner.y < -EPSILON || corner.x > width + EPSILON ||
+			    corner.y > height + EPSILON) {
+				continue;
+			}
+			const double area = std::abs(cross(a, corner, b)) / 2;
+			if (area < bestArea) {
+				bestArea = area;
+				best = i;
+				bestCorner = corner;
+			}
+		}
+		if (bestArea == std::numeric_limits<double>::infinity()) {
+			return false;
+		}
+		hull[best] = Vec2(std::clamp(bestCorner.x, 0., width),
+		                  std::clamp(bestCorner.y, 0., height));
+		hull.erase(hull.begin() + static_cast<std::ptrdiff_t>((best + 1) % n));
+	}
+	return true;
+}
+
+} // namespace
+
+std::vector<Vec2> alphaHull(const uint8_t* const rgba, const int width, const int height,
+                            const std::size_t stride, const std::size_t maxVertices) {
+	const double w = width;
+	const double h = height;
+	std::vector<Vec2> points;
+	for (int y = 0; y < height; ++y) {
+		const uint8_t* const row = rgba + static_cast<std::size_t>(y) * stride;
+		int left = 0;
+		while (left < width && row[left * 4 + 3] == 0) {
+			++left;
+		}
+		if (left == width) {
+			continue;
+		}
+		int right = width - 1;
+		while (row[right * 4 + 3] == 0) {
+			--right;
+		}
+		// Texels influence everything within half a texel around their pixel when filtered:
+		const double x0 = std::max(0., left - 0.5);
+		const double x1 = std::min(w, right + 1.5);
+		const double y0 = std::max(0., y - 0.5);
+		const double y1 = std::min(h, y + 1.5);
+		points.insert(points.end(), { Vec2(x0, y0), Vec2(x0, y1), Vec2(x1, y0), Vec2(x1, y1) });
+	}
+	auto hull = convexHull(std::move(points));
+	if (hull.size() < 3 || !simplify(hull, maxVertices, w, h) ||
+	    polygonArea(hull) > w * h * 0.95) {
+		return {};
+	}
+	for (auto& corner : hull) {
+		corner.x /= w;
+		corner.y /= h;
+	}
+	return hull;
+}
+
+double polygonArea(const std::vector<Vec2>& polygon) {
+	double area = 0;
+	for (std::size_t i = 0; i < polygon.size(); ++i) {
+		area += cross(polygon[i], polygon[(i + 1) % polygon.size()]);
+	}
+	return area / 2;
+}
+
+} // namespace jngl
@@ -0,0 +1,28 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+
+#pragma once
+
+#include "jngl/Vec2.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace jngl {
+
+/// Convex polygon with at most \a maxVertices corners which contains every pixel that isn't fully
+/// transparent, including the half texel around them that linear filtering blends in
+///
+/// \a rgba has \a height rows of \a width pixels, each row starting \a stride bytes after the
+/// previous one. The corners are returned in texture coordinates, i.e. from (0, 0) to (1, 1), and
+/// in the order which makes polygonArea() positive. Returns an empty vector if the polygon
+/// wouldn't be noticeably smaller than the whole image or can't be reduced to \a maxVertices
+/// corners.
+std::vector<Vec2> alphaHull(const uint8_t* rgba, int width, int height, std::size_t stride,
+                            std::size_t maxVertices = 8);
+
+/// Area of a simple polygon (shoelace formula), negative if the corners are in reverse order
+double polygonArea(const std::vector<Vec2>&);
+
+} // namespace jngl
@@ -19,6 +19,7 @@
 #include "jngl/Rgb.hpp"
 #include "jngl/Rgba.hpp"
 #include "jngl/ScaleablePixels.hpp"
+#include "jngl/SceneGraph.hpp"
 #include "jngl/Shader.hpp"
 #include "jngl/ShaderProgram.hpp"
 #include "jngl/Singleton.hpp"
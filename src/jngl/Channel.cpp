@@ -18,17 +18,17 @@ struct Channel::Impl {
 };
 
 Channel::Channel() : impl(std::make_unique<Impl>()) {
-	auto mixer = std::make_shared<Mixer>();
+	auto mixer = std::make_shared<Mixer>(Audio::handle().getClock());
 	impl->mixer = mixer.get();
 	auto volumeControl = audio::volume(mixer);
 	impl->volumeControl = volumeControl.get();
 	impl->pauseControl = audio::pause(std::move(volumeControl));
-	Audio::handle().registerChannel(impl->pauseControl);
+	Audio::handle().registerChannel(impl->pauseControl, *mixer);
 }
 
 Channel::~Channel() {
 	if (auto audio = Audio::handleIfAlive()) {
-		audio->unregisterChannel(*impl->pauseControl);
+		audio->unregisterChannel(*impl->pauseControl, *impl->mixer);
 	}
 }
 
@@ -69,12 +69,12 @@ Channel& Channel::main() {
 	return Audio::handle().getMainChannel();
 }
 
-void Channel::add(std::shared_ptr<Stream> stream) {
-	impl->mixer->add(std::move(stream));
+void Channel::add(std::shared_ptr<Stream> stream, int priority, std::int64_t start) {
+	impl->mixer->add(std::move(stream), priority, start);
 }
 
-void Channel::remove(const Stream* stream) {
-	impl->mixer->remove(stream);
+void Channel::remove(const Stream* stream, std::int64_t stop) {
+	impl->mixer->remove(stream, stop);
 }
 
 } // namespace jngl
@@ -5,6 +5,7 @@
 
 #include "Finally.hpp"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -86,9 +87,9 @@ public:
 	static Channel& main();
 
 	/// Internal function for now
-	void add(std::shared_ptr<Stream>);
+	void add(std::shared_ptr<Stream>, int priority = 0, std::int64_t start = 0);
 	/// Internal function for now
-	void remove(const Stream*);
+	void remove(const Stream*, std::int64_t stop = 0);
 
 private:
 	struct Impl;
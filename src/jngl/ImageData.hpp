@@ -14,10 +14,12 @@ class ImageData {
 public:
 	/// Passing a filename will load the specified \a filename
 	///
-	/// PNG and WebP files are supported.
+	/// QOI, PNG, WebP and BMP (24 bit, uncompressed) files are supported.
 	///
-	/// \a scaleHint might be completely ignored, compare getImageWidth with getWidth after loading
-	/// to check.
+	/// If resolution variants exist next to the file (e.g. foo@0.5x.png, foo@2x.png) the one
+	/// matching \a scaleHint best gets loaded. Images are scaled down while decoding when
+	/// \a scaleHint is smaller than the picked variant, but never scaled up. Compare getImageWidth
+	/// with getWidth after loading to check.
 	static std::unique_ptr<ImageData> load(const std::string& filename, double scaleHint = 1.);
 
 	virtual ~ImageData() = default;
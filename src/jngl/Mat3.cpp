@@ -6,7 +6,60 @@
 #include "Vec2.hpp"
 #include "screen.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JNGL_MAT3_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define JNGL_MAT3_NEON
+#include <arm_neon.h>
+#endif
+
 namespace jngl {
+
+namespace {
+
+// Each of these multiplies m from the right with a matrix whose last row is (0, 0, 1), so only the
+// columns which actually change are computed. Translations are computed in double precision like
+// before.
+
+void translateBy(Mat3& m, const double x, const double y) {
+	for (int row = 0; row < 3; ++row) {
+		m.data[6 + row] =
+		    static_cast<float>(m.data[row] * x + m.data[3 + row] * y + m.data[6 + row]);
+	}
+}
+
+/// Bit-identical to transformBatch, see -ffp-contract=off in CMakeLists.txt
+void transformScalar(const float* const parent, const Mat3Batch& children, Mat3Batch& out,
+                     const std::size_t begin) {
+	const float pa = parent[0];
+	const float pb = parent[1];
+	const float pc = parent[3];
+	const float pd = parent[4];
+	const float pe = parent[6];
+	const float pf = parent[7];
+	for (std::size_t i = begin; i < children.size(); ++i) {
+		const float a = children.a[i];
+		const float b = children.b[i];
+		const float c = children.c[i];
+		const float d = children.d[i];
+		const float e = children.e[i];
+		const float f = children.f[i];
+		out.a[i] = pa * a + pc * b;
+		out.b[i] = pb * a + pd * b;
+		out.c[i] = pa * c + pc * d;
+		out.d[i] = pb * c + pd * d;
+		out.e[i] = (pa * e + pc * f) + pe;
+		out.f[i] = (pb * e + pd * f) + pf;
+	}
+}
+
+} // namespace
+
 Mat3::Mat3(std::initializer_list<float> elements) {
 	int row = 0;
 	int column = 0;
@@ -21,13 +74,13 @@ Mat3::Mat3(std::initializer_list<float> elements) {
 }
 
 Mat3& Mat3::translate(const jngl::Vec2& v) {
-	return *this *= boost::qvm::translation_mat(
-	           boost::qvm::vec<double, 2>{ { v.x * getScaleFactor(), v.y * getScaleFactor() } });
+	translateBy(*this, v.x * getScaleFactor(), v.y * getScaleFactor());
+	return *this;
 }
 
 Mat3& Mat3::translate(const Pixels x, const Pixels y) {
-	return *this *= boost::qvm::translation_mat(
-	           boost::qvm::vec<double, 2>{ { static_cast<float>(x), static_cast<float>(y) } });
+	translateBy(*this, static_cast<float>(x), static_cast<float>(y));
+	return *this;
 }
 
 Mat3& Mat3::scale(const float factor) {
@@ -35,12 +88,139 @@ Mat3& Mat3::scale(const float factor) {
 }
 
 Mat3& Mat3::scale(const float xfactor, const float yfactor) {
-	return *this *= boost::qvm::diag_mat(boost::qvm::vec<float, 3>{ { xfactor, yfactor, 1 } });
+	for (int row = 0; row < 3; ++row) {
+		data[row] *= xfactor;
+		data[3 + row] *= yfactor;
+	}
+	return *this;
 }
 
 Mat3& Mat3::rotate(const float radian) {
-	boost::qvm::rotate_z(*this, radian);
+	const float c = std::cos(radian);
+	const float s = std::sin(radian);
+	for (int row = 0; row < 3; ++row) {
+		const float x = data[row];
+		const float y = data[3 + row];
+		data[row] = x * c + y * s;
+		data[3 + row] = x * -s + y * c;
+	}
 	return *this;
 }
 
+Mat3& Mat3::operator*=(const Mat3& other) {
+	const float* const o = other.data;
+	if (other.isAffine()) {
+		for (int row = 0; row < 3; ++row) {
+			const float x = data[row];
+			const float y = data[3 + row];
+			data[row] = x * o[0] + y * o[1];
+			data[3 + row] = x * o[3] + y * o[4];
+			data[6 + row] = (x * o[6] + y * o[7]) + data[6 + row];
+		}
+		return *this;
+	}
+	float result[9];
+	for (int column = 0; column < 3; ++column) {
+		for (int row = 0; row < 3; ++row) {
+			result[column * 3 + row] = data[row] * o[column * 3] +
+			                           data[3 + row] * o[column * 3 + 1] +
+			                           data[6 + row] * o[column * 3 + 2];
+		}
+	}
+	std::copy(std::begin(result), std::end(result), data);
+	return *this;
+}
+
+bool Mat3::isAffine() const {
+	return data[2] == 0 && data[5] == 0 && data[8] == 1;
+}
+
+std::size_t Mat3Batch::size() const {
+	return a.size();
+}
+
+void Mat3Batch::resize(const std::size_t size) {
+	for (auto* element : { &a, &b, &c, &d, &e, &f }) {
+		element->resize(size);
+	}
+}
+
+void Mat3Batch::push_back(const Mat3& matrix) {
+	resize(size() + 1);
+	set(size() - 1, matrix);
+}
+
+void Mat3Batch::set(const std::size_t index, const Mat3& matrix) {
+	a[index] = matrix.data[0];
+	b[index] = matrix.data[1];
+	c[index] = matrix.data[3];
+	d[index] = matrix.data[4];
+	e[index] = matrix.data[6];
+	f[index] = matrix.data[7];
+}
+
+Mat3 Mat3Batch::operator[](const std::size_t index) const {
+	Mat3 matrix;
+	matrix.data[0] = a[index];
+	matrix.data[1] = b[index];
+	matrix.data[3] = c[index];
+	matrix.data[4] = d[index];
+	matrix.data[6] = e[index];
+	matrix.data[7] = f[index];
+	return matrix;
+}
+
+void transformBatch(const Mat3& parent, const Mat3Batch& children, Mat3Batch& out) {
+	assert(parent.isAffine());
+	out.resize(children.size());
+	std::size_t i = 0;
+#if defined(JNGL_MAT3_SSE2)
+	const __m128 pa = _mm_set1_ps(parent.data[0]);
+	const __m128 pb = _mm_set1_ps(parent.data[1]);
+	const __m128 pc = _mm_set1_ps(parent.data[3]);
+	const __m128 pd = _mm_set1_ps(parent.data[4]);
+	const __m128 pe = _mm_set1_ps(parent.data[6]);
+	const __m128 pf = _mm_set1_ps(parent.data[7]);
+	for (; i + 4 <= children.size(); i += 4) {
+		const __m128 a = _mm_loadu_ps(&children.a[i]);
+		const __m128 b = _mm_loadu_ps(&children.b[i]);
+		const __m128 c = _mm_loadu_ps(&children.c[i]);
+		const __m128 d = _mm_loadu_ps(&children.d[i]);
+		const __m128 e = _mm_loadu_ps(&children.e[i]);
+		const __m128 f = _mm_loadu_ps(&children.f[i]);
+		_mm_storeu_ps(&out.a[i], _mm_add_ps(_mm_mul_ps(pa, a), _mm_mul_ps(pc, b)));
+		_mm_storeu_ps(&out.b[i], _mm_add_ps(_mm_mul_ps(pb, a), _mm_mul_ps(pd, b)));
+		_mm_storeu_ps(&out.c[i], _mm_add_ps(_mm_mul_ps(pa, c), _mm_mul_ps(pc, d)));
+		_mm_storeu_ps(&out.d[i], _mm_add_ps(_mm_mul_ps(pb, c), _mm_mul_ps(pd, d)));
+		_mm_storeu_ps(&out.e[i],
+		              _mm_add_ps(_mm_add_ps(_mm_mul_ps(pa, e), _mm_mul_ps(pc, f)), pe));
+		_mm_storeu_ps(&out.f[i],
+		              _mm_add_ps(_mm_add_ps(_mm_mul_ps(pb, e), _mm_mul_ps(pd, f)), pf));
+	}
+#elif defined(JNGL_MAT3_NEON)
+	const float32x4_t pa = vdupq_n_f32(parent.data[0]);
+	const float32x4_t pb = vdupq_n_f32(parent.data[1]);
+	const float32x4_t pc = vdupq_n_f32(parent.data[3]);
+	const float32x4_t pd = vdupq_n_f32(parent.data[4]);
+	const float32x4_t pe = vdupq_n_f32(parent.data[6]);
+	const float32x4_t pf = vdupq_n_f32(parent.data[7]);
+	// vmulq + vaddq instead of vmlaq, which may be fused on AArch64
+	for (; i + 4 <= children.size(); i += 4) {
+		const float32x4_t a = vld1q_f32(&children.a[i]);
+		const float32x4_t b = vld1q_f32(&children.b[i]);
+		const float32x4_t c = vld1q_f32(&children.c[i]);
+		const float32x4_t d = vld1q_f32(&children.d[i]);
+		const float32x4_t e = vld1q_f32(&children.e[i]);
+		const float32x4_t f = vld1q_f32(&children.f[i]);
+		vst1q_f32(&out.a[i], vaddq_f32(vmulq_f32(pa, a), vmulq_f32(pc, b)));
+		vst1q_f32(&out.b[i], vaddq_f32(vmulq_f32(pb, a), vmulq_f32(pd, b)));
+		vst1q_f32(&out.c[i], vaddq_f32(vmulq_f32(pa, c), vmulq_f32(pc, d)));
+		vst1q_f32(&out.d[i], vaddq_f32(vmulq_f32(pb, c), vmulq_f32(pd, d)));
+		vst1q_f32(&out.e[i], vaddq_f32(vaddq_f32(vmulq_f32(pa, e), vmulq_f32(pc, f)), pe));
+		vst1q_f32(&out.f[i], vaddq_f32(vaddq_f32(vmulq_f32(pb, e), vmulq_f32(pd, f)), pf));
+	}
+#endif
+	transformScalar(parent.data, children, out, i);
+}
+
 } // namespace jngl
@@ -5,7 +5,9 @@
 #pragma once
 
 #include <boost/qvm_lite.hpp>
+#include <cstddef>
 #include <initializer_list>
+#include <vector>
 
 namespace jngl {
 
@@ -67,10 +69,65 @@ public:
 	/// \return *this
 	Mat3& rotate(float radian);
 
+	/// Multiplies the matrix with \a other from the right
+	///
+	/// If the last row of \a other is (0, 0, 1), which is the case for every combination of
+	/// translations, rotations and scalings, it only needs 18 instead of 27 multiplications.
+	///
+	/// \return *this
+	Mat3& operator*=(const Mat3& other);
+
+	/// Whether the last row is (0, 0, 1)
+	[[nodiscard]] bool isAffine() const;
+
 	/// column-major
 	float data[9] = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };
 };
 
+/// Many affine transformations, stored as one array per matrix element (structure of arrays)
+///
+/// Element i is the matrix
+/// \f[
+/// \left( \begin{array}{rrr}
+/// a_i & c_i & e_i \\ b_i & d_i & f_i \\ 0 & 0 & 1
+/// \end{array}\right)
+/// \f]
+///
+/// This layout allows transformBatch to process several matrices with each SIMD instruction.
+struct Mat3Batch {
+	std::vector<float> a, b, c, d, e, f;
+
+	[[nodiscard]] std::size_t size() const;
+	void resize(std::size_t);
+
+	/// Appends \a matrix, ignoring its last row
+	void push_back(const Mat3& matrix);
+
+	/// Overwrites element \a index with \a matrix, ignoring its last row
+	void set(std::size_t index, const Mat3& matrix);
+
+	[[nodiscard]] Mat3 operator[](std::size_t index) const;
+};
+
+/// Sets out[i] = parent * children[i] for every i, e.g. to place all children of a scene node
+///
+/// \a parent has to be affine (see Mat3::isAffine), its last row is ignored. Uses SSE2 or NEON
+/// when available, the results are bit-identical to Mat3::operator*= nevertheless. \a out may be
+/// the same object as \a children and gets resized to its size.
+///
+/// Example:
+/// \code
+/// jngl::Mat3Batch children;
+/// for (const auto& enemy : enemies) {
+///     children.push_back(jngl::Mat3().translate(enemy.position).rotate(enemy.angle));
+/// }
+/// jngl::transformBatch(jngl::modelview(), children, children);
+/// for (std::size_t i = 0; i < children.size(); ++i) {
+///     enemySprite.draw(children[i]);
+/// }
+/// \endcode
+void transformBatch(const Mat3& parent, const Mat3Batch& children, Mat3Batch& out);
+
 } // namespace jngl
 
 namespace boost::qvm {
@@ -0,0 +1,211 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include "SceneGraph.hpp"
+
+#include "../opengl.hpp"
+#include "Container.hpp"
+#include "matrix.hpp"
+#include "sprite.hpp"
+#include "text.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace jngl {
+
+namespace {
+
+constexpr auto REMOVED = std::numeric_limits<std::size_t>::max();
+
+uint32_t slotOf(const SceneGraph::Node node) {
+	return static_cast<uint32_t>(node);
+}
+
+/// Erases all elements for which \a removed is true while keeping the order of the others
+template <class Vector>
+void compact(Vector& vector, const std::vector<bool>& removed) {
+	std::size_t target = 0;
+	for (std::size_t i = 0; i < removed.size(); ++i) {
+		if (!removed[i]) {
+			vector[target++] = vector[i];
+		}
+	}
+	vector.resize(target);
+}
+
+} // namespace
+
+SceneGraph::SceneGraph()
+: indices{ 0 }, generations{ 0 }, handles{ ROOT }, parents{ 0 }, locals(1), worlds(1),
+  dirty{ false }, updatedIn{ 0 }, attachments(1) {
+}
+
+SceneGraph::Node SceneGraph::add(const Node parent, const Mat3& local) {
+	assert(local.isAffine());
+	const auto parentIndex = indexOf(parent);
+	uint32_t slot; // NOLINT
+	if (freeSlots.empty()) {
+		if (indices.size() > std::numeric_limits<uint32_t>::max()) {
+			throw std::length_error("Too many SceneGraph nodes.");
+		}
+		slot = static_cast<uint32_t>(indices.size());
+		indices.push_back(handles.size());
+		generations.push_back(0);
+	} else {
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+		indices[slot] = handles.size();
+	}
+	const Node handle = Node(generations[slot]) << 32 | slot;
+	// Appending keeps the order, since the parent already exists:
+	handles.push_back(handle);
+	parents.push_back(parentIndex);
+	locals.push_back(local);
+	worlds.emplace_back();
+	dirty.push_back(true);
+	updatedIn.push_back(0);
+	attachments.emplace_back();
+	firstDirty = std::min(firstDirty, handles.size() - 1);
+	return handle;
+}
+
+void SceneGraph::remove(const Node node) {
+	const auto first = indexOf(node);
+	if (first == indexOf(ROOT)) {
+		throw std::runtime_error("The root node of a SceneGraph can't be removed.");
+	}
+	// Descendants always come after their ancestors, so one pass finds all of them:
+	std::vector<bool> removed(handles.size(), false);
+	removed[first] = true;
+	for (std::size_t i = first + 1; i < handles.size(); ++i) {
+		removed[i] = removed[parents[i]];
+	}
+
+	std::vector<std::size_t> newIndices(handles.size(), REMOVED);
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < handles.size(); ++i) {
+		if (removed[i]) {
+			const auto slot = slotOf(handles[i]);
+			indices[slot] = REMOVED;
+			++generations[slot]; // invalidates handles[i]
+			freeSlots.push_back(slot);
+		} else {
+			newIndices[i] = count++;
+		}
+	}
+	for (auto& parent : parents) {
+		parent = newIndices[parent]; // REMOVED for removed nodes, which get erased anyway
+	}
+	compact(handles, removed);
+	compact(parents, removed);
+	compact(locals, removed);
+	compact(worlds, removed);
+	compact(dirty, removed);
+	compact(updatedIn, removed);
+	compact(attachments, removed);
+	for (std::size_t i = 0; i < handles.size(); ++i) {
+		indices[slotOf(handles[i])] = i;
+	}
+	// Dirty nodes after first have moved, the others are gone:
+	if (firstDirty >= first) {
+		const auto it = std::find(dirty.begin() + static_cast<std::ptrdiff_t>(first), dirty.end(),
+		                          uint8_t(true));
+		firstDirty = static_cast<std::size_t>(it - dirty.begin());
+	}
+}
+
+std::size_t SceneGraph::size() const {
+	return handles.size();
+}
+
+void SceneGraph::setLocal(const Node node, const Mat3& local) {
+	assert(local.isAffine());
+	const auto index = indexOf(node);
+	locals[index] = local;
+	dirty[index] = true;
+	firstDirty = std::min(firstDirty, index);
+}
+
+const Mat3& SceneGraph::getLocal(const Node node) const {
+	return locals[indexOf(node)];
+}
+
+const Mat3& SceneGraph::getWorld(const Node node) const {
+	return worlds[indexOf(node)];
+}
+
+void SceneGraph::attach(const Node node, const Sprite& sprite) {
+	attachments[indexOf(node)] = &sprite;
+}
+
+void SceneGraph::attach(const Node node, const Text& text) {
+	attachments[indexOf(node)] = &text;
+}
+
+void SceneGraph::attach(const Node node, const Container& container) {
+	attachments[indexOf(node)] = &container;
+}
+
+void SceneGraph::detach(const Node node) {
+	attachments[indexOf(node)] = std::monostate{};
+}
+
+void SceneGraph::update() {
+	recomputed = 0;
+	if (firstDirty == handles.size()) {
+		return;
+	}
+	++updateCount;
+	// A node has to be recomputed if its local transformation changed or its parent has been
+	// recomputed in this update. Since parents come first, the latter is already known:
+	for (std::size_t i = firstDirty; i < handles.size(); ++i) {
+		const auto parent = parents[i];
+		if (!dirty[i] && (i == 0 || updatedIn[parent] != updateCount)) {
+			continue;
+		}
+		worlds[i] = i == 0 ? Mat3() : worlds[parent];
+		worlds[i] *= locals[i];
+		dirty[i] = false;
+		updatedIn[i] = updateCount;
+		++recomputed;
+	}
+	firstDirty = handles.size();
+}
+
+std::size_t SceneGraph::getRecomputed() const {
+	return recomputed;
+}
+
+void SceneGraph::draw() const {
+	const auto parent = modelview();
+	for (std::size_t i = 0; i < handles.size(); ++i) {
+		if (std::holds_alternative<std::monostate>(attachments[i])) {
+			continue;
+		}
+		auto world = parent;
+		world *= worlds[i];
+		if (const auto sprite = std::get_if<const Sprite*>(&attachments[i])) {
+			(*sprite)->draw(world);
+		} else if (const auto text = std::get_if<const Text*>(&attachments[i])) {
+			(*text)->draw(world);
+		} else {
+			pushMatrix();
+			opengl::modelview = world;
+			std::get<const Container*>(attachments[i])->draw();
+			popMatrix();
+		}
+	}
+}
+
+std::size_t SceneGraph::indexOf(const Node node) const {
+	const auto slot = slotOf(node);
+	if (slot >= indices.size() || indices[slot] == REMOVED || generations[slot] != node >> 32) {
+		throw std::runtime_error("Invalid SceneGraph node " + std::to_string(node) + ".");
+	}
+	return indices[slot];
+}
+
+} // namespace jngl
@@ -0,0 +1,137 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+/// Contains jngl::SceneGraph class
+/// @file
+#pragma once
+
+#include "Mat3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+namespace jngl {
+
+class Container;
+class Sprite;
+class Text;
+
+/// Transform hierarchy which caches the world matrix of every node
+///
+/// Each node has a local transformation relative to its parent. update() only recomputes the world
+/// matrices of nodes whose local transformation changed and of their descendants, so a mostly
+/// static scene costs next to nothing per frame. Nodes are stored in flat arrays in which every
+/// parent comes before its children.
+///
+/// \code
+/// jngl::SceneGraph scene;
+/// const auto car = scene.add(jngl::SceneGraph::ROOT, jngl::Mat3().translate(position));
+/// scene.attach(car, carSprite);
+/// scene.attach(scene.add(car, jngl::Mat3().translate(frontWheelOffset)), wheelSprite);
+/// scene.attach(scene.add(car, jngl::Mat3().translate(backWheelOffset)), wheelSprite);
+///
+/// // in Work::step:
+/// scene.setLocal(car, jngl::Mat3().translate(position)); // moves the wheels too
+/// scene.update();
+///
+/// // in Work::draw:
+/// scene.draw();
+/// \endcode
+class SceneGraph {
+public:
+	/// Handle of a node, stays valid until the node gets removed
+	///
+	/// The lower 32 bits are a slot which gets reused after the node has been removed, the upper
+	/// 32 bits count how often that happened. Using the handle of a removed node therefore throws
+	/// instead of addressing whichever node got its slot.
+	using Node = std::uint64_t;
+
+	/// The node every other node descends from, can't be removed
+	static constexpr Node ROOT = 0;
+
+	SceneGraph();
+
+	/// Adds a child to \a parent and returns its handle
+	///
+	/// \a local has to be affine, see Mat3::isAffine.
+	Node add(Node parent, const Mat3& local = {});
+
+	/// Removes \a node together with all its descendants
+	///
+	/// Takes linear time in the number of nodes, since the arrays are compacted.
+	void remove(Node node);
+
+	/// Returns the number of nodes including ROOT
+	[[nodiscard]] std::size_t size() const;
+
+	/// Sets the transformation relative to the parent and marks \a node and its descendants dirty
+	///
+	/// \a local has to be affine, see Mat3::isAffine.
+	void setLocal(Node node, const Mat3& local);
+
+	[[nodiscard]] const Mat3& getLocal(Node node) const;
+
+	/// Returns the transformation relative to ROOT's parent, i.e. the product of all local
+	/// transformations from ROOT down to \a node, as of the last call to update()
+	[[nodiscard]] const Mat3& getWorld(Node node) const;
+
+	/// Draws \a sprite centered at \a node in draw(), replaces any previous attachment
+	///
+	/// \a sprite isn't copied and has to outlive the attachment.
+	void attach(Node node, const Sprite& sprite);
+
+	/// Draws \a text at its position relative to \a node in draw()
+	void attach(Node node, const Text& text);
+
+	/// Calls Container::draw with the ModelView matrix set to \a node's world matrix in draw()
+	void attach(Node node, const Container& container);
+
+	/// Removes the Sprite, Text or Container attached to \a node
+	void detach(Node node);
+
+	/// Recomputes the world matrices of all dirty nodes
+	///
+	/// Starts at the first dirty node in storage order and returns early if no node changed since
+	/// the last call.
+	void update();
+
+	/// Returns the number of world matrices which have been recomputed by the last update()
+	[[nodiscard]] std::size_t getRecomputed() const;
+
+	/// Draws all attachments in storage order (parents before their children, siblings in the
+	/// order they have been added) relative to jngl::modelview()
+	///
+	/// Call update() before, otherwise the world matrices of changed nodes are outdated.
+	void draw() const;
+
+private:
+	using Attachment = std::variant<std::monostate, const Sprite*, const Text*, const Container*>;
+
+	/// Index into the arrays below
+	[[nodiscard]] std::size_t indexOf(Node) const;
+
+	/// Slot of a Node -> index, SIZE_MAX for removed nodes
+	std::vector<std::size_t> indices;
+	/// Slot -> upper 32 bits of the Node currently using it
+	std::vector<uint32_t> generations;
+	std::vector<uint32_t> freeSlots;
+
+	// Structure of arrays, sorted so that every parent comes before its children:
+	std::vector<Node> handles;
+	std::vector<std::size_t> parents; //< index, ROOT is its own parent
+	std::vector<Mat3> locals;
+	std::vector<Mat3> worlds;
+	std::vector<uint8_t> dirty;      //< local transformation changed
+	std::vector<uint32_t> updatedIn; //< last update() in which the world matrix changed
+	std::vector<Attachment> attachments;
+
+	uint32_t updateCount = 0;
+
+	/// Index of the first dirty node, size() if there's none
+	std::size_t firstDirty = 1;
+
+	std::size_t recomputed = 0;
+};
+
+} // namespace jngl
@@ -5,6 +5,11 @@
 
 #include "../Sound.hpp"
 #include "../audio.hpp"
+#include "../audio/CallbackStatistics.hpp"
+#include "../audio/Resampler.hpp"
+#include "../audio/StreamingTrack.hpp"
+#include "../audio/SubmixWorkers.hpp"
+#include "../audio/Track.hpp"
 #include "../audio/constants.hpp"
 #include "../audio/effect/pitch.hpp"
 #include "../audio/effect/volume.hpp"
@@ -13,10 +18,12 @@
 #include "../log.hpp"
 #include "../main.hpp"
 #include "Channel.hpp"
+#include "sound.hpp"
 
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <stdexcept>
 #include <unordered_map>
 
@@ -29,25 +36,44 @@
 
 namespace jngl {
 
+namespace {
+std::atomic<std::chrono::milliseconds> streamingThreshold{ std::chrono::seconds(30) };
+AudioDeviceParameters deviceParameters; //< only used on the main thread
+} // namespace
+
 Audio::Audio()
 : mixer(std::make_shared<Mixer>()), pitchControl(audio::pitch(mixer)),
-  volumeControl(volume(pitchControl)), engine(volumeControl) {
+  volumeControl(volume(pitchControl)), engine(volumeControl, deviceParameters) {
+	const auto silence = std::make_shared<PcmBuffer>();
+	voices.reserve(VOICE_POOL_SIZE);
+	freeVoices.reserve(VOICE_POOL_SIZE);
+	busyVoices.reserve(VOICE_POOL_SIZE);
+	for (std::size_t i = 0; i < VOICE_POOL_SIZE; ++i) {
+		voices.emplace_back(std::make_shared<Sound>(silence));
+		freeVoices.push_back(VOICE_POOL_SIZE - 1 - i);
+	}
 }
 Audio::~Audio() = default;
 
-void Audio::play(Channel& channel, std::shared_ptr<Sound> sound) {
-	channel.add(sound->getStream());
-	sounds_.erase(std::remove_if(sounds_.begin(), sounds_.end(),
-	                             [](const auto& s) { return !s->isPlaying(); }),
-	              sounds_.end());
-	sounds_.emplace_back(std::move(sound));
+std::shared_ptr<Sound> Audio::newSound(std::shared_ptr<PcmBuffer> buffer) {
+	if (freeVoices.empty()) {
+		return std::make_shared<Sound>(std::move(buffer));
+	}
+	const auto index = freeVoices.back();
+	freeVoices.pop_back();
+	busyVoices.push_back(index);
+	voices[index]->reset(std::move(buffer));
+	return voices[index];
+}
+
+void Audio::play(Channel& channel, const std::shared_ptr<Sound>& sound, int priority,
+                 std::int64_t start) {
+	// The Mixer keeps the Sound alive until it has finished playing, see Sound::getStream
+	channel.add(sound->getStream(), priority, start);
 }
 
-void Audio::stop(Channel& channel, std::shared_ptr<Sound>& sound) {
-	channel.remove(sound->getStream().get());
-	if (auto i = std::find(sounds_.begin(), sounds_.end(), sound); i != sounds_.end()) {
-		sounds_.erase(i);
-	}
+void Audio::stop(Channel& channel, const std::shared_ptr<Sound>& sound, std::int64_t stop) {
+	channel.remove(sound->getStream().get(), stop);
 }
 
 void Audio::increasePauseDeviceCount() {
@@ -82,20 +108,74 @@ Channel& Audio::getMainChannel() {
 	return *mainChannel;
 }
 
-void Audio::registerChannel(std::shared_ptr<Stream> stream) {
+std::shared_ptr<const audio::SampleClock> Audio::getClock() const {
+	return mixer->clock();
+}
+
+void Audio::registerChannel(std::shared_ptr<Stream> stream, const Mixer& channelMixer) {
 	this->mixer->add(std::move(stream));
+	channelMixers.push_back(&channelMixer);
 }
 
-void Audio::unregisterChannel(const Stream& stream) {
+void Audio::unregisterChannel(const Stream& stream, const Mixer& channelMixer) {
 	mixer->remove(&stream);
+	std::erase(channelMixers, &channelMixer);
 }
 
 void Audio::step() {
 	engine.step();
+	for (std::size_t i = 0; i < busyVoices.size();) {
+		if (voices[busyVoices[i]].use_count() == 1) { // neither a Mixer nor a SoundFile uses it
+			freeVoices.push_back(busyVoices[i]);
+			busyVoices[i] = busyVoices.back();
+			busyVoices.pop_back();
+		} else {
+			++i;
+		}
+	}
+}
+
+audio::OfflineRenderer* Audio::getOfflineRenderer() {
+	return engine.offlineRenderer();
+}
+
+void Audio::setWorkerThreads(unsigned int count) {
+#ifndef __EMSCRIPTEN__ // no threads
+	if (workers || count == 0) {
+		return;
+	}
+	workers = std::make_unique<audio::SubmixWorkers>(count);
+	mixer->setWorkers(workers.get());
+#endif
+}
+
+void Audio::setDeviceParameters(const AudioDeviceParameters& parameters) {
+	engine.setParameters(parameters);
+}
+
+AudioStatistics Audio::getStatistics() const {
+	AudioStatistics statistics;
+	engine.statistics().snapshot(statistics);
+	for (const auto* channelMixer : channelMixers) {
+		statistics.activeVoices += channelMixer->activeStreamCount();
+		statistics.mixedVoices += channelMixer->mixedStreamCount();
+	}
+	return statistics;
 }
 
-SoundFile::SoundFile(const std::string& filename, std::launch)
-: buffer(std::make_shared<std::vector<float>>()) {
+SoundFile::SoundFile(const std::string& filename, std::launch policy)
+: buffer(std::make_shared<PcmBuffer>()) {
+#ifdef __EMSCRIPTEN__
+	policy = std::launch::deferred; // no threads
+#endif
+	// Read it now, decode() might run a lot later, e.g. with std::launch::deferred:
+	const auto threshold = streamingThreshold.load();
+	decodeFuture =
+	    std::async(policy, [this, filename, threshold]() { decode(filename, threshold); }).share();
+}
+
+void SoundFile::decode(const std::string& filename,
+                       [[maybe_unused]] const std::chrono::milliseconds threshold) {
 #ifdef _WIN32
 	FILE* const f = fopen(filename.c_str(), "rb");
 #else
@@ -119,10 +199,27 @@ SoundFile::SoundFile(const std::string& filename, std::launch)
 
 	const vorbis_info* const pInfo = ov_info(&oggFile, -1);
 
+#ifndef __EMSCRIPTEN__ // no threads to decode on
+	if (const auto frames = ov_pcm_total(&oggFile, -1); frames > 0) {
+		const std::chrono::milliseconds length{ frames * 1000 / pInfo->rate };
+		if (length > threshold) {
+			streamingFilename = filename;
+			length_ = length;
+			frames_ = frames * audio::frequency / pInfo->rate;
+			internal::debug("Streaming {} ({} Hz, {} channels)", filename, pInfo->rate,
+			                pInfo->channels);
+			return;
+		}
+	}
+#endif
+
+	// only keep the first two channels, mono files stay mono
+	const int channels = std::min(pInfo->channels, 2);
+	std::vector<float> decoded;
 	int bitStream;
 	while (true) {
-		float** buffer = nullptr;
-		auto samples_read = ov_read_float(&oggFile, &buffer, 1024, &bitStream);
+		float** pcm = nullptr;
+		auto samples_read = ov_read_float(&oggFile, &pcm, 1024, &bitStream);
 		if (samples_read == 0) {
 			break;
 		}
@@ -130,51 +227,31 @@ SoundFile::SoundFile(const std::string& filename, std::launch)
 			throw std::runtime_error("Error decoding OGG file (" + filename + ").");
 		}
 
-		size_t start = this->buffer->size();
-		this->buffer->resize(start + samples_read * 2);
-		for (std::size_t i = samples_read; i > 0;) {
-			i -= 1;
-			auto tmp = buffer[0][i];
-			(*this->buffer)[start + i * 2 + 0] = tmp;
-			(*this->buffer)[start + i * 2 + 1] = buffer[pInfo->channels == 1 ? 0 : 1][i];
+		const size_t start = decoded.size();
+		decoded.resize(start + samples_read * channels);
+		for (int c = 0; c < channels; ++c) {
+			for (long i = 0; i < samples_read; ++i) {
+				decoded[start + i * channels + c] = pcm[c][i];
+			}
 		}
 	}
 	if (pInfo->rate != jngl::audio::frequency) {
-		float resampleFactor =
-		    static_cast<float>(jngl::audio::frequency) / static_cast<float>(pInfo->rate);
-		auto newSize = static_cast<size_t>(static_cast<float>(buffer->size()) * resampleFactor);
-		if (newSize % 2 != 0) {
-			++newSize;
-		}
-		std::vector<float> resampledData(newSize);
-		for (size_t i = 0; i < newSize / 2; ++i) {
-			float originalIndex = static_cast<float>(i) / resampleFactor;
-			auto index = static_cast<size_t>(originalIndex);
-			float fraction = originalIndex - static_cast<float>(index);
-			{
-				size_t originalLeftIndex = index * 2;
-				const float b =
-				    (originalLeftIndex + 2 < buffer->size()) ? (*buffer)[originalLeftIndex + 2] : 0;
-				resampledData[i * 2] =
-				    (*buffer)[originalLeftIndex] * (1.0f - fraction) + b * fraction;
-			}
-			{
-				const size_t originalRightIndex = index * 2 + 1;
-				const float b = (originalRightIndex + 2 < buffer->size())
-				                    ? (*buffer)[originalRightIndex + 2]
-				                    : 0;
-				resampledData[i * 2 + 1] =
-				    (*buffer)[originalRightIndex] * (1.0f - fraction) + b * fraction;
-			}
-		}
-		(*buffer) = std::move(resampledData);
+		decoded = audio::Resampler::convert(decoded, channels, pInfo->rate, audio::frequency);
 	}
+	buffer->channels = channels;
+	buffer->samples.resize(decoded.size());
+	std::transform(decoded.begin(), decoded.end(), buffer->samples.begin(), [](float sample) {
+		return static_cast<std::int16_t>(
+		    std::lround(std::clamp(sample, -1.f, 1.f) * PcmBuffer::FULL_SCALE));
+	});
+	length_ = std::chrono::milliseconds{ buffer->frames() * 1000 / jngl::audio::frequency };
+	frames_ = static_cast<std::int64_t>(buffer->frames());
 
 	internal::debug("Decoded {} ({:.2f} MB, {})", filename,
-	                buffer->size() * sizeof(float) / 1024. / 1024.,
+	                buffer->samples.size() * sizeof(std::int16_t) / 1024. / 1024.,
 #if !defined(__APPLE__) /* FIXME: Remove when AppleClang's libc++ supports this C++20 feature */   \
     && defined(__GNUC__) && __GNUC__ > 13 // Ubuntu 22.04's GCC doesn't fully support C++20
-	                std::chrono::duration_cast<std::chrono::seconds>(length())
+	                std::chrono::duration_cast<std::chrono::seconds>(length_)
 #else
 	                "unknown length"
 #endif
@@ -183,12 +260,25 @@ SoundFile::SoundFile(const std::string& filename, std::launch)
 
 SoundFile::~SoundFile() = default;
 SoundFile::SoundFile(SoundFile&& other) noexcept {
-	other.load();
 	*this = std::move(other);
 }
 SoundFile& SoundFile::operator=(SoundFile&& other) noexcept {
+	// decode() writes to the members of the object it has been started for:
+	if (decodeFuture.valid()) {
+		decodeFuture.wait();
+	}
+	if (other.decodeFuture.valid()) {
+		other.decodeFuture.wait();
+	}
+	decodeFuture = std::move(other.decodeFuture);
 	sound_ = std::move(other.sound_);
 	buffer = std::move(other.buffer);
+	streamingFilename = std::move(other.streamingFilename);
+	length_ = other.length_;
+	frames_ = other.frames_;
+	priority = other.priority;
+	maxInstances = other.maxInstances;
+	instances = std::move(other.instances);
 	return *this;
 }
 
@@ -196,9 +286,46 @@ void SoundFile::play() {
 	play(Channel::main());
 }
 
+std::shared_ptr<Sound> SoundFile::makeSound() const {
+	if (streamingFilename.empty()) {
+		return Audio::handle().newSound(buffer);
+	}
+	return std::make_shared<Sound>(std::make_shared<StreamingTrack>(streamingFilename));
+}
+
 void SoundFile::play(Channel& channel) {
-	sound_ = std::make_shared<Sound>(buffer);
-	Audio::handle().play(channel, sound_);
+	play(channel, 0); // 0 is always in the past
+}
+
+void SoundFile::play(audio::TimePoint at) {
+	play(Channel::main(), at);
+}
+
+void SoundFile::play(Channel& channel, audio::TimePoint at) {
+	load();
+	limitInstances();
+	sound_ = makeSound();
+	start(channel, at);
+}
+
+void SoundFile::limitInstances() {
+	if (maxInstances == 0) {
+		return;
+	}
+	instances.erase(std::remove_if(instances.begin(), instances.end(),
+	                               [](const auto& instance) { return !instance.first->isPlaying(); }),
+	                instances.end());
+	while (instances.size() >= maxInstances) { // steal the oldest one
+		Audio::handle().stop(*instances.front().second, instances.front().first);
+		instances.erase(instances.begin());
+	}
+}
+
+void SoundFile::start(Channel& channel, audio::TimePoint at) {
+	Audio::handle().play(channel, sound_, priority, at);
+	if (maxInstances > 0) {
+		instances.emplace_back(sound_, &channel);
+	}
 }
 
 void SoundFile::stop() {
@@ -206,8 +333,21 @@ void SoundFile::stop() {
 }
 
 void SoundFile::stop(Channel& channel) {
+	stop(channel, 0);
+}
+
+void SoundFile::stop(audio::TimePoint at) {
+	stop(Channel::main(), at);
+}
+
+void SoundFile::stop(Channel& channel, audio::TimePoint at) {
 	if (sound_) {
-		Audio::handle().stop(channel, sound_);
+		Audio::handle().stop(channel, sound_, at);
+		if (auto it = std::find_if(instances.begin(), instances.end(),
+		                           [this](const auto& instance) { return instance.first == sound_; });
+		    it != instances.end()) {
+			instances.erase(it);
+		}
 		sound_.reset();
 	}
 }
@@ -227,9 +367,20 @@ void SoundFile::loop(Channel& channel) {
 	if (sound_ && sound_->isLooping()) {
 		return;
 	}
-	sound_ = std::make_shared<Sound>(buffer);
+	load();
+	limitInstances();
+	sound_ = makeSound();
 	sound_->loop();
-	Audio::handle().play(channel, sound_);
+	start(channel, 0);
+}
+
+void SoundFile::setPriority(int priority) {
+	this->priority = priority;
+}
+
+void SoundFile::setMaxInstances(std::size_t count) {
+	maxInstances = count;
+	instances.reserve(count);
 }
 
 void SoundFile::setVolume(float v) {
@@ -238,12 +389,35 @@ void SoundFile::setVolume(float v) {
 	}
 }
 
+void SoundFile::seek(std::chrono::milliseconds position) {
+	if (sound_) {
+		sound_->seek(position);
+	}
+}
+
+bool SoundFile::isStreaming() const {
+	waitForDecode();
+	return !streamingFilename.empty();
+}
+
 void SoundFile::load() {
+	waitForDecode();
+}
+
+void SoundFile::waitForDecode() const {
+	if (decodeFuture.valid()) {
+		decodeFuture.get(); // rethrows exceptions from decode()
+	}
 }
 
 std::chrono::milliseconds SoundFile::length() const {
-	return std::chrono::milliseconds{ buffer->size() * 1000 / jngl::audio::frequency /
-		                              2 /* stereo */ };
+	waitForDecode();
+	return length_;
+}
+
+std::int64_t SoundFile::lengthInFrames() const {
+	waitForDecode();
+	return frames_;
 }
 
 float SoundFile::progress() const {
@@ -282,6 +456,38 @@ std::shared_ptr<SoundFile> loop(const std::string& filename) {
 	return tmp;
 }
 
+void setStreamingThreshold(std::chrono::milliseconds threshold) {
+	streamingThreshold = threshold;
+}
+
+void setAudioWorkerThreads(unsigned int count) {
+	Audio::handle().setWorkerThreads(count);
+}
+
+void setAudioDeviceParameters(AudioDeviceParameters parameters) {
+	deviceParameters = parameters;
+	if (auto audio = Audio::handleIfAlive()) {
+		audio->setDeviceParameters(parameters);
+	}
+}
+
+AudioStatistics getAudioStatistics() {
+	if (auto audio = Audio::handleIfAlive()) {
+		return audio->getStatistics();
+	}
+	return {};
+}
+
+namespace audio {
+TimePoint now() {
+	return Audio::handle().getClock()->frames.load(std::memory_order_relaxed);
+}
+
+std::int64_t toFrames(std::chrono::duration<double> duration) {
+	return std::llround(duration.count() * frequency);
+}
+} // namespace audio
+
 void setPlaybackSpeed(float speed) {
 	Audio::handle().setPitch(speed);
 }
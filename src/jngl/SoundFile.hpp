@@ -4,9 +4,12 @@
 /// @file
 #pragma once
 
+#include "sound.hpp"
+
 #include <future>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #if defined(__has_include) && __has_include(<optional>)
 #include <optional>
@@ -20,6 +23,7 @@ namespace jngl {
 
 class Channel;
 class Sound;
+struct PcmBuffer;
 struct SoundParams;
 
 /// Sound loaded from an OGG file
@@ -31,7 +35,9 @@ public:
 	/// Load an OGG file called \a filename
 	///
 	/// Loading can either happen on its own thread (std::launch::async) or the first time you
-	/// try to play the file (std::launch::deferred).
+	/// try to play the file (std::launch::deferred). When loading several files asynchronously they
+	/// will be decoded in parallel. Playing a file which is still being decoded blocks until it's
+	/// finished.
 	///
 	/// \note
 	/// If the file doesn't exist this will not throw, but calling SoundFile::play, SoundFile::loop
@@ -49,6 +55,16 @@ public:
 	/// Play the sound once on the Channel
 	void play(Channel&);
 
+	/// Play the sound once, starting exactly at \a at
+	///
+	/// Sounds started at the same TimePoint stay in sync (e.g. the stems of a song) and a sound
+	/// started at the end of another one (i.e. its start + lengthInFrames()) continues it without a
+	/// gap.
+	void play(audio::TimePoint at);
+
+	/// Play the sound once on the Channel, starting exactly at \a at
+	void play(Channel&, audio::TimePoint at);
+
 	/// Stop the last started sound
 	void stop();
 
@@ -58,6 +74,12 @@ public:
 	///       instead of stop().
 	void stop(Channel&);
 
+	/// Stop the last started sound exactly at \a at, isPlaying() returns false right away
+	void stop(audio::TimePoint at);
+
+	/// Stop the last started sound of this SoundFile started on the Channel exactly at \a at
+	void stop(Channel&, audio::TimePoint at);
+
 	/// Whether the sound is still playing at least once
 	bool isPlaying();
 
@@ -68,21 +90,77 @@ public:
 	/// Set volume in [0, ∞]. Default is 1.0f
 	void setVolume(float v);
 
+	/// Sounds with a higher priority are mixed first, default is 0
+	///
+	/// When more than 64 sounds play on a Channel at once, the ones with the lowest priority and
+	/// then the quietest ones become virtual: They keep advancing, but aren't mixed anymore.
+	/// Applies to sounds started after calling this.
+	void setPriority(int);
+
+	/// Limit how many instances of this file can play at the same time, 0 means unlimited
+	///
+	/// When the limit is reached, play() and loop() stop the oldest instance first. The Channels
+	/// the instances have been started on must outlive them.
+	void setMaxInstances(std::size_t);
+
+	/// Continue the last started sound at \a position
+	void seek(std::chrono::milliseconds position);
+
+	/// Whether the file is decoded while playing instead of being loaded into memory
+	///
+	/// \sa jngl::setStreamingThreshold
+	bool isStreaming() const;
+
 	/// Block until the sound file has been fully decompressed and loaded
 	///
 	/// \throws std::runtime_error File not found or decoding errors
 	void load();
 
 	/// Returns the duration in ms
+	///
+	/// Blocks until the file has been loaded.
 	std::chrono::milliseconds length() const;
 
+	/// Returns the duration in frames of the audio clock, see audio::TimePoint
+	///
+	/// Blocks until the file has been loaded. Only exact for files which aren't streamed, as the
+	/// resampling of streamed files might add or drop a frame.
+	std::int64_t lengthInFrames() const;
+
 	/// Returns playing progress in [0, 1], can be used with length() to determine how much time
 	/// has passed
 	float progress() const;
 
 private:
+	/// Runs either on its own thread or deferred, see constructor
+	///
+	/// Files longer than \a threshold get streamed, see setStreamingThreshold.
+	void decode(const std::string& filename, std::chrono::milliseconds threshold);
+	void waitForDecode() const;
+	std::shared_ptr<Sound> makeSound() const;
+
+	/// Stops the oldest instances if there would be more than maxInstances otherwise
+	void limitInstances();
+
+	/// Adds sound_ to \a channel
+	void start(Channel& channel, audio::TimePoint at);
+
 	std::shared_ptr<Sound> sound_;
-	std::shared_ptr<std::vector<float>> buffer;
+	int priority = 0;
+	std::size_t maxInstances = 0;
+
+	/// Playing Sounds, only tracked when maxInstances > 0
+	std::vector<std::pair<std::shared_ptr<Sound>, Channel*>> instances;
+	std::shared_ptr<PcmBuffer> buffer;
+
+	/// only set if the file is streamed
+	std::string streamingFilename;
+	std::chrono::milliseconds length_{ 0 };
+	std::int64_t frames_ = 0;
+
+	/// has to be declared last, so that its destructor waits for decode() to finish before any
+	/// other member gets destroyed
+	std::shared_future<void> decodeFuture;
 };
 
 } // namespace jngl
@@ -4,13 +4,13 @@
 #include "Video.hpp"
 
 #include <atomic>
-#include <cstring>
-#include <mutex>
+#include <optional>
 #include <stdexcept>
 
 #ifdef JNGL_VIDEO
 
 #include "../audio.hpp"
+#include "../audio/RingBuffer.hpp"
 #include "../audio/constants.hpp"
 #include "../audio/effect/pitch.hpp"
 #include "../log.hpp"
@@ -33,7 +33,7 @@ public:
 	explicit Impl(const std::string& filename)
 	: decoder(THEORAPLAY_startDecodeFile((pathPrefix + filename).c_str(), BUFFER_SIZE,
 	                                     THEORAPLAY_VIDFMT_IYUV)),
-	  startTime(-getTime()) {
+	  startTime(getTime()) {
 		if (!decoder) {
 			throw std::runtime_error("Failed to start decoding " + filename + "!");
 		}
@@ -43,10 +43,14 @@ public:
 		}
 		timePerFrame = 1. / video->fps;
 		assert(timePerFrame > 0);
+		width = video->width;
+		height = video->height;
 
 		while (!audio) {
 			audio = THEORAPLAY_getAudio(decoder);
 		}
+		// the only allocation for audio, the mixer thread never waits for the main thread
+		audioBuffer.emplace(static_cast<std::size_t>(audio->freq) * 2 * AUDIO_BUFFER_SECONDS);
 	}
 
 	int getFrequency() const {
@@ -54,20 +58,22 @@ public:
 	}
 
 	void draw() {
+		THEORAPLAY_touch(decoder); // otherwise the decoder would pause when we hold a frame
 		if (!started()) {
-			const double timeBuffering = getTime() + startTime;
-			if (timeBuffering > 5 || THEORAPLAY_availableVideo(decoder) >= BUFFER_SIZE ||
+			const double timeBuffering = getTime() - startTime;
+			if (timeBuffering > 5 || THEORAPLAY_availableVideo(decoder) >= framesToBuffer ||
 			    THEORAPLAY_threadDone(decoder)) {
 				internal::debug("Buffering took {:.2f} seconds ({} frames).", timeBuffering,
 				                THEORAPLAY_availableVideo(decoder));
-				startTime = getTime();
+				startTime = getTime() - seekTarget;
+				playing.store(true, std::memory_order_release);
 			}
 		}
 		double now = getTime() - startTime;
 		if (started() && !video) {
 			video = THEORAPLAY_getVideo(decoder);
 		}
-		if (!shaderProgram || (video && static_cast<double>(video->playms) / 1000. <= now)) {
+		if (video && (!shaderProgram || static_cast<double>(video->playms) / 1000. <= now)) {
 			if (started() && now - static_cast<double>(video->playms) / 1000. >= timePerFrame) {
 				// Skip frames to catch up, but keep track of the last one in case we catch up to a
 				// series of dupe frames, which means we'd have to draw that final frame and then
@@ -205,21 +211,35 @@ public:
 				glEnableVertexAttribArray(texCoordAttrib);
 			}
 
+			// Upload through a pixel unpack buffer: glTexSubImage2D then returns right away and the
+			// driver copies the planes to the textures while the next frame gets decoded.
+			assert(video->width % 2 == 0 && video->height % 2 == 0);
+			const auto lumaSize = static_cast<size_t>(video->width) * video->height;
+			const auto frameSize = static_cast<GLsizeiptr>(lumaSize * 3 / 2);
+			if (pixelBuffer == 0) {
+				glGenBuffers(1, &pixelBuffer);
+			}
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+			// orphan the storage of the last frame, so that we don't have to wait until the GPU is
+			// done with it:
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, frameSize, nullptr, GL_STREAM_DRAW);
+			glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, frameSize, video->pixels);
+
 			glBindTexture(GL_TEXTURE_2D, textureY);
 			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, static_cast<GLsizei>(video->width),
 			                static_cast<GLsizei>(video->height), GL_RED, GL_UNSIGNED_BYTE,
-			                video->pixels);
+			                nullptr);
 
-			assert(video->width % 2 == 0 && video->height % 2 == 0);
 			glBindTexture(GL_TEXTURE_2D, textureU);
 			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, static_cast<GLsizei>(video->width / 2),
 			                static_cast<GLsizei>(video->height / 2), GL_RED, GL_UNSIGNED_BYTE,
-			                video->pixels + static_cast<size_t>(video->width) * video->height);
+			                reinterpret_cast<void*>(lumaSize)); // NOLINT
 
 			glBindTexture(GL_TEXTURE_2D, textureV);
 			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, static_cast<GLsizei>(video->width / 2),
 			                static_cast<GLsizei>(video->height / 2), GL_RED, GL_UNSIGNED_BYTE,
-			                video->pixels + std::lround(1.25 * video->width * video->height));
+			                reinterpret_cast<void*>(lumaSize + lumaSize / 4)); // NOLINT
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
 			THEORAPLAY_freeVideo(video);
 			video = nullptr;
@@ -228,8 +248,12 @@ public:
 			if (!audio) {
 				audio = THEORAPLAY_getAudio(decoder);
 			}
-			while (audio) {
-				queueAudio();
+			while (audio && queueAudio()) {
+			}
+			if (const auto count = underruns.load(std::memory_order_relaxed);
+			    count > reportedUnderruns) {
+				internal::warn("Audio buffer underrun! ({} in total)", count);
+				reportedUnderruns = count;
 			}
 		}
 		if (shaderProgram) {
@@ -254,8 +278,38 @@ public:
 		return THEORAPLAY_isDecoding(decoder);
 	}
 
+	void seek(const double seconds) {
+		if (!THEORAPLAY_seek(decoder, static_cast<unsigned int>(std::max(0., seconds) * 1000))) {
+			internal::warn("Seeking isn't supported for this video.");
+			return;
+		}
+		if (video) {
+			THEORAPLAY_freeVideo(video);
+			video = nullptr;
+		}
+		THEORAPLAY_freeAudio(audio);
+		audio = nullptr;
+		audioFramesQueued = 0;
+		discardAudioUntil.store(audioBuffer->written(), std::memory_order_release);
+
+		// Buffer again, but only briefly, the decoder just has to get from the keyframe to the
+		// target:
+		playing.store(false, std::memory_order_release);
+		startTime = getTime();
+		seekTarget = seconds;
+		framesToBuffer =
+		    std::min(BUFFER_SIZE, static_cast<unsigned int>(std::ceil(SEEK_BUFFER_SECONDS /
+		                                                              timePerFrame)));
+	}
+
 	~Impl() override {
+		// both are pooled by the decoder, so give them back before stopping it
+		THEORAPLAY_freeVideo(video);
+		THEORAPLAY_freeAudio(audio);
 		THEORAPLAY_stopDecode(decoder);
+		if (pixelBuffer != 0) {
+			glDeleteBuffers(1, &pixelBuffer);
+		}
 	}
 
 	Impl(const Impl&) = delete;
@@ -263,70 +317,104 @@ public:
 	Impl(Impl&&) = delete;
 	Impl& operator=(Impl&&) = delete;
 
-	[[nodiscard]] int getWidth() const { return gsl::narrow<int>(video->width); }
-	[[nodiscard]] int getHeight() const { return gsl::narrow<int>(video->height); }
+	[[nodiscard]] int getWidth() const { return gsl::narrow<int>(width); }
+	[[nodiscard]] int getHeight() const { return gsl::narrow<int>(height); }
 
 	std::atomic_bool removeFromMixer{ false };
 
+	/// Incremented by the mixer thread when there wasn't enough decoded audio
+	std::atomic<std::size_t> underruns{ 0 };
+
+	/// Incremented when the ring buffer was full and decoded audio had to wait for the next draw()
+	std::size_t overruns = 0;
+
 private:
+	/// Called by both threads, the mixer thread only reports underruns after buffering
 	[[nodiscard]] bool started() const {
-		return startTime > 0;
+		return playing.load(std::memory_order_acquire);
 	}
 
 	void rewind() override {
 		assert(false);
 	}
 
-	void queueAudio() {
-		{
-			std::scoped_lock lock(audioBufferMutex);
+	/// Writes the rest of the current audio packet to the ring buffer, returns false if it didn't
+	/// fit completely
+	bool queueAudio() {
+		// Both sides only ever write and read whole stereo frames and the capacity is a power of
+		// two, so there's always space for a whole number of frames.
+		const auto frames = static_cast<std::size_t>(audio->frames);
+		while (audioFramesQueued < frames) {
+			std::size_t written; // NOLINT
 			if (audio->channels == 1) {
-				for (int i = 0; i < audio->frames; ++i) {
-					audioBuffer.push_back(audio->samples[i]);
-					audioBuffer.push_back(audio->samples[i]);
+				float stereo[512];
+				const auto count = std::min(frames - audioFramesQueued, std::size(stereo) / 2);
+				for (std::size_t i = 0; i < count; ++i) {
+					stereo[2 * i] = stereo[2 * i + 1] = audio->samples[audioFramesQueued + i];
 				}
+				written = audioBuffer->write(stereo, count * 2) / 2;
 			} else {
 				assert(audio->channels == 2);
-				audioBuffer.insert(audioBuffer.end(), audio->samples,
-				                   audio->samples + static_cast<ptrdiff_t>(audio->frames * 2));
+				written = audioBuffer->write(audio->samples + 2 * audioFramesQueued,
+				                             (frames - audioFramesQueued) * 2) /
+				          2;
+			}
+			if (written == 0) {
+				++overruns;
+				return false;
 			}
+			audioFramesQueued += written;
 		}
 		THEORAPLAY_freeAudio(audio);
 		audio = THEORAPLAY_getAudio(decoder);
+		audioFramesQueued = 0;
+		return true;
 	}
 
-	std::size_t read(float * data, std::size_t sample_count) override {
+	std::size_t read(float* data, std::size_t sample_count) override {
 		if (removeFromMixer) {
 			return 0;
 		}
-		std::scoped_lock lock(audioBufferMutex);
-		if (audioBuffer.size() < sample_count) {
+		audioBuffer->discardUntil(discardAudioUntil.load(std::memory_order_acquire));
+		const auto count = audioBuffer->read(data, sample_count);
+		if (count < sample_count) {
 			if (!isPlaying()) {
-				return 0;
+				return count;
 			}
 			if (started()) {
-				internal::warn("Audio buffer underrun!");
+				underruns.fetch_add(1, std::memory_order_relaxed);
 			}
-			std::memset(data, 0, sample_count);
-			return sample_count;
+			std::fill(data + count, data + sample_count, 0.f);
 		}
-		const auto begin = audioBuffer.begin();
-		const auto end = begin + static_cast<long>(sample_count);
-		std::copy(begin, end, data);
-		audioBuffer.erase(begin, end);
 		return sample_count;
 	}
 
-	std::mutex audioBufferMutex;
-	std::vector<float> audioBuffer;
+	/// Interleaved stereo at the sample rate of the video, written on the main thread and read on
+	/// the mixer thread
+	std::optional<audio::RingBuffer<float>> audioBuffer;
+	constexpr static std::size_t AUDIO_BUFFER_SECONDS = 2;
+
+	/// Frames of the current audio packet which have already been written to audioBuffer
+	std::size_t audioFramesQueued = 0;
+
+	/// Set by seek(), audio in audioBuffer before this index belongs to the old position
+	std::atomic<std::uint64_t> discardAudioUntil{ 0 };
+
+	std::size_t reportedUnderruns = 0;
 
 	constexpr static unsigned int BUFFER_SIZE = 200;
+	constexpr static double SEEK_BUFFER_SECONDS = 0.25;
 
 	THEORAPLAY_Decoder* decoder;
 	const THEORAPLAY_VideoFrame* video = nullptr;
 	const THEORAPLAY_AudioPacket* audio = nullptr;
-	double startTime;
+	double startTime; //< when buffering started or, once playing, getTime() at 0 seconds
+	std::atomic_bool playing{ false };
+	double seekTarget = 0;                   //< position at which playback continues after buffering
+	unsigned int framesToBuffer = BUFFER_SIZE;
 	double timePerFrame;
+	unsigned int width;
+	unsigned int height;
 
 	std::unique_ptr<ShaderProgram> shaderProgram;
 	int modelviewUniform = -1;
@@ -335,6 +423,7 @@ private:
 	GLuint textureV = 0; // chrominance
 	GLuint vao = 0;
 	GLuint vertexBuffer = 0;
+	GLuint pixelBuffer = 0; //< GL_PIXEL_UNPACK_BUFFER for the YUV planes of the current frame
 };
 
 Video::Video(const std::string& filename) : impl(std::make_shared<Impl>(filename)) {
@@ -366,6 +455,22 @@ bool Video::finished() const {
 	return !impl->isPlaying();
 }
 
+void Video::seek(const double seconds) {
+	impl->seek(seconds);
+}
+
+void setVideoDecodeThreads(const unsigned int count) {
+	THEORAPLAY_setWorkerThreads(count);
+}
+
+std::size_t Video::getAudioUnderruns() const {
+	return impl->underruns.load(std::memory_order_relaxed);
+}
+
+std::size_t Video::getAudioOverruns() const {
+	return impl->overruns;
+}
+
 } // namespace jngl
 
 #else
@@ -389,6 +494,15 @@ int Video::getHeight() const { return -1; } // NOLINT
 
 bool Video::finished() const { return true; } // NOLINT
 
+void Video::seek(double) {
+}
+
+void setVideoDecodeThreads(unsigned int) {
+}
+
+std::size_t Video::getAudioUnderruns() const { return 0; } // NOLINT
+std::size_t Video::getAudioOverruns() const { return 0; } // NOLINT
+
 } // namespace jngl
 
 #endif
@@ -1,8 +1,9 @@
-// Copyright 2018-2023 Jan Niklas Hasse <jhasse@bixense.com>
+// Copyright 2018-2024 Jan Niklas Hasse <jhasse@bixense.com>
 // For conditions of distribution and use, see copyright notice in LICENSE.txt
 /// @file
 #pragma once
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -47,10 +48,32 @@ public:
 	/// Returns true when the video has reached the end
 	[[nodiscard]] bool finished() const;
 
+	/// Continues playback (video and audio) at \a seconds
+	///
+	/// The first call reads through the whole file once to find the keyframes, the result is
+	/// cached for the file name. After that only the frames from the nearest keyframe before
+	/// \a seconds have to be decoded. Seeking past the end finishes the video.
+	void seek(double seconds);
+
+	/// How often the audio thread didn't get enough decoded audio, each one is an audible gap
+	[[nodiscard]] std::size_t getAudioUnderruns() const;
+
+	/// How often decoded audio had to wait for the next draw() call because the audio buffer
+	/// (two seconds) was full. Harmless, but a sign that draw() isn't called regularly.
+	[[nodiscard]] std::size_t getAudioOverruns() const;
+
 private:
 	class Impl;
 
 	std::shared_ptr<Impl> impl;
 };
 
+/// Sets how many threads decode all Videos together, 2 by default
+///
+/// Each Video gets decoded ahead as far as its buffer allows, the one with the least buffered
+/// frames first. Videos which haven't been drawn for 100 ms stop decoding until they are drawn
+/// again, so off-screen videos don't take CPU time away from the visible ones. Threads which have
+/// already been started keep running, so call this before creating the first Video.
+void setVideoDecodeThreads(unsigned int count);
+
 } // namespace jngl
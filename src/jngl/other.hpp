@@ -4,6 +4,7 @@
 /// @file
 #pragma once
 
+#include <cstddef>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -68,6 +69,27 @@ void setVerticalSync(bool enabled);
 /// Returns whether V-SYNC is enabled. Many devices always enable V-SYNC with no way to turn it off.
 bool getVerticalSync();
 
+/// Toggles skipping Sprites, Texts, rectangles and ellipses which lie entirely outside of the
+/// window (or the FrameBuffer being drawn to) before any OpenGL call. Enabled by default.
+///
+/// The test is conservative, i.e. it never skips anything that would have been visible. Draws
+/// with a custom ShaderProgram aren't culled, because its vertex shader could move the geometry.
+void setCulling(bool enabled);
+
+/// Returns whether culling is enabled, see setCulling
+bool getCulling();
+
+/// How many draw calls have been skipped by culling, see getCullingStatistics
+struct CullingStatistics {
+	std::size_t drawn = 0;
+	std::size_t culled = 0;
+};
+
+/// Returns how many draw calls have been tested by culling in total
+///
+/// The values only grow, subtract the ones of the previous frame to get them per frame.
+CullingStatistics getCullingStatistics();
+
 /// Sets the icon for the window (Desktop-only)
 void setIcon(const std::string& filename);
 
@@ -3,6 +3,7 @@
 
 #include "shapes.hpp"
 
+#include "../culling.hpp"
 #include "../main.hpp"
 #include "../opengl.hpp"
 #include "../spriteimpl.hpp"
@@ -64,10 +65,12 @@ void drawEllipse(const Vec2 position, const float width, const float height,
 }
 
 void drawEllipse(Mat3 modelview, float width, float height, float startAngle) {
+	modelview.scale(static_cast<float>(getScaleFactor()), static_cast<float>(getScaleFactor()));
+	if (cull(modelview, Vec2(-width, -height), Vec2(width, height))) {
+		return;
+	}
 	glBindVertexArray(opengl::vaoStream);
-	auto tmp = useSimpleShaderProgram(
-	    modelview.scale(static_cast<float>(getScaleFactor()), static_cast<float>(getScaleFactor())),
-	    gShapeColor);
+	auto tmp = useSimpleShaderProgram(modelview, gShapeColor);
 	std::vector<float> vertexes;
 	vertexes.push_back(0.f);
 	vertexes.push_back(0.f);
@@ -101,10 +104,12 @@ void drawCircle(Mat3 modelview, const float radius, const Rgba color) {
 }
 
 void drawCircle(Mat3 modelview, const Rgba color) {
+	modelview.scale(static_cast<float>(getScaleFactor()), static_cast<float>(getScaleFactor()));
+	if (cull(modelview, Vec2(-1, -1), Vec2(1, 1))) {
+		return;
+	}
 	glBindVertexArray(opengl::vaoStream);
-	auto tmp = useSimpleShaderProgram(
-	    modelview.scale(static_cast<float>(getScaleFactor()), static_cast<float>(getScaleFactor())),
-	    color);
+	auto tmp = useSimpleShaderProgram(modelview, color);
 	// clang-format off
 	const static float vertexes[] = {
 		1.f, 0.f, 0.9951847f, 0.09801714f, 0.9807853f, 0.1950903f, 0.9569403f, 0.2902847f,
@@ -6,6 +6,8 @@
 
 #include "Finally.hpp"
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -13,6 +15,24 @@ namespace jngl {
 
 class SoundFile;
 
+namespace audio {
+/// Position on the audio clock in frames, i.e. in steps of 1/44100 seconds (1/48000 on the web)
+///
+/// The clock counts the frames the main mix has produced so far. Unlike jngl::getTime it advances
+/// exactly with the audio, so it can be used to line up sounds sample-accurately.
+using TimePoint = std::int64_t;
+
+/// Current position of the audio clock
+///
+/// The audio thread mixes about one buffer ahead of what's audible. Sounds scheduled in the past
+/// start as soon as possible, so to have them line up schedule them a bit into the future, e.g.
+/// audio::now() + audio::toFrames(std::chrono::milliseconds(50)).
+TimePoint now();
+
+/// Converts \a duration to a number of frames of the audio clock
+std::int64_t toFrames(std::chrono::duration<double> duration);
+} // namespace audio
+
 float getVolume();
 
 /// Play an OGG audio file once
@@ -38,6 +58,79 @@ bool isPlaying(const std::string& filename);
 /// a pointer to the same SoundFile.
 std::shared_ptr<SoundFile> loop(const std::string& filename);
 
+/// OGG files longer than \a threshold will be streamed from disk instead of being fully decoded
+///
+/// Streaming keeps only a fraction of a second of decoded audio in memory and starts playing
+/// instantly, which makes sense for music or ambience. Short sound effects should still be loaded
+/// completely, so that playing them doesn't need a decoder thread. Only affects files loaded after
+/// calling this. Default is 30 seconds, pass std::chrono::milliseconds::max() to never stream.
+void setStreamingThreshold(std::chrono::milliseconds threshold);
+
+/// Mix the Channels in parallel on \a count additional threads
+///
+/// Only worth it when lots of voices are spread over several Channels, e.g. when each Channel has
+/// its own effects. After each audio block the threads spin for 200 microseconds in case the next
+/// one follows quickly and then sleep until it arrives, so they cost little CPU time when nothing
+/// is playing. Can only be enabled once, default is 0 (mix everything on the audio thread).
+void setAudioWorkerThreads(unsigned int count);
+
+/// Requested configuration of the audio device, see setAudioDeviceParameters
+struct AudioDeviceParameters {
+	/// Frames the audio thread has to produce per callback
+	///
+	/// Smaller buffers mean less latency, but the audio thread has less time for each callback and
+	/// underruns (audible crackling) get more likely. 0 uses the default of 256 (2048 on the web).
+	/// Gets rounded up to the next power of two, at most 32768.
+	unsigned int bufferFrames = 0;
+
+	/// Sample rate of the device in Hz, 0 uses the rate JNGL mixes at (44100, 48000 on the web)
+	///
+	/// The mix itself always runs at the default rate and gets resampled when this differs.
+	int sampleRate = 0;
+};
+
+/// Reopens the audio device with new parameters, playback continues where it was
+///
+/// Only supported on desktop platforms and the web, ignored on Android and iOS. Can also be called
+/// before anything has been played, so that the device gets opened with these parameters right
+/// away.
+void setAudioDeviceParameters(AudioDeviceParameters);
+
+/// Measurements of the audio thread, see getAudioStatistics
+struct AudioStatistics {
+	/// How long it took to fill the buffer of the device, over the last few seconds
+	std::chrono::nanoseconds minCallback{ 0 };
+	std::chrono::nanoseconds averageCallback{ 0 };
+	std::chrono::nanoseconds p99Callback{ 0 };
+
+	/// Average callback duration relative to the time the device needs to play one buffer, values
+	/// near 1 mean that underruns are about to happen
+	float load = 0;
+
+	/// Number of callbacks which took longer than the device needed to play their buffer
+	///
+	/// Only an estimate of underruns: the backend isn't asked whether the device actually ran out
+	/// of samples, which also depends on how much it buffers on its own.
+	std::uint64_t lateCallbacks = 0;
+
+	/// Sounds which are currently playing, including virtual ones which are too quiet or have a
+	/// too low priority to be mixed
+	std::size_t activeVoices = 0;
+
+	/// Part of activeVoices which are actually mixed
+	std::size_t mixedVoices = 0;
+
+	/// Parameters the device has actually been opened with, 0 if there's no device
+	unsigned int bufferFrames = 0;
+	int sampleRate = 0;
+};
+
+/// Returns timings of the audio thread and the number of playing sounds
+///
+/// Doesn't lock or wait for the audio thread. Also shown by the performance overlay when JNGL has
+/// been compiled with JNGL_PERFORMANCE_OVERLAY defined.
+AudioStatistics getAudioStatistics();
+
 /// Set global pitch in (0.0f, ∞]. Default is 1.0f
 void setPlaybackSpeed(float speed);
 
@@ -1,42 +1,151 @@
 // Copyright 2012-2024 Jan Niklas Hasse <jhasse@bixense.com>
 // For conditions of distribution and use, see copyright notice in LICENSE.txt
 
-#ifndef NOPNG
-#include <png.h> // Include first, see https://bugs.launchpad.net/ubuntu/+source/libpng/+bug/218409
-#endif
-
 #include "sprite.hpp"
 
+#include "../ImageDecoder.hpp"
 #include "../TextureCache.hpp"
+#include "../culling.hpp"
 #include "../helper.hpp"
+#include "../hull.hpp"
 #include "../log.hpp"
 #include "../main.hpp"
 #include "../spriteimpl.hpp"
 #include "../texture.hpp"
 #include "../windowptr.hpp"
 #include "Alpha.hpp"
+#include "ImageData.hpp"
+#include "Pixels.hpp"
 #include "matrix.hpp"
+#include "message.hpp"
 #include "screen.hpp"
 
-#ifdef _WIN32
-#include "../win32/unicode.hpp"
-#endif
+#include <cmath>
+#include <cstddef>
+#include <tuple>
 
-#ifdef ANDROID
-#include "../android/fopen.hpp"
-#endif
+namespace jngl {
 
-#if __cplusplus < 202002L
-#include <boost/algorithm/string/predicate.hpp>
+namespace {
+
+/// Returns the OpenGL format for \a compressed if the GPU supports it, 0 otherwise
+GLenum supportedCompressedFormat(const ImageDecoder::Compressed& compressed) {
+	using Format = ImageDecoder::CompressedFormat;
+	switch (compressed.format) {
+		case Format::BC1:
+		case Format::BC1_ALPHA:
+		case Format::BC3: {
+			static const bool s3tc = opengl::hasExtension("texture_compression_s3tc");
+			if (!s3tc) {
+				return 0;
+			}
+			return compressed.format == Format::BC1       ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+			       : compressed.format == Format::BC1_ALPHA ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+			                                                : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		}
+		case Format::BC7: {
+#ifdef GLAD_GL
+			static const bool bptc =
+			    GLAD_GL_VERSION_4_2 || opengl::hasExtension("texture_compression_bptc");
+#else
+			static const bool bptc = opengl::hasExtension("texture_compression_bptc");
 #endif
-#include <cstddef>
-#include <cstring>
-#include <sstream>
-#ifndef NOWEBP
-#include "../ImageDataWebP.hpp"
+			return bptc ? GL_COMPRESSED_RGBA_BPTC_UNORM : 0;
+		}
+		case Format::ETC2_RGB:
+		case Format::ETC2_RGB_A1:
+		case Format::ETC2_RGBA: {
+#if defined(ANDROID) || defined(IOS)
+			const bool etc2 = true; // part of OpenGL ES 3.0
+#elif defined(GLAD_GL)
+			static const bool etc2 =
+			    GLAD_GL_VERSION_4_3 || opengl::hasExtension("ARB_ES3_compatibility");
+#else
+			static const bool etc2 = opengl::hasExtension("compressed_texture_etc");
 #endif
+			if (!etc2) {
+				return 0;
+			}
+			if (compressed.format == Format::ETC2_RGB_A1) {
+				return GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+			}
+			return compressed.format == Format::ETC2_RGB ? GL_COMPRESSED_RGB8_ETC2
+			                                             : GL_COMPRESSED_RGBA8_ETC2_EAC;
+		}
+		case Format::ASTC: {
+			static const bool astc = opengl::hasExtension("texture_compression_astc_ldr") ||
+			                         opengl::hasExtension("compressed_texture_astc");
+			// same order as the GL_COMPRESSED_RGBA_ASTC_*_KHR enums
+			constexpr static uint8_t BLOCK_SIZES[14][2] = {
+				{ 4, 4 },  { 5, 4 },  { 5, 5 },  { 6, 5 },   { 6, 6 },   { 8, 5 },   { 8, 6 },
+				{ 8, 8 },  { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 },
+			};
+			for (GLenum i = 0; astc && i < 14; ++i) {
+				if (BLOCK_SIZES[i][0] == compressed.blockWidth &&
+				    BLOCK_SIZES[i][1] == compressed.blockHeight) {
+					return GL_COMPRESSED_RGBA_ASTC_4x4_KHR + i;
+				}
+			}
+			return 0;
+		}
+	}
+	return 0;
+}
 
-namespace jngl {
+/// Uploads a page baked by jngl-bake and caches it as \a filename
+///
+/// Unlike Sprite(filename) this doesn't scale the page down by getScaleFactor(), since
+/// jngl-bake has already done that.
+std::shared_ptr<Texture> loadAtlasPage(const std::string& filename) {
+	const auto decoder = ImageDecoder::load(filename, 1);
+	const int width = decoder->getWidth();
+	const int height = decoder->getHeight();
+	std::shared_ptr<Texture> texture;
+	const auto* const compressed = decoder->getCompressed();
+	if (const GLenum compressedFormat = compressed ? supportedCompressedFormat(*compressed) : 0) {
+		texture = std::make_shared<Texture>(static_cast<float>(width), static_cast<float>(height),
+		                                    width, height, compressedFormat, compressed->data,
+		                                    static_cast<GLsizei>(compressed->size));
+	} else {
+		const std::size_t stride = decoder->alignedStride(true);
+		std::vector<uint8_t> pixels(stride * static_cast<std::size_t>(height));
+		decoder->decode(pixels.data(), stride, true);
+		texture = std::make_shared<Texture>(static_cast<float>(width), static_cast<float>(height),
+		                                    width, height, nullptr, GL_RGBA, pixels.data());
+	}
+	TextureCache::handle().insert(filename, texture);
+	return texture;
+}
+
+/// Reuses a texture with the same content if there is one, otherwise calls \a create
+template <class Create>
+std::shared_ptr<Texture> deduplicate(const uint64_t contentHash, const std::size_t bytes,
+                                     const std::string_view filename, Create create) {
+	auto& cache = TextureCache::handle();
+	if (auto texture = cache.find(contentHash, bytes)) {
+		internal::debug("Reusing identical texture for {} ({} bytes saved in total)", filename,
+		                cache.getBytesSaved());
+		return texture;
+	}
+	return create();
+}
+
+/// Adds the area \a texture covers when drawn with \a modelview to gSpriteStatistics
+void countPixels(const Texture& texture, const Mat3& modelview) {
+	const float scale =
+	    std::abs(modelview.data[0] * modelview.data[4] - modelview.data[1] * modelview.data[3]);
+	gSpriteStatistics.drawnPixels += texture.getArea() * scale;
+	gSpriteStatistics.rectanglePixels +=
+	    texture.getPreciseWidth() * texture.getPreciseHeight() * scale;
+}
+
+/// Whether \a texture would be invisible when drawn with \a modelview, see jngl::cull
+bool isOffscreen(const Texture& texture, const Mat3& modelview) {
+	return cull(modelview, Vec2(0, 0),
+	            Vec2(texture.getPreciseWidth(), texture.getPreciseHeight()));
+}
+
+} // namespace
 
 Sprite::Sprite(const ImageData& imageData, double scale, std::optional<std::string_view> filename) {
 	if (!pWindow) {
@@ -46,13 +155,30 @@ Sprite::Sprite(const ImageData& imageData, double scale, std::optional<std::stri
 	height = scale * imageData.getHeight();
 	texture = filename ? TextureCache::handle().get(*filename) : nullptr;
 	if (!texture) {
-		texture = std::make_shared<Texture>(
-		    static_cast<int>(std::lround(width)), static_cast<int>(std::lround(height)),
-		    imageData.getWidth(), imageData.getHeight(), nullptr, GL_RGBA, imageData.pixels());
+		const auto create = [&]() {
+			auto texture = std::make_shared<Texture>(
+			    static_cast<int>(std::lround(width)), static_cast<int>(std::lround(height)),
+			    imageData.getWidth(), imageData.getHeight(), nullptr, GL_RGBA, imageData.pixels());
+			if (gSpriteTrimming) {
+				texture->setHull(alphaHull(imageData.pixels(), imageData.getWidth(),
+				                           imageData.getHeight(),
+				                           static_cast<std::size_t>(imageData.getWidth()) * 4));
+			}
+			return texture;
+		};
 		setCenter(0, 0);
-		if (filename) {
-			TextureCache::handle().insert(*filename, texture);
+		if (!filename) {
+			texture = create();
+			return;
 		}
+		const std::size_t rowBytes = static_cast<std::size_t>(imageData.getWidth()) * 4;
+		const uint64_t contentHash = TextureCache::contentHash(
+		    static_cast<float>(std::lround(width)), static_cast<float>(std::lround(height)),
+		    imageData.getWidth(), imageData.getHeight(), GL_RGBA, gSpriteTrimming,
+		    imageData.pixels(), rowBytes, rowBytes,
+		    static_cast<std::size_t>(imageData.getHeight()));
+		texture = deduplicate(contentHash, rowBytes * imageData.getHeight(), *filename, create);
+		TextureCache::handle().insert(*filename, texture, contentHash);
 	}
 }
 
@@ -75,77 +201,109 @@ Sprite::Sprite(const std::string& filename, LoadType loadType)
 		return;
 	}
 	const bool halfLoad = (loadType == LoadType::HALF);
+	if (const AtlasRegion* atlasRegion = findAtlasRegion(filename)) {
+		const auto& region = atlasRegion->region;
+		width = static_cast<float>(region.imageWidth * getScaleFactor());
+		height = static_cast<float>(region.imageHeight * getScaleFactor());
+		setCenter(0, 0);
+		if (halfLoad && !pWindow) {
+			return;
+		}
+		auto page = TextureCache::handle().get(atlasRegion->page);
+		if (!page) {
+			page = loadAtlasPage(atlasRegion->page);
+		}
+		const auto pageWidth = static_cast<double>(atlasRegion->pageWidth);
+		const auto pageHeight = static_cast<double>(atlasRegion->pageHeight);
+		texture = std::make_shared<Texture>(
+		    width, height, std::move(page), Vec2(region.x / pageWidth, region.y / pageHeight),
+		    Vec2((region.x + region.width) / pageWidth, (region.y + region.height) / pageHeight));
+		TextureCache::handle().insert(filename, texture);
+		return;
+	}
 	if (!halfLoad) {
 		internal::debug("Creating sprite {}...", filename);
 	}
-	auto fullFilename = pathPrefix + filename;
-	const char* extensions[] = {
-#ifndef NOWEBP
-		".webp",
-#endif
-#ifndef NOPNG
-		".png",
-#endif
-		".bmp"
-	};
-	std::function<Finally(Sprite*, std::string, FILE*, bool)> functions[] = {
-#ifndef NOWEBP
-		&Sprite::LoadWebP,
-#endif
-#ifndef NOPNG
-		&Sprite::LoadPNG,
-#endif
-		&Sprite::LoadBMP
-	};
-	const size_t size = sizeof(extensions) / sizeof(extensions[0]);
-	std::function<Finally(Sprite*, std::string, FILE*, bool)> loadFunction;
-	for (size_t i = 0; i < size; ++i) {
-#if __cplusplus < 202002L
-		if (boost::algorithm::ends_with(fullFilename, extensions[i])) {
-#else
-		if (fullFilename.ends_with(extensions[i])) {
-#endif
-			loadFunction = functions[i];
-			break;
+	std::shared_ptr<ImageDecoder> decoder = ImageDecoder::load(filename, getScaleFactor());
+	width = static_cast<float>(decoder->getImageWidth() * getScaleFactor());
+	height = static_cast<float>(decoder->getImageHeight() * getScaleFactor());
+	setCenter(0, 0);
+	if (halfLoad && !pWindow) {
+		return; // only the size was needed
+	}
+	if (const auto* const compressed = decoder->getCompressed()) {
+		if (!pWindow) {
+			throw std::runtime_error("Window hasn't been created yet. (" + filename + ")");
 		}
-		std::string tmp = fullFilename + extensions[i];
-		if (fileExists(tmp)) {
-			fullFilename += extensions[i];
-			loadFunction = functions[i];
-			break;
+		// Upload without decoding, otherwise fall through to decoding to RGBA on the CPU:
+		if (const GLenum compressedFormat = supportedCompressedFormat(*compressed)) {
+			const uint64_t contentHash = TextureCache::contentHash(
+			    width, height, decoder->getWidth(), decoder->getHeight(), compressedFormat, false,
+			    compressed->data, compressed->size, compressed->size, 1);
+			texture = deduplicate(contentHash, compressed->size, filename, [&]() {
+				return std::make_shared<Texture>(width, height, decoder->getWidth(),
+				                                 decoder->getHeight(), compressedFormat,
+				                                 compressed->data,
+				                                 static_cast<GLsizei>(compressed->size));
+			});
+			TextureCache::handle().insert(filename, texture, contentHash);
+			return;
 		}
 	}
-	if (!loadFunction) {
-		std::ostringstream message;
-		message << "No suitable image file found for: " << fullFilename
-		        << "\nSupported file extensions: ";
-		for (size_t i = 0; i < size; ++i) {
-			if (i != 0) {
-				message << ", ";
-			}
-			message << extensions[i];
+	GLenum format = GL_RGBA;
+	switch (decoder->getFormat()) {
+		case ImageDecoder::Format::RGB:
+			format = GL_RGB;
+			break;
+		case ImageDecoder::Format::RGBA:
+			format = GL_RGBA;
+			break;
+		case ImageDecoder::Format::BGR:
+			format = GL_BGR;
+			break;
+	}
+	// Decodes in the native format into a single buffer that can be passed to glTexImage2D as is,
+	// hashes it for TextureCache::find and trims it if requested
+	auto decode = [decoder, format, preciseWidth = width, preciseHeight = height,
+	               trim = gSpriteTrimming && format == GL_RGBA]() {
+		const std::size_t stride = decoder->alignedStride(false);
+		const auto rows = static_cast<std::size_t>(decoder->getHeight());
+		std::shared_ptr<uint8_t[]> pixels(new uint8_t[stride * rows]);
+		decoder->decode(pixels.get(), stride, false);
+		const uint64_t contentHash = TextureCache::contentHash(
+		    preciseWidth, preciseHeight, decoder->getWidth(), decoder->getHeight(), format, trim,
+		    pixels.get(),
+		    decoder->getWidth() * ImageDecoder::bytesPerPixel(decoder->getFormat()), stride, rows);
+		std::vector<Vec2> hull;
+		if (trim) {
+			hull = alphaHull(pixels.get(), decoder->getWidth(), decoder->getHeight(), stride);
 		}
-		throw std::runtime_error(message.str());
+		return std::make_tuple(std::move(pixels), contentHash, std::move(hull));
+	};
+	if (loadType != LoadType::THREADED) {
+		const auto [pixels, contentHash, hull] = decode();
+		loadTexture(decoder->getWidth(), decoder->getHeight(), filename, halfLoad, format,
+		            pixels.get(), contentHash, hull);
+		return;
 	}
-#ifdef _WIN32
-	FILE* pFile = _wfopen(utf8ToUtf16(fullFilename).c_str(), L"rb");
+#ifdef __EMSCRIPTEN__
+	const auto policy = std::launch::deferred;
 #else
-	FILE* pFile = fopen(fullFilename.c_str(), "rb");
+	const auto policy = std::launch::async;
 #endif
-	if (pFile == nullptr) {
-		throw std::runtime_error(std::string("File not found: " + fullFilename));
-	}
-	auto loadTexture = std::make_shared<Finally>(loadFunction(this, filename, pFile, halfLoad));
-	loader = std::make_shared<Finally>([pFile, loadTexture, this]() mutable {
-		loadTexture.reset(); // call ~Finally
-		if (fclose(pFile) != 0) {
-			internal::warn("Error closing file: {}", strerror(errno));
+	loader = std::make_shared<Finally>([this, filename, format, decoder,
+	                                    decoded = std::async(policy, decode).share()]() {
+		// Runs in ~Finally on the thread waiting for the Sprite, so exceptions mustn't escape
+		try {
+			const auto& [pixels, contentHash, hull] = decoded.get();
+			loadTexture(decoder->getWidth(), decoder->getHeight(), filename, false, format,
+			            pixels.get(), contentHash, hull);
+		} catch (std::exception& e) {
+			errorMessage(e.what());
+			// Might destroy this. The next use of filename will try again and throw then.
+			uncacheSprite(filename, *this);
 		}
-		setCenter(0, 0);
 	});
-	if (loadType != LoadType::THREADED) {
-		loader.reset();
-	}
 }
 
 void Sprite::step() {
@@ -154,11 +312,16 @@ void Sprite::step() {
 void Sprite::draw() const {
 	pushMatrix();
 	opengl::translate(static_cast<float>(position.x), static_cast<float>(position.y));
+	if (isOffscreen(*texture, opengl::modelview)) {
+		popMatrix();
+		return;
+	}
 	auto context = Texture::textureShaderProgram->use();
 	glUniform4f(Texture::shaderSpriteColorUniform, gSpriteColor.getRed(), gSpriteColor.getGreen(),
 	            gSpriteColor.getBlue(), gSpriteColor.getAlpha());
 	glUniformMatrix3fv(Texture::modelviewUniform, 1, GL_FALSE, opengl::modelview.data);
 	texture->draw();
+	countPixels(*texture, opengl::modelview);
 	popMatrix();
 }
 
@@ -167,8 +330,10 @@ void Sprite::draw(Mat3 modelview, const ShaderProgram* const shaderProgram) cons
 }
 
 void Sprite::draw(Mat3 modelview, Alpha alpha, const ShaderProgram* const shaderProgram) const {
-	modelview *=
-	    boost::qvm::translation_mat(boost::qvm::vec<double, 2>({ -width / 2., -height / 2. }));
+	modelview.translate(Pixels(-width / 2.), Pixels(-height / 2.));
+	if (!shaderProgram && isOffscreen(*texture, modelview)) {
+		return;
+	}
 	auto context = shaderProgram ? shaderProgram->use() : Texture::textureShaderProgram->use();
 	if (shaderProgram) {
 		glUniformMatrix3fv(shaderProgram->getUniformLocation("modelview"), 1, GL_FALSE,
@@ -179,11 +344,16 @@ void Sprite::draw(Mat3 modelview, Alpha alpha, const ShaderProgram* const shader
 		glUniformMatrix3fv(Texture::modelviewUniform, 1, GL_FALSE, modelview.data);
 	}
 	texture->draw();
+	countPixels(*texture, modelview);
 }
 
 void Sprite::draw(const ShaderProgram* const shaderProgram) const {
 	pushMatrix();
 	opengl::translate(static_cast<float>(position.x), static_cast<float>(position.y));
+	if (!shaderProgram && isOffscreen(*texture, opengl::modelview)) {
+		popMatrix();
+		return;
+	}
 	auto context = shaderProgram ? shaderProgram->use() : Texture::textureShaderProgram->use();
 	if (shaderProgram) {
 		glUniformMatrix3fv(shaderProgram->getUniformLocation("modelview"), 1, GL_FALSE,
@@ -195,6 +365,7 @@ void Sprite::draw(const ShaderProgram* const shaderProgram) const {
 		glUniformMatrix3fv(Texture::modelviewUniform, 1, GL_FALSE, opengl::modelview.data);
 	}
 	texture->draw();
+	countPixels(*texture, opengl::modelview);
 	popMatrix();
 }
 
@@ -202,6 +373,8 @@ struct Sprite::Batch::Impl {
 	ShaderProgram::Context context;
 	jngl::Mat3 translation;
 	int modelviewUniform;
+	const Texture* texture;
+	bool culling; //< false for custom shader programs
 };
 
 Sprite::Batch::Batch(std::unique_ptr<Impl> impl) : impl(std::move(impl)) {
@@ -211,8 +384,12 @@ Sprite::Batch::~Batch() = default;
 
 void Sprite::Batch::draw(Mat3 modelview) const {
 	modelview *= impl->translation;
+	if (impl->culling && isOffscreen(*impl->texture, modelview)) {
+		return;
+	}
 	glUniformMatrix3fv(impl->modelviewUniform, 1, GL_FALSE, modelview.data);
-	glDrawArrays(GL_TRIANGLE_FAN, 0, 4); // see Texture::draw()
+	glDrawArrays(GL_TRIANGLE_FAN, 0, impl->texture->getVertexCount()); // see Texture::draw()
+	countPixels(*impl->texture, modelview);
 }
 
 auto Sprite::batch(const ShaderProgram* const shaderProgram) const -> Batch {
@@ -224,9 +401,10 @@ auto Sprite::batch(const ShaderProgram* const shaderProgram) const -> Batch {
 	texture->bind();
 	return Batch{ std::make_unique<Batch::Impl>(Batch::Impl{
 		std::move(context),
-		boost::qvm::translation_mat(boost::qvm::vec<double, 2>({ -width / 2., -height / 2. })),
+		Mat3().translate(Pixels(-width / 2.), Pixels(-height / 2.)),
 		shaderProgram ? shaderProgram->getUniformLocation("modelview")
-		              : Texture::modelviewUniform }) };
+		              : Texture::modelviewUniform,
+		texture.get(), shaderProgram == nullptr }) };
 }
 
 void Sprite::drawScaled(float xfactor, float yfactor,
@@ -234,7 +412,11 @@ void Sprite::drawScaled(float xfactor, float yfactor,
 	pushMatrix();
 	opengl::translate(static_cast<float>(position.x), static_cast<float>(position.y));
 	opengl::scale(xfactor, yfactor);
-		auto context = shaderProgram ? shaderProgram->use() : Texture::textureShaderProgram->use();
+	if (!shaderProgram && isOffscreen(*texture, opengl::modelview)) {
+		popMatrix();
+		return;
+	}
+	auto context = shaderProgram ? shaderProgram->use() : Texture::textureShaderProgram->use();
 	if (shaderProgram) {
 		glUniformMatrix3fv(shaderProgram->getUniformLocation("modelview"), 1, GL_FALSE,
 			opengl::modelview.data);
@@ -245,6 +427,7 @@ void Sprite::drawScaled(float xfactor, float yfactor,
 		glUniformMatrix3fv(Texture::modelviewUniform, 1, GL_FALSE, opengl::modelview.data);
 	}
 	texture->draw();
+	countPixels(*texture, opengl::modelview);
 	popMatrix();
 }
 
@@ -258,6 +441,11 @@ void Sprite::drawClipped(float xstart, float xend, float ystart, float yend) con
 void Sprite::drawClipped(const Vec2 start, const Vec2 end) const {
 	pushMatrix();
 	opengl::translate(static_cast<float>(position.x), static_cast<float>(position.y));
+	// the clipped part lies within the whole texture:
+	if (isOffscreen(*texture, opengl::modelview)) {
+		popMatrix();
+		return;
+	}
 	texture->drawClipped(static_cast<float>(start.x), static_cast<float>(end.x),
 	                     static_cast<float>(start.y), static_cast<float>(end.y),
 	                     gSpriteColor.getRed(), gSpriteColor.getGreen(), gSpriteColor.getBlue(),
@@ -305,162 +493,43 @@ void Sprite::drawMesh(const std::vector<Vertex>& vertexes,
 }
 
 void Sprite::setBytes(const unsigned char* const bytes) {
-	texture->setBytes(bytes, static_cast<int>(std::lround(width)),
-	                  static_cast<int>(std::lround(height)));
+	const int pixelWidth = static_cast<int>(std::lround(width));
+	const int pixelHeight = static_cast<int>(std::lround(height));
+	if (texture.use_count() > 1) {
+		// Copy on write: The texture might be cached or shared with other Sprites through
+		// deduplicate(). The copy doesn't get cached, so it isn't shared with anyone.
+		texture = std::make_shared<Texture>(texture->getPreciseWidth(),
+		                                    texture->getPreciseHeight(), pixelWidth, pixelHeight,
+		                                    nullptr, GL_RGBA, bytes);
+		return;
+	}
+	texture->setBytes(bytes, pixelWidth, pixelHeight);
+	texture->resetHull(); // the hull of the old pixels might cut off parts of the new ones
 }
 
 const Shader& Sprite::vertexShader() {
 	return *Texture::textureVertexShader;
 }
 
-#ifndef NOPNG
-Finally Sprite::LoadPNG(const std::string& filename, FILE* const fp, const bool halfLoad) {
-	const unsigned int PNG_BYTES_TO_CHECK = 4;
-	png_byte buf[PNG_BYTES_TO_CHECK];
-
-	// Read in some of the signature bytes
-	if (fread(buf, 1, PNG_BYTES_TO_CHECK, fp) != PNG_BYTES_TO_CHECK ||
-	    png_sig_cmp(buf, static_cast<png_size_t>(0), PNG_BYTES_TO_CHECK) != 0) {
-		throw std::runtime_error(std::string("Error reading signature bytes. (" + filename + ")"));
-	}
-
-	png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
-	if (!png_ptr) {
-		throw std::runtime_error(std::string("libpng error while reading (" + filename + ")"));
-	}
-
-	png_infop info_ptr = png_create_info_struct(png_ptr);
-	if (!info_ptr) {
-		throw std::runtime_error(std::string("libpng error while reading (" + filename + ")"));
-	}
-
-	if (setjmp(png_jmpbuf(png_ptr))) {
-		// Free all of the memory associated with the png_ptr and info_ptr
-		png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
-		throw std::runtime_error(std::string("Error reading file. (" + filename + ")"));
-	}
-	png_init_io(png_ptr, fp);
-	png_set_sig_bytes(png_ptr, PNG_BYTES_TO_CHECK);
-	if (const int colorType = png_get_color_type(png_ptr, info_ptr);
-	    colorType == PNG_COLOR_TYPE_GRAY || colorType == PNG_COLOR_TYPE_GRAY_ALPHA) {
-		png_set_gray_to_rgb(png_ptr);
-	}
-	png_read_png(png_ptr, info_ptr, PNG_TRANSFORM_EXPAND | PNG_TRANSFORM_STRIP_16, nullptr);
-
-	GLenum format;
-	switch (png_get_channels(png_ptr, info_ptr)) {
-		case 1: // gray or palette, we can set format to RGB because we passed PNG_TRANSFORM_EXPAND
-		        // to png_read_png
-		case 3:
-			format = GL_RGB;
-			break;
-		case 2: // gray + alpha
-		case 4:
-			format = GL_RGBA;
-			break;
-		default:
-			throw std::runtime_error(
-			    std::string("Unsupported number of channels. (" + filename + ")"));
-	}
-
-	Finally freePng([&png_ptr, &info_ptr]() {
-		png_destroy_read_struct(&png_ptr, &info_ptr, static_cast<png_infop*>(nullptr));
-	});
-	unsigned char** rowPointers = png_get_rows(png_ptr, info_ptr);
-	const auto scaledWidth = static_cast<int>(png_get_image_width(png_ptr, info_ptr));
-	const auto scaledHeight = static_cast<int>(png_get_image_height(png_ptr, info_ptr));
-	width = static_cast<float>(scaledWidth * getScaleFactor());
-	height = static_cast<float>(scaledHeight * getScaleFactor());
-	loadTexture(scaledWidth, scaledHeight, filename, halfLoad, format, rowPointers);
-	return Finally(nullptr);
-}
-#endif
-
-void Sprite::cleanUpRowPointers(std::vector<unsigned char*>& buf) {
-	for (const auto p : buf) {
-		delete[] p;
-	}
-}
-
-Finally Sprite::LoadBMP(const std::string& filename, FILE* const fp, const bool halfLoad) {
-	if (fseek(fp, 10, SEEK_SET) != 0) {
-		throw std::runtime_error(std::string("Error seeking file. (" + filename + ")"));
-	}
-	BMPHeader header{};
-	if (!fread(&header, sizeof(header), 1, fp)) {
-		throw std::runtime_error(std::string("Error reading file. (" + filename + ")"));
-	}
-	if (header.headerSize != 40) {
-		throw std::runtime_error(std::string("Unsupported header size. (" + filename + ")"));
-	}
-	if (header.bpp != 24) {
-		throw std::runtime_error(std::string("Bpp not supported. (" + filename + ")"));
-	}
-	if (header.compression != 0) {
-		throw std::runtime_error(std::string("Compression not supported. (" + filename + ")"));
-	}
-	if (header.dataSize == 0) {
-		header.dataSize = header.width * header.height * 3;
-	}
-	std::vector<unsigned char*> buf(header.height);
-	for (auto& row : buf) {
-		row = new unsigned char[static_cast<unsigned long>(header.width * 3)];
-	}
-	Finally cleanUp([&buf]() { cleanUpRowPointers(buf); });
-
-	if (header.height < 0) {
-		header.height = -header.height;
-		for (int i = 0; i < header.height; ++i) {
-			if (fseek(fp, header.dataOffset + static_cast<long>(i) * header.width * 3, SEEK_SET) !=
-			    0) {
-				throw std::runtime_error(std::string("Error reading file. (" + filename + ")"));
-			}
-			if (!fread(buf[i], static_cast<size_t>(header.width) * 3, 1, fp)) {
-				throw std::runtime_error(std::string("Error reading data. (" + filename + ")"));
-			}
-		}
-	} else { // "bottom-up"-Bitmap
-		for (int i = header.height - 1; i >= 0; --i) {
-			if (fseek(fp, header.dataOffset + static_cast<long>(i) * header.width * 3, SEEK_SET) !=
-			    0) {
-				throw std::runtime_error(std::string("Error reading file. (" + filename + ")"));
-			}
-			if (!fread(buf[(header.height - 1) - i], static_cast<size_t>(header.width) * 3, 1,
-			           fp)) {
-				throw std::runtime_error(std::string("Error reading data. (" + filename + ")"));
-			}
-		}
-	}
-	width = static_cast<float>(header.width * getScaleFactor());
-	height = static_cast<float>(header.height * getScaleFactor());
-	loadTexture(header.width, header.height, filename, halfLoad, GL_BGR, buf.data());
-	return Finally(nullptr);
-}
-#ifndef NOWEBP
-Finally Sprite::LoadWebP(const std::string& filename, FILE* file, const bool halfLoad) {
-	auto imageData = std::make_shared<ImageDataWebP>(filename, file, getScaleFactor());
-	width = static_cast<float>(imageData->getImageWidth() * getScaleFactor());
-	height = static_cast<float>(imageData->getImageHeight() * getScaleFactor());
-	return Finally([imageData = std::move(imageData), filename, halfLoad, this]() mutable {
-		loadTexture(imageData->getWidth(), imageData->getHeight(), filename, halfLoad, GL_RGBA,
-		            nullptr, imageData->pixels());
-	});
-}
-#endif
-
 void Sprite::loadTexture(const int scaledWidth, const int scaledHeight, const std::string& filename,
                          const bool halfLoad, const unsigned int format,
-                         const unsigned char* const* const rowPointers,
-                         const unsigned char* const data) {
+                         const unsigned char* const data, const uint64_t contentHash,
+                         const std::vector<Vec2>& hull) {
 	if (!pWindow) {
 		if (halfLoad) {
 			return;
 		}
 		throw std::runtime_error(std::string("Window hasn't been created yet. (" + filename + ")"));
 	}
-	texture = std::make_shared<Texture>(width, height, scaledWidth, scaledHeight, rowPointers,
-	                                    format, data);
-	TextureCache::handle().insert(filename, texture);
+	const std::size_t bytes = static_cast<std::size_t>(scaledWidth) * scaledHeight *
+	                          (format == GL_RGBA ? 4 : 3);
+	texture = deduplicate(contentHash, bytes, filename, [&]() {
+		auto texture = std::make_shared<Texture>(width, height, scaledWidth, scaledHeight, nullptr,
+		                                         format, data);
+		texture->setHull(hull);
+		return texture;
+	});
+	TextureCache::handle().insert(filename, texture, contentHash);
 }
 
 Finally disableBlending() {
@@ -218,6 +218,12 @@ public:
 	void drawMesh(Mat3 modelview, const std::vector<Vertex>& vertexes,
 	              const ShaderProgram* = nullptr) const;
 
+	/// Replaces the image with RGBA pixels, see Sprite(const uint8_t*, size_t, size_t)
+	///
+	/// If the texture is shared with other Sprites, e.g. ones loaded from the same file or a file
+	/// with identical content, this Sprite gets its own copy first and the others stay unchanged.
+	/// The whole rectangle gets drawn afterwards, even if the image has been trimmed when loading,
+	/// see setSpriteTrimming.
 	void setBytes(const unsigned char*);
 
 	/// Returns a reference to JNGL's default vertex shader used to draw textures
@@ -227,25 +233,9 @@ public:
 	std::shared_ptr<Finally> loader;
 
 private:
-	static void cleanUpRowPointers(std::vector<unsigned char*>& buf);
 	void loadTexture(int scaledWidth, int scaledHeight, const std::string& filename, bool halfLoad,
-	                 unsigned int format, const unsigned char* const* rowPointers,
-	                 const unsigned char* data = nullptr);
-	Finally LoadPNG(const std::string& filename, FILE* fp, bool halfLoad);
-	struct BMPHeader {
-		unsigned int dataOffset;
-		unsigned int headerSize;
-		int width;
-		int height;
-		unsigned short planes;
-		unsigned short bpp;
-		unsigned int compression;
-		unsigned int dataSize;
-	};
-	Finally LoadBMP(const std::string& filename, FILE* fp, bool halfLoad);
-#ifndef NOWEBP
-	Finally LoadWebP(const std::string& filename, FILE* file, bool halfLoad);
-#endif
+	                 unsigned int format, const unsigned char* data, uint64_t contentHash,
+	                 const std::vector<Vec2>& hull);
 
 	std::shared_ptr<Texture> texture;
 };
@@ -258,11 +248,24 @@ template <class Vect> void draw(const std::string& filename, Vect pos) {
 
 /// Starts a thread to load \a filename and returns a Finally which will join it
 ///
+/// Decoding errors are passed to errorMessage(const std::string&) when joining, since the Finally
+/// can't throw. The Sprite isn't cached then, so the next use of \a filename throws as usual.
+///
 /// \param filename Name of an image file (extension is optional) or a .ogg sound file.
 Finally load(const std::string& filename);
 
 void unload(const std::string& filename);
 
+/// Makes Sprites resolve to regions of the texture atlases baked by jngl-bake
+///
+/// \a manifest is the manifest.txt written by jngl-bake, the atlas pages have to be next to it.
+/// Afterwards creating a Sprite (or calling jngl::draw, jngl::load, ...) with the name of a packed
+/// image, e.g. "player/idle" or "player/idle.png", draws the region of the atlas instead of
+/// loading the image itself. Can be called multiple times, e.g. for the atlases of each level.
+///
+/// \throws std::runtime_error if the manifest can't be read
+void loadAtlas(const std::string& manifest);
+
 void unloadAll();
 
 void drawClipped(const std::string& filename, double xposition, double yposition, float xstart,
@@ -285,6 +288,35 @@ void pushSpriteAlpha(unsigned char alpha = 255);
 
 void popSpriteAlpha();
 
+/// Trims Sprites which are loaded from now on to their non-transparent pixels
+///
+/// Instead of the whole rectangle a convex polygon with up to 8 corners will be drawn, which saves
+/// fill-rate for images with large transparent areas (particles, foliage, ...). Costs one pass
+/// over the pixels while loading. Images without alpha channel and block-compressed textures
+/// aren't trimmed. Disabled by default.
+void setSpriteTrimming(bool);
+
+/// Pixels covered by Sprites and texture memory saved, see getSpriteStatistics
+struct SpriteStatistics {
+	/// Area of the polygons that have actually been drawn
+	double drawnPixels = 0;
+
+	/// Area the whole rectangles would have covered, same as drawnPixels without trimming
+	double rectanglePixels = 0;
+
+	/// Bytes of textures which didn't need to be uploaded, because an image with the same content
+	/// had already been loaded from another file
+	std::size_t deduplicatedBytes = 0;
+};
+
+/// Returns how many pixels Sprites have covered in total, to measure the effect of
+/// setSpriteTrimming, and how much texture memory has been saved by deduplication
+///
+/// The values only grow (deduplicatedBytes until unloadAll), subtract the ones of the previous
+/// frame to get them per frame. The area is measured in screen pixels, drawClipped and drawMesh
+/// aren't included.
+SpriteStatistics getSpriteStatistics();
+
 int getWidth(const std::string& filename);
 
 int getHeight(const std::string& filename);
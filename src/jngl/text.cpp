@@ -3,6 +3,7 @@
 
 #include "text.hpp"
 
+#include "../culling.hpp"
 #include "../freetype.hpp"
 #include "../helper.hpp"
 #include "../windowptr.hpp"
@@ -106,6 +107,11 @@ void Text::draw() const {
 void Text::draw(Mat3 modelview) const {
 	auto mv = modelview.translate({ static_cast<double>(static_cast<int>(getX())),
 	                                static_cast<double>(static_cast<int>(getY())) });
+	// Glyphs can reach outside of the lines' boxes (italics, accents, ...), so be generous:
+	const auto margin = static_cast<float>(font->getLineHeight());
+	if (cull(mv, Vec2(-margin, -margin), Vec2(width + margin, height + margin))) {
+		return;
+	}
 	for (auto& line : lines) {
 		line->draw(mv);
 	}
@@ -4,8 +4,9 @@
 #include "opengl.hpp"
 
 #include "App.hpp"
+#include "jngl/Pixels.hpp"
 
-#include <boost/qvm_lite.hpp>
+#include <algorithm>
 #include <stdexcept>
 
 namespace opengl {
@@ -16,11 +17,11 @@ GLuint vaoStream;
 GLuint vboStream;
 
 void translate(float x, float y) {
-	modelview *= boost::qvm::translation_mat(boost::qvm::vec<float, 2>{{ x, y }});
+	modelview.translate(jngl::Pixels(x), jngl::Pixels(y));
 }
 
 void scale(const float x, const float y) {
-	modelview *= boost::qvm::diag_mat(boost::qvm::vec<float, 3>{{ x, y, 1 }});
+	modelview.scale(x, y);
 }
 
 GLuint genAndBindTexture() {
@@ -35,4 +36,36 @@ GLuint genAndBindTexture() {
 	return texture;
 }
 
+bool hasExtension(const std::string_view suffix) {
+	const auto matches = [suffix](const std::string_view name) {
+		return name.size() >= suffix.size() && name.substr(name.size() - suffix.size()) == suffix;
+	};
+#if defined(JNGL_UWP) || defined(__EMSCRIPTEN__)
+	// OpenGL ES 2.0 headers don't have glGetStringi, use the space separated list instead
+	const auto* const extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+	if (!extensions) {
+		return false;
+	}
+	std::string_view list(extensions);
+	while (!list.empty()) {
+		const auto end = std::min(list.find(' '), list.size());
+		if (matches(list.substr(0, end))) {
+			return true;
+		}
+		list.remove_prefix(std::min(end + 1, list.size()));
+	}
+#else
+	GLint count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (GLint i = 0; i < count; ++i) {
+		if (const auto* const name =
+		        reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+		    name && matches(name)) {
+			return true;
+		}
+	}
+#endif
+	return false;
+}
+
 } // namespace opengl
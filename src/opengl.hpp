@@ -6,6 +6,8 @@
 #include "jngl/Mat3.hpp"
 #include "jngl/Mat4.hpp"
 
+#include <string_view>
+
 #ifdef IOS
 	#include <OpenGLES/ES3/gl.h>
 	#include <OpenGLES/ES3/glext.h>
@@ -36,6 +38,24 @@
 #define GL_BGR 0x80e0
 #endif
 
+// Compressed texture formats, not all headers define them:
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9276
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
+
 namespace opengl
 {
 	extern jngl::Mat3 modelview;
@@ -50,4 +70,9 @@ namespace opengl
 
 	/// Generates a textures, binds it to GL_TEXTURE_2D and sets some common parameters
 	GLuint genAndBindTexture();
+
+	/// Whether the current context supports an extension whose name ends with \a suffix, e.g.
+	/// "texture_compression_s3tc" matches both GL_EXT_texture_compression_s3tc and
+	/// WEBGL_compressed_texture_s3tc
+	bool hasExtension(std::string_view suffix);
 } // namespace opengl
@@ -0,0 +1,104 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+#include <png.h> // Include first, see https://bugs.launchpad.net/ubuntu/+source/libpng/+bug/218409
+
+#include "../ImageDecoder.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace jngl {
+
+namespace {
+
+/// Decodes all PNG color types and bit depths using libpng's transformations, row by row
+class PngDecoder : public ImageDecoder {
+public:
+	PngDecoder(std::string filename, std::vector<uint8_t> file)
+	: ImageDecoder(std::move(filename), std::move(file)),
+	  png(png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr)) {
+		if (!png) {
+			throw std::runtime_error("libpng error while reading (" + this->filename + ")");
+		}
+		info = png_create_info_struct(png);
+		if (!info) {
+			png_destroy_read_struct(&png, nullptr, nullptr);
+			throw std::runtime_error("libpng error while reading (" + this->filename + ")");
+		}
+		if (setjmp(png_jmpbuf(png))) {
+			png_destroy_read_struct(&png, &info, nullptr);
+			throw std::runtime_error("Error reading file. (" + this->filename + ")");
+		}
+		png_set_read_fn(png, this, &PngDecoder::read);
+		png_read_info(png, info);
+		imageWidth = width = static_cast<int>(png_get_image_width(png, info));
+		imageHeight = height = static_cast<int>(png_get_image_height(png, info));
+		const auto colorType = png_get_color_type(png, info);
+		format = ((colorType & PNG_COLOR_MASK_ALPHA) != 0 || png_get_valid(png, info, PNG_INFO_tRNS))
+		             ? Format::RGBA
+		             : Format::RGB;
+	}
+
+	~PngDecoder() override {
+		png_destroy_read_struct(&png, &info, nullptr);
+	}
+
+	PngDecoder(const PngDecoder&) = delete;
+	PngDecoder& operator=(const PngDecoder&) = delete;
+	PngDecoder(PngDecoder&&) = delete;
+	PngDecoder& operator=(PngDecoder&&) = delete;
+
+	void decode(uint8_t* const dst, const std::size_t stride, const bool rgba) override {
+		if (setjmp(png_jmpbuf(png))) {
+			throw std::runtime_error("Error reading file. (" + filename + ")");
+		}
+		// Expand everything to 8 bit RGB(A):
+		const auto colorType = png_get_color_type(png, info);
+		if (png_get_bit_depth(png, info) == 16) {
+			png_set_strip_16(png);
+		}
+		if (colorType == PNG_COLOR_TYPE_PALETTE) {
+			png_set_palette_to_rgb(png);
+		}
+		if ((colorType & PNG_COLOR_MASK_COLOR) == 0) {
+			png_set_expand_gray_1_2_4_to_8(png);
+			png_set_gray_to_rgb(png);
+		}
+		if (png_get_valid(png, info, PNG_INFO_tRNS)) {
+			png_set_tRNS_to_alpha(png);
+		}
+		if (rgba && format == Format::RGB) {
+			png_set_filler(png, 0xff, PNG_FILLER_AFTER);
+		}
+		const int passes = png_set_interlace_handling(png);
+		png_read_update_info(png, info);
+		for (int pass = 0; pass < passes; ++pass) {
+			for (int y = 0; y < height; ++y) {
+				png_read_row(png, dst + static_cast<std::size_t>(y) * stride, nullptr);
+			}
+		}
+		png_read_end(png, nullptr);
+	}
+
+private:
+	static void read(png_structp png, png_bytep out, const png_size_t count) {
+		auto& self = *static_cast<PngDecoder*>(png_get_io_ptr(png));
+		if (self.file.size() - self.position < count) {
+			png_error(png, "unexpected end of file");
+		}
+		std::memcpy(out, self.file.data() + self.position, count);
+		self.position += count;
+	}
+
+	png_structp png;
+	png_infop info = nullptr;
+	std::size_t position = 0; //< in file
+};
+
+} // namespace
+
+std::unique_ptr<ImageDecoder> createPngDecoder(std::string filename, std::vector<uint8_t> file) {
+	return std::make_unique<PngDecoder>(std::move(filename), std::move(file));
+}
+
+} // namespace jngl
@@ -7,6 +7,7 @@
 #include "jngl/Alpha.hpp"
 #include "jngl/ImageData.hpp"
 #include "jngl/message.hpp"
+#include "jngl/other.hpp"
 #include "jngl/screen.hpp"
 #include "texture.hpp"
 #include "windowptr.hpp"
@@ -48,8 +49,56 @@ void setSpriteAlpha(unsigned char alpha) {
 	gSpriteColor.setAlpha(Alpha::u8(alpha));
 }
 
+bool gSpriteTrimming = false;
+
+void setSpriteTrimming(const bool enabled) {
+	gSpriteTrimming = enabled;
+}
+
+SpriteStatistics gSpriteStatistics;
+
+SpriteStatistics getSpriteStatistics() {
+	auto statistics = gSpriteStatistics;
+	statistics.deduplicatedBytes = TextureCache::handle().getBytesSaved();
+	return statistics;
+}
+
 std::unordered_map<std::string, std::shared_ptr<Sprite>> sprites_;
 
+std::unordered_map<std::string, AtlasRegion> atlasRegions;
+
+void loadAtlas(const std::string& filename) {
+	auto sstream = readAsset(filename);
+	if (!sstream) {
+		throw std::runtime_error("File not found: " + filename);
+	}
+	const auto manifest = AtlasManifest::read(sstream, filename);
+	const auto directory = filename.substr(0, filename.find_last_of('/') + 1);
+	for (const auto& region : manifest.regions) {
+		const auto& page = manifest.pages[region.page];
+		atlasRegions.insert_or_assign(
+		    region.name, AtlasRegion{ directory + page.filename, page.width, page.height, region });
+	}
+}
+
+const AtlasRegion* findAtlasRegion(const std::string& filename) {
+	if (atlasRegions.empty()) {
+		return nullptr;
+	}
+	auto it = atlasRegions.find(filename);
+	if (it == atlasRegions.end()) {
+		const auto dot = filename.find_last_of('.');
+		if (dot == std::string::npos || filename.find('/', dot) != std::string::npos) {
+			return nullptr;
+		}
+		it = atlasRegions.find(filename.substr(0, dot));
+		if (it == atlasRegions.end()) {
+			return nullptr;
+		}
+	}
+	return &it->second;
+}
+
 // halfLoad is used, if we only want to find out the width or height of an image. Load won't throw
 // an exception then
 Sprite& GetSprite(const std::string& filename, const Sprite::LoadType loadType) {
@@ -110,7 +159,9 @@ std::shared_ptr<Sprite> Sprite::Loader::shared() const {
 		return it->second;
 	}
 	auto imageData = imageDataFuture.get();
-	double scale = imageData->getImageWidth() == imageData->getWidth() ? getScaleFactor() : 1;
+	// The decoded size might differ from the logical one due to resolution variants or scaling
+	// while decoding:
+	const double scale = getScaleFactor() * imageData->getImageWidth() / imageData->getWidth();
 	return sprites_.try_emplace(filename, std::make_shared<Sprite>(*imageData, scale, filename))
 	    .first->second;
 }
@@ -126,6 +177,12 @@ Sprite* Sprite::Loader::operator->() const {
 	return shared().get();
 }
 
+void uncacheSprite(const std::string& filename, const Sprite& sprite) {
+	if (auto it = sprites_.find(filename); it != sprites_.end() && it->second.get() == &sprite) {
+		sprites_.erase(it);
+	}
+}
+
 void unload(const std::string& filename) {
 	auto it = sprites_.find(filename);
 	if (it != sprites_.end()) {
@@ -3,15 +3,34 @@
 
 #pragma once
 
+#include "AtlasManifest.hpp"
 #include "jngl/Rgba.hpp"
 #include "jngl/sprite.hpp"
 
 namespace jngl {
 
+/// Image packed by jngl-bake, see loadAtlas
+struct AtlasRegion {
+	std::string page; //< filename to load the page with
+	int pageWidth;
+	int pageHeight;
+	AtlasManifest::Region region;
+};
+
+/// Returns nullptr if \a filename hasn't been packed into any of the loaded atlases
+///
+/// The extension of \a filename is optional.
+const AtlasRegion* findAtlasRegion(const std::string& filename);
+
 Finally loadSprite(const std::string&);
+
+/// Removes \a sprite from the cache if it's the one GetSprite returns for \a filename
+void uncacheSprite(const std::string& filename, const Sprite& sprite);
 Sprite& GetSprite(const std::string& filename, Sprite::LoadType loadType = Sprite::LoadType::NORMAL);
 
 extern Rgba gSpriteColor;
 extern Rgba gShapeColor;
+extern bool gSpriteTrimming;
+extern SpriteStatistics gSpriteStatistics;
 
 } // namespace jngl
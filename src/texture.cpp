@@ -3,6 +3,7 @@
 
 #include "texture.hpp"
 
+#include "hull.hpp"
 #include "jngl/Shader.hpp"
 #include "jngl/Vertex.hpp"
 
@@ -21,16 +22,51 @@ Texture::Texture(const float preciseWidth, const float preciseHeight, const int
 	assert(format == GL_RGB || format == GL_RGBA || format == GL_BGR);
 	glTexImage2D(GL_TEXTURE_2D, 0, format == GL_RGBA ? GL_RGBA : GL_RGB, width, height, 0, format,
 	             GL_UNSIGNED_BYTE, nullptr);
+	createVertexBuffer(preciseWidth, preciseHeight);
+
+	if (rowPointers) {
+		assert(!data);
+		for (int i = 0; i < height; ++i) {
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, i, width, 1, format, GL_UNSIGNED_BYTE,
+			                rowPointers[i]);
+		}
+	}
+	if (data) {
+		assert(!rowPointers);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
+	}
+}
+
+Texture::Texture(const float preciseWidth, const float preciseHeight, const int width,
+                 const int height, const GLenum compressedFormat, const GLubyte* const data,
+                 const GLsizei size)
+: texture_(opengl::genAndBindTexture()) {
+	glCompressedTexImage2D(GL_TEXTURE_2D, 0, compressedFormat, width, height, 0, size, data);
+	createVertexBuffer(preciseWidth, preciseHeight);
+}
+
+Texture::Texture(const float preciseWidth, const float preciseHeight,
+                 std::shared_ptr<const Texture> atlas, const Vec2 topLeft, const Vec2 bottomRight)
+: texture_(atlas->texture_), atlas(std::move(atlas)), topLeft(topLeft), bottomRight(bottomRight) {
+	createVertexBuffer(preciseWidth, preciseHeight);
+}
+
+void Texture::createVertexBuffer(const float preciseWidth, const float preciseHeight) {
+	const float left = mapU(0);
+	const float top = mapV(0);
+	const float right = mapU(1);
+	const float bottom = mapV(1);
 	vertexes = {
 		0, 0,
-		0, 0, // texture coordinates
+		left, top, // texture coordinates
 		0, preciseHeight,
-		0, 1, // texture coordinates
+		left, bottom, // texture coordinates
 		preciseWidth, preciseHeight,
-		1, 1, // texture coordinates
+		right, bottom, // texture coordinates
 		preciseWidth, 0,
-		1, 0 // texture coordinates
+		right, top // texture coordinates
 	};
+	area = preciseWidth * preciseHeight;
 	glGenVertexArrays(1, &vao);
 	glBindVertexArray(vao);
 
@@ -46,18 +82,6 @@ Texture::Texture(const float preciseWidth, const float preciseHeight, const int
 	glVertexAttribPointer(texCoordAttrib, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float),
 	                      reinterpret_cast<void*>(2 * sizeof(float))); // NOLINT
 	glEnableVertexAttribArray(texCoordAttrib);
-
-	if (rowPointers) {
-		assert(!data);
-		for (int i = 0; i < height; ++i) {
-			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, i, width, 1, format, GL_UNSIGNED_BYTE,
-			                rowPointers[i]);
-		}
-	}
-	if (data) {
-		assert(!rowPointers);
-		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
-	}
 }
 
 Texture::~Texture() {
@@ -66,7 +90,9 @@ Texture::~Texture() {
 		// hideWindow() and the OpenGL context doesn't exist anymore. It's unnecessary to delete
 		// OpenGL resources in that case. It might even lead to crashes when the OpenGL function
 		// pointers have been unloaded (Windows).
-		glDeleteTextures(1, &texture_);
+		if (!atlas) {
+			glDeleteTextures(1, &texture_);
+		}
 		glDeleteBuffers(1, &vertexBuffer_);
 		glDeleteVertexArrays(1, &vao);
 	}
@@ -80,7 +106,43 @@ void Texture::bind() const {
 
 void Texture::draw() const {
 	bind();
-	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+	glDrawArrays(GL_TRIANGLE_FAN, 0, vertexCount);
+}
+
+void Texture::setHull(const std::vector<Vec2>& hull) {
+	if (hull.empty()) {
+		return;
+	}
+	// vertexes stays the rectangle, because drawClipped and getPreciseWidth/Height rely on it
+	std::vector<GLfloat> polygon;
+	polygon.reserve(hull.size() * 4);
+	for (const Vec2 corner : hull) {
+		const auto u = static_cast<float>(corner.x);
+		const auto v = static_cast<float>(corner.y);
+		polygon.insert(polygon.end(),
+		               { u * getPreciseWidth(), v * getPreciseHeight(), mapU(u), mapV(v) });
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer_);
+	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(polygon.size() * sizeof(GLfloat)),
+	             polygon.data(), GL_STATIC_DRAW);
+	vertexCount = static_cast<GLsizei>(hull.size());
+	area = static_cast<float>(polygonArea(hull)) * getPreciseWidth() * getPreciseHeight();
+}
+
+void Texture::resetHull() {
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer_);
+	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexes.size() * sizeof(GLfloat)),
+	             vertexes.data(), GL_STATIC_DRAW);
+	vertexCount = 4;
+	area = getPreciseWidth() * getPreciseHeight();
+}
+
+GLsizei Texture::getVertexCount() const {
+	return vertexCount;
+}
+
+float Texture::getArea() const {
+	return area;
 }
 
 void Texture::drawClipped(const float xstart, const float xend, const float ystart,
@@ -94,10 +156,10 @@ void Texture::drawClipped(const float xstart, const float xend, const float ysta
 	vertexes[9] *= (yend - ystart);
 
 	// Texture coordinates:
-	vertexes[2] = vertexes[6] = xstart;
-	vertexes[3] = vertexes[15] = ystart;
-	vertexes[10] = vertexes[14] = xend;
-	vertexes[7] = vertexes[11] = yend;
+	vertexes[2] = vertexes[6] = mapU(xstart);
+	vertexes[3] = vertexes[15] = mapV(ystart);
+	vertexes[10] = vertexes[14] = mapU(xend);
+	vertexes[7] = vertexes[11] = mapV(yend);
 
 	glBindVertexArray(opengl::vaoStream);
 	auto tmp = textureShaderProgram->use();
@@ -123,8 +185,19 @@ void Texture::drawClipped(const float xstart, const float xend, const float ysta
 void Texture::drawMesh(const std::vector<Vertex>& vertexes) const {
 	glBindVertexArray(opengl::vaoStream);
 	glBindBuffer(GL_ARRAY_BUFFER, opengl::vboStream); // VAO does NOT save the VBO binding
-	glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertexes.size() * sizeof(vertexes[0])),
-	             vertexes.data(), GL_STREAM_DRAW);
+	if (atlas) {
+		std::vector<Vertex> mapped(vertexes);
+		for (auto& vertex : mapped) {
+			vertex.u = mapU(vertex.u);
+			vertex.v = mapV(vertex.v);
+		}
+		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(mapped.size() * sizeof(mapped[0])),
+		             mapped.data(), GL_STREAM_DRAW);
+	} else {
+		glBufferData(GL_ARRAY_BUFFER,
+		             static_cast<GLsizeiptr>(vertexes.size() * sizeof(vertexes[0])),
+		             vertexes.data(), GL_STREAM_DRAW);
+	}
 
 	const GLint posAttrib = textureShaderProgram->getAttribLocation("position");
 	glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
@@ -139,6 +212,14 @@ void Texture::drawMesh(const std::vector<Vertex>& vertexes) const {
 	glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertexes.size()));
 }
 
+float Texture::mapU(const float u) const {
+	return static_cast<float>(topLeft.x + u * (bottomRight.x - topLeft.x));
+}
+
+float Texture::mapV(const float v) const {
+	return static_cast<float>(topLeft.y + v * (bottomRight.y - topLeft.y));
+}
+
 GLuint Texture::getID() const {
 	return texture_;
 }
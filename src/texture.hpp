@@ -4,6 +4,7 @@
 #pragma once
 
 #include "jngl/ShaderProgram.hpp"
+#include "jngl/Vec2.hpp"
 #include "opengl.hpp"
 
 #include <memory>
@@ -20,6 +21,12 @@ public:
 	Texture(float preciseWidth, float preciseHeight, int width, int height,
 	        const GLubyte* const* rowPointers, // data as row pointers ...
 	        GLenum format = GL_RGBA, const GLubyte* data = nullptr /* ... or as one pointer */);
+	/// Uploads block-compressed data, \a compressedFormat being e.g. GL_COMPRESSED_RGB8_ETC2
+	Texture(float preciseWidth, float preciseHeight, int width, int height, GLenum compressedFormat,
+	        const GLubyte* data, GLsizei size);
+	/// Draws the part of \a atlas between the texture coordinates \a topLeft and \a bottomRight
+	Texture(float preciseWidth, float preciseHeight, std::shared_ptr<const Texture> atlas,
+	        Vec2 topLeft, Vec2 bottomRight);
 	Texture(const Texture&) = delete;
 	Texture& operator=(const Texture&) = delete;
 	Texture(Texture&&) = delete;
@@ -27,6 +34,22 @@ public:
 	~Texture();
 	void bind() const;
 	void draw() const;
+
+	/// Makes draw() and getVertexCount() use a convex polygon instead of the whole rectangle
+	///
+	/// \a hull is in texture coordinates, see alphaHull(). Passing an empty vector is a no-op.
+	void setHull(const std::vector<Vec2>& hull);
+
+	/// Undoes setHull, so that draw() uses the whole rectangle again
+	void resetHull();
+
+	/// Number of vertexes draw() passes to GL_TRIANGLE_FAN
+	[[nodiscard]] GLsizei getVertexCount() const;
+
+	/// Area of the polygon drawn by draw(), getPreciseWidth() * getPreciseHeight() if there's no
+	/// hull
+	[[nodiscard]] float getArea() const;
+
 	void drawClipped(float xstart, float xend, float ystart, float yend, float red, float green,
 	                 float blue, float alpha) const;
 	void drawMesh(const std::vector<Vertex>& vertexes) const;
@@ -34,6 +57,8 @@ public:
 	[[nodiscard]] float getPreciseWidth() const;
 	[[nodiscard]] float getPreciseHeight() const;
 	static void unloadShader();
+
+	/// Not possible for compressed textures and parts of an atlas
 	void setBytes(const unsigned char*, int width, int height) const;
 
 	static ShaderProgram* textureShaderProgram;
@@ -41,10 +66,21 @@ public:
 	static int shaderSpriteColorUniform;
 	static int modelviewUniform;
 private:
+	void createVertexBuffer(float preciseWidth, float preciseHeight);
+
+	/// Maps texture coordinates of this texture to the ones of atlas
+	[[nodiscard]] float mapU(float u) const;
+	[[nodiscard]] float mapV(float v) const;
+
 	GLuint texture_ = 0;
+	std::shared_ptr<const Texture> atlas; //< owns texture_ if set
+	Vec2 topLeft{ 0, 0 };
+	Vec2 bottomRight{ 1, 1 };
 	GLuint vertexBuffer_ = 0;
 	GLuint vao = 0;
 	std::vector<GLfloat> vertexes;
+	GLsizei vertexCount = 4;
+	float area = 0;
 };
 
 } // namespace jngl
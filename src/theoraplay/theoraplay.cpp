@@ -12,11 +12,19 @@
 
 #include "../../src/log.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "theora/theoradec.h"
 #include "theoraplay.h"
@@ -59,13 +67,24 @@ void ConvertVideoFrame420ToIYUV(const th_info* tinfo, const th_ycbcr_buffer ycbc
 	}
 }
 
+class DecoderState;
+
 struct THEORAPLAY_Decoder {
     // Thread wrangling...
-	bool thread_created = false;
     std::mutex lock;
 	std::atomic_bool halt = false;
-	bool thread_done = false;
-    std::thread worker;
+	bool thread_done = false; // decoding is over, state has been destroyed
+
+	/// Only touched by the DecodePool thread which currently works on this decoder
+	std::unique_ptr<DecoderState> state;
+	/// Protected by the mutex of the DecodePool
+	bool running = false;
+
+	/// steady_clock time of the last call by the consumer, decoding pauses if it's too long ago
+	std::atomic<std::chrono::steady_clock::rep> lastUsed = 0;
+	/// Set by the DecodePool before checking lastUsed, so that THEORAPLAY_touch knows that it has
+	/// to wake it up
+	std::atomic_bool paused = false;
 
     // API state...
 	THEORAPLAY_Io* io = nullptr;
@@ -76,6 +95,7 @@ struct THEORAPLAY_Decoder {
 	std::atomic_bool hasvideo = false;
 	std::atomic_bool hasaudio = false;
 	std::atomic_bool decode_error = false;
+	std::atomic<double> fps = 0;
 
 	THEORAPLAY_VideoFormat vidfmt = THEORAPLAY_VIDFMT_IYUV;
 
@@ -85,11 +105,90 @@ struct THEORAPLAY_Decoder {
 	AudioPacket* audiolist = nullptr;
 	AudioPacket* audiolisttail = nullptr;
 
+	/// Packets which have been freed by THEORAPLAY_freeAudio and can be reused
+	AudioPacket* audiopool = nullptr;
+
+	/// Pixels of all frames, allocated once when the size of the video is known
 	std::unique_ptr<uint8_t[]> ringBuffer;
+	/// One VideoFrame per slot of ringBuffer
+	std::unique_ptr<VideoFrame[]> framePool;
+
+	// Incremented by THEORAPLAY_seek, the decoder thread sets seekDone to the same value once it
+	// has jumped to seekms. Everything decoded while they differ gets dropped.
+	unsigned int seekRequest = 0;
+	unsigned int seekDone = 0;
+	unsigned int seekms = 0;
+
+	/// Reached the end of the file, but the state is kept in case of THEORAPLAY_seek
+	bool idle = false;
+
+	/// Key for the keyframe index cache, empty if the Io wasn't opened by THEORAPLAY_startDecodeFile
+	std::string filename;
 };
 
-static int FeedMoreOggData(THEORAPLAY_Io *io, ogg_sync_state *sync)
-{
+namespace {
+
+/// Where to start decoding to get to a keyframe
+struct Keyframe {
+	/// granulepos >> keyframe_granule_shift of the keyframe
+	ogg_int64_t keyframe;
+	/// byte offset of the last page with a Theora granulepos before the keyframe
+	long offset;
+	/// granulepos of that page, i.e. of the last packet which we don't need to decode. -1 if decoding
+	/// has to start from the beginning of the file.
+	ogg_int64_t granulepos;
+};
+
+using KeyframeIndex = std::vector<Keyframe>;
+
+std::mutex keyframeIndexCacheMutex;
+std::map<std::string, std::shared_ptr<const KeyframeIndex>> keyframeIndexCache;
+
+} // namespace
+
+/// Takes a packet from ctx->audiopool which can hold at least \a count floats
+static AudioPacket* AllocateAudioPacket(THEORAPLAY_Decoder* const ctx, const size_t count) {
+	AudioPacket* item;
+	{
+		std::scoped_lock lock(ctx->lock);
+		item = ctx->audiopool;
+		if (item) {
+			ctx->audiopool = item->next;
+		}
+	}
+	if (item == nullptr) {
+		item = static_cast<AudioPacket*>(malloc(sizeof(AudioPacket)));
+		if (item == nullptr) {
+			return nullptr;
+		}
+		item->samples = nullptr;
+		item->capacity = 0;
+		item->decoder = ctx;
+	}
+	if (item->capacity < count) { // Vorbis' block size is limited, so this stops happening soon
+		auto* const samples = static_cast<float*>(realloc(item->samples, sizeof(float) * count));
+		if (samples == nullptr) {
+			free(item->samples);
+			free(item);
+			return nullptr;
+		}
+		item->samples = samples;
+		item->capacity = count;
+	}
+	item->next = nullptr;
+	return item;
+}
+
+static void FreeAudioList(AudioPacket* list) {
+	while (list) {
+		AudioPacket* next = list->next;
+		free(list->samples);
+		free(list);
+		list = next;
+	}
+}
+
+static int FeedMoreOggData(THEORAPLAY_Io* io, ogg_sync_state* sync, long* total = nullptr) {
     long buflen = 4096;
     char *buffer = ogg_sync_buffer(sync, buflen);
 	if (buffer == nullptr) {
@@ -99,190 +198,201 @@ static int FeedMoreOggData(THEORAPLAY_Io *io, ogg_sync_state *sync)
 	if (buflen <= 0) {
 		return 0;
 	}
+	if (total) {
+		*total += buflen;
+	}
 	return (ogg_sync_wrote(sync, buflen) == 0) ? 1 : -1;
 }
 
-
-// This massive function is where all the effort happens.
-static void WorkerThread(THEORAPLAY_Decoder* const ctx) {
-    // make sure we initialized the stream before using pagein, but the stream
-    //  will know to ignore pages that aren't meant for it, so pass to both.
-    #define queue_ogg_page(ctx) do { \
-        if (tpackets) ogg_stream_pagein(&tstream, &page); \
-        if (vpackets) ogg_stream_pagein(&vstream, &page); \
-    } while (0)
-
-    unsigned long audioframes = 0;
-    double fps = 0.0;
-    int was_error = 1;  // resets to 0 at the end.
-    int eos = 0;  // end of stream flag.
-
-    // Too much Ogg/Vorbis/Theora state...
-    ogg_packet packet;
-    ogg_sync_state sync;
-    ogg_page page;
-    int vpackets = 0;
-    vorbis_info vinfo;
-    vorbis_comment vcomment;
-    ogg_stream_state vstream;
-    int vdsp_init = 0;
-    vorbis_dsp_state vdsp;
-    int tpackets = 0;
-    th_info tinfo;
-    th_comment tcomment;
-    ogg_stream_state tstream;
-    int vblock_init = 0;
-    vorbis_block vblock;
-    th_dec_ctx *tdec = nullptr;
-    th_setup_info *tsetup = nullptr;
-	size_t ringBufferPos = 0;
-	size_t ringBufferSize;
-
-    ogg_sync_init(&sync);
-    vorbis_info_init(&vinfo);
-    vorbis_comment_init(&vcomment);
-    th_comment_init(&tcomment);
-    th_info_init(&tinfo);
-
-    int bos = 1;
-    while (!ctx->halt && bos)
-    {
-		if (FeedMoreOggData(ctx->io, &sync) <= 0) {
-			goto cleanup;
-		}
-		// parse out the initial header.
-        while ( (!ctx->halt) && (ogg_sync_pageout(&sync, &page) > 0) )
-        {
-            ogg_stream_state test;
-
-            if (!ogg_page_bos(&page))  // not a header.
-            {
-                queue_ogg_page(ctx);
-                bos = 0;
-                break;
+/// Reads all pages of the Theora stream \a serialno from the start of \a io
+static std::shared_ptr<const KeyframeIndex> BuildKeyframeIndex(THEORAPLAY_Io* io,
+                                                                const long serialno,
+                                                                const int granuleShift) {
+	if (io->seek(io, 0) != 0) {
+		return nullptr;
+	}
+	auto index = std::make_shared<KeyframeIndex>();
+	index->push_back({ 0, 0, -1 });
+
+	ogg_sync_state sync;
+	ogg_sync_init(&sync);
+	ogg_page page;
+	long total = 0; // bytes passed to sync
+	long previousOffset = 0;
+	ogg_int64_t previousGranulepos = -1;
+	ogg_int64_t previousKeyframe = 0;
+	while (true) {
+		if (ogg_sync_pageout(&sync, &page) <= 0) {
+			const int rc = FeedMoreOggData(io, &sync, &total);
+			if (rc < 0) {
+				ogg_sync_clear(&sync);
+				return nullptr;
 			}
-
-            ogg_stream_init(&test, ogg_page_serialno(&page));
-            ogg_stream_pagein(&test, &page);
-            ogg_stream_packetout(&test, &packet);
-
-            if (!tpackets && (th_decode_headerin(&tinfo, &tcomment, &tsetup, &packet) >= 0))
-            {
-                memcpy(&tstream, &test, sizeof (test));
-                tpackets = 1;
-            }
-            else if (!vpackets && (vorbis_synthesis_headerin(&vinfo, &vcomment, &packet) >= 0))
-            {
-                memcpy(&vstream, &test, sizeof (test));
-                vpackets = 1;
-			} else {
-				// whatever it is, we don't care about it
-                ogg_stream_clear(&test);
+			if (rc == 0) {
+				break;
 			}
+			continue;
 		}
+		const ogg_int64_t granulepos = ogg_page_granulepos(&page);
+		if (ogg_page_serialno(&page) != serialno || granulepos < 0) {
+			continue; // other stream or no packet ends on this page
+		}
+		const long offset =
+		    total - (sync.fill - sync.returned) - (page.header_len + page.body_len);
+		const ogg_int64_t keyframe = granulepos >> granuleShift;
+		// A granulepos of 0 could also belong to the header packets, so don't start decoding there.
+		if (keyframe != previousKeyframe && previousGranulepos > 0) {
+			index->push_back({ keyframe, previousOffset, previousGranulepos });
+		}
+		previousKeyframe = keyframe;
+		previousGranulepos = granulepos;
+		previousOffset = offset;
 	}
+	ogg_sync_clear(&sync);
+	jngl::internal::debug("Indexed {} keyframes.", index->size());
+	return index;
+}
 
-	// no audio OR video?
-	if (ctx->halt || (!vpackets && !tpackets)) {
-		goto cleanup;
+/// Returns the cached index for ctx->filename or builds it
+static std::shared_ptr<const KeyframeIndex>
+GetKeyframeIndex(THEORAPLAY_Decoder* const ctx, const long serialno, const int granuleShift) {
+	if (!ctx->filename.empty()) {
+		std::scoped_lock lock(keyframeIndexCacheMutex);
+		if (const auto it = keyframeIndexCache.find(ctx->filename);
+		    it != keyframeIndexCache.end()) {
+			return it->second;
+		}
 	}
-	// apparently there are two more theora and two more vorbis headers next.
-    while ((!ctx->halt) && ((tpackets && (tpackets < 3)) || (vpackets && (vpackets < 3))))
-    {
-        while (!ctx->halt && tpackets && (tpackets < 3))
-        {
-			if (ogg_stream_packetout(&tstream, &packet) != 1) {
-				break; // get more data?
-			}
-			if (!th_decode_headerin(&tinfo, &tcomment, &tsetup, &packet)) {
-				goto cleanup;
-			}
-			tpackets++;
-        } // while
+	auto index = BuildKeyframeIndex(ctx->io, serialno, granuleShift);
+	if (index && !ctx->filename.empty()) {
+		std::scoped_lock lock(keyframeIndexCacheMutex);
+		keyframeIndexCache.emplace(ctx->filename, index);
+	}
+	return index;
+}
 
-        while (!ctx->halt && vpackets && (vpackets < 3))
-        {
-			if (ogg_stream_packetout(&vstream, &packet) != 1) {
-				break; // get more data?
-			}
-			if (vorbis_synthesis_headerin(&vinfo, &vcomment, &packet)) {
-				goto cleanup;
-			}
-			vpackets++;
-        } // while
-
-        // get another page, try again?
-		if (ogg_sync_pageout(&sync, &page) > 0) {
-			queue_ogg_page(ctx);
-		} else if (FeedMoreOggData(ctx->io, &sync) <= 0) {
-			goto cleanup;
+
+/// Everything the decoder needs between two calls of step(), which get made by the DecodePool
+class DecoderState {
+public:
+	explicit DecoderState(THEORAPLAY_Decoder* const ctx) : ctx(ctx) {
+	    ogg_sync_init(&sync);
+	    vorbis_info_init(&vinfo);
+	    vorbis_comment_init(&vcomment);
+	    th_comment_init(&tcomment);
+	    th_info_init(&tinfo);
+	}
+
+	~DecoderState() {
+	    if (tdec != nullptr) { th_decode_free(tdec); }
+	    if (tsetup != nullptr) { th_setup_free(tsetup); }
+		if (vblock_init) {
+			vorbis_block_clear(&vblock);
 		}
-	} // while
+		if (vdsp_init) {
+			vorbis_dsp_clear(&vdsp);
+		}
+		if (tpackets) {
+			ogg_stream_clear(&tstream);
+		}
+		if (vpackets) {
+			ogg_stream_clear(&vstream);
+		}
+		th_info_clear(&tinfo);
+	    th_comment_clear(&tcomment);
+	    vorbis_comment_clear(&vcomment);
+	    vorbis_info_clear(&vinfo);
+	    ogg_sync_clear(&sync);
+	    ctx->io->close(ctx->io);
+	}
 
-    // okay, now we have our streams, ready to set up decoding.
-    if (!ctx->halt && tpackets)
-    {
-        // th_decode_alloc() docs say to check for insanely large frames yourself.
-		if ((tinfo.frame_width > 99999) || (tinfo.frame_height > 99999)) {
-			goto cleanup;
+	DecoderState(const DecoderState&) = delete;
+	DecoderState& operator=(const DecoderState&) = delete;
+	DecoderState(DecoderState&&) = delete;
+	DecoderState& operator=(DecoderState&&) = delete;
+
+	/// Parses the headers on the first call, after that decodes at most one video frame and the
+	/// audio that comes with it. Returns false once decoding is over, because of an error or
+	/// because the end of the file has been reached and seeking isn't possible.
+	bool step() {
+		if (!initialized) {
+			initialized = true;
+			return init();
 		}
-		// We treat "unspecified" as NTSC. *shrug*
-        if ( (tinfo.colorspace != TH_CS_UNSPECIFIED) &&
-             (tinfo.colorspace != TH_CS_ITU_REC_470M) &&
-             (tinfo.colorspace != TH_CS_ITU_REC_470BG) )
-        {
-            assert(0 && "Unsupported colorspace.");  // !!! FIXME
-            goto cleanup;
-        } // if
 
-        if (tinfo.pixel_fmt != TH_PF_420) { assert(0); goto cleanup; } // !!! FIXME
+        int need_pages = 0;  // need more Ogg pages?
 
-		if (tinfo.fps_denominator != 0) {
-			fps = double(tinfo.fps_numerator) / double(tinfo.fps_denominator);
+		if (eos) {
+			if (!ctx->io->seek || !tpackets) {
+				return false;
+			}
+			// The caller might still want to seek back, the DecodePool won't call us again until
+			// then.
+			std::scoped_lock lock(ctx->lock);
+			if (ctx->seekRequest == ctx->seekDone) {
+				ctx->idle = true;
+				return true;
+			}
+			eos = 0;
 		}
-		tdec = th_decode_alloc(&tinfo, tsetup);
-        if (!tdec) goto cleanup;
-
-        // Set decoder to maximum post-processing level.
-        //  Theoretically we could try dropping this level if we're not keeping up.
-        int pp_level_max = 0;
-        // !!! FIXME: maybe an API to set this?
-        //th_decode_ctl(tdec, TH_DECCTL_GET_PPLEVEL_MAX, &pp_level_max, sizeof(pp_level_max));
-        th_decode_ctl(tdec, TH_DECCTL_SET_PPLEVEL, &pp_level_max, sizeof(pp_level_max));
-    } // if
-
-    // Done with this now.
-    if (tsetup != nullptr)
-    {
-        th_setup_free(tsetup);
-        tsetup = nullptr;
-    } // if
 
-    if (!ctx->halt && vpackets)
-    {
-        vdsp_init = (vorbis_synthesis_init(&vdsp, &vinfo) == 0);
-		if (!vdsp_init) {
-			goto cleanup;
+		unsigned int seekRequest;
+		unsigned int seekms;
+		{
+			std::scoped_lock lock(ctx->lock);
+			seekRequest = ctx->seekRequest;
+			seekms = ctx->seekms;
 		}
-		vblock_init = (vorbis_block_init(&vdsp, &vblock) == 0);
-		if (!vblock_init) {
-			goto cleanup;
+		if (seekRequest != ctx->seekDone && tpackets) { // seekDone is only written by this thread
+			if (!keyframeIndex) {
+				keyframeIndex =
+				    GetKeyframeIndex(ctx, tstream.serialno, tinfo.keyframe_granule_shift);
+				if (!keyframeIndex) {
+					return fail();
+				}
+			}
+			skipVideoUntil = static_cast<ogg_int64_t>(seekms / 1000. * fps + 1e-6);
+			// last keyframe at or before the frame we want to show:
+			auto keyframe = std::upper_bound(
+			    keyframeIndex->begin(), keyframeIndex->end(), skipVideoUntil,
+			    [&](const ogg_int64_t frame, const Keyframe& entry) {
+				    return frame < th_granule_frame(
+				                       tdec, entry.keyframe << tinfo.keyframe_granule_shift);
+			    });
+			assert(keyframe != keyframeIndex->begin());
+			--keyframe;
+			if (ctx->io->seek(ctx->io, keyframe->offset) != 0) {
+				return fail();
+			}
+			ogg_sync_reset(&sync);
+			ogg_stream_reset(&tstream);
+			if (vpackets) {
+				ogg_stream_reset(&vstream);
+			}
+			if (keyframe->granulepos < 0) {
+				// There's no TH_DECCTL to go back before the first frame, so start over
+				th_decode_free(tdec);
+				tdec = th_decode_alloc(&tinfo, tsetup);
+				if (!tdec) {
+					return fail();
+				}
+				int pp_level = 0;
+				th_decode_ctl(tdec, TH_DECCTL_SET_PPLEVEL, &pp_level, sizeof(pp_level));
+				waitForGranulepos = false;
+				resyncAudio = false;
+				audioframes = 0;
+			} else {
+				waitForGranulepos = true;
+				resyncAudio = true;
+			}
+			if (vdsp_init) {
+				vorbis_synthesis_restart(&vdsp);
+				skipAudioUntil =
+				    static_cast<unsigned long>(static_cast<double>(seekms) / 1000. * vinfo.rate);
+			}
+			std::scoped_lock lock(ctx->lock);
+			ctx->seekDone = seekRequest;
 		}
-	} // if
-
-    // Now we can start the actual decoding!
-    // Note that audio and video don't _HAVE_ to start simultaneously.
-
-    ctx->lock.lock();
-	ctx->prepped = true;
-    ctx->hasvideo = (tpackets != 0);
-    ctx->hasaudio = (vpackets != 0);
-    ctx->lock.unlock();
-
-    while (!ctx->halt && !eos)
-    {
-        int need_pages = 0;  // need more Ogg pages?
-        int saw_video_frame = 0;
 
         // Try to read as much audio as we can at once. We limit the outer
         //  loop to one video frame and as much audio as we can eat.
@@ -292,31 +402,45 @@ static void WorkerThread(THEORAPLAY_Decoder* const ctx) {
             const int frames = vorbis_synthesis_pcmout(&vdsp, &pcm);
             if (frames > 0)
             {
+				if (resyncAudio) {
+					if (vdsp.granulepos < 0) {
+						vorbis_synthesis_read(&vdsp, frames); // position unknown, drop it
+						continue;
+					}
+					// the granulepos belongs to the end of what pcmout returns
+					audioframes = static_cast<unsigned long>(std::max<ogg_int64_t>(
+					    0, vdsp.granulepos - static_cast<ogg_int64_t>(frames)));
+					resyncAudio = false;
+				}
+				// frames before the position we've seeked to:
+				const int skip = audioframes >= skipAudioUntil
+				                     ? 0
+				                     : static_cast<int>(std::min<unsigned long>(
+				                           skipAudioUntil - audioframes, frames));
+				if (skip == frames) {
+					vorbis_synthesis_read(&vdsp, frames);
+					audioframes += frames;
+					continue;
+				}
                 const int channels = vinfo.channels;
                 int chanidx, frameidx;
 				float* samples;
-				auto* item = static_cast<AudioPacket*>(malloc(sizeof(AudioPacket)));
+				auto* item = AllocateAudioPacket(
+				    ctx, static_cast<size_t>(frames - skip) * static_cast<size_t>(channels));
 				if (item == nullptr) {
-					goto cleanup;
+					return fail();
 				}
 				item->playms = static_cast<unsigned int>(
-				    ((static_cast<double>(audioframes)) / (static_cast<double>(vinfo.rate))) *
+				    ((static_cast<double>(audioframes + skip)) /
+				     (static_cast<double>(vinfo.rate))) *
 				    1000.0);
 				item->channels = channels;
                 item->freq = static_cast<int>(vinfo.rate);
-				item->frames = frames;
-				item->samples = static_cast<float*>(malloc(sizeof(float) * frames * channels));
-				item->next = nullptr;
-
-                if (item->samples == nullptr)
-                {
-                    free(item);
-                    goto cleanup;
-				}
+				item->frames = frames - skip;
 
                 // I bet this beats the crap out of the CPU cache...
                 samples = item->samples;
-                for (frameidx = 0; frameidx < frames; frameidx++)
+                for (frameidx = skip; frameidx < frames; frameidx++)
                 {
 					for (chanidx = 0; chanidx < channels; chanidx++) {
 						*(samples++) = pcm[chanidx][frameidx];
@@ -328,18 +452,20 @@ static void WorkerThread(THEORAPLAY_Decoder* const ctx) {
 
                 //printf("Decoded %d frames of audio.\n", (int) frames);
                 ctx->lock.lock();
-                ctx->audioms += item->playms;
-                if (ctx->audiolisttail)
-                {
-                    assert(ctx->audiolist);
-                    ctx->audiolisttail->next = item;
-				}
-                else
-                {
-                    assert(!ctx->audiolist);
-                    ctx->audiolist = item;
+				if (ctx->seekRequest != ctx->seekDone) { // decoded before the seek
+					item->next = ctx->audiopool;
+					ctx->audiopool = item;
+				} else {
+					ctx->audioms += item->playms;
+					if (ctx->audiolisttail) {
+						assert(ctx->audiolist);
+						ctx->audiolisttail->next = item;
+					} else {
+						assert(!ctx->audiolist);
+						ctx->audiolist = item;
+					}
+					ctx->audiolisttail = item;
 				}
-                ctx->audiolisttail = item;
                 ctx->lock.unlock();
 			} else { // no audio available left in current packet?
 				// try to feed another packet to the Vorbis stream...
@@ -362,6 +488,14 @@ static void WorkerThread(THEORAPLAY_Decoder* const ctx) {
             //  "one [packet] in, one [frame] out."
 			if (ogg_stream_packetout(&tstream, &packet) <= 0) {
 				need_pages = 1;
+			} else if (waitForGranulepos) {
+				// Packets which end on the page we've seeked to. The last one has a granulepos,
+				// the keyframe comes after it.
+				if (packet.granulepos >= 0) {
+					th_decode_ctl(tdec, TH_DECCTL_SET_GRANPOS, &packet.granulepos,
+					              sizeof(packet.granulepos));
+					waitForGranulepos = false;
+				}
 			} else {
 				ogg_int64_t granulepos = 0;
 
@@ -373,27 +507,26 @@ static void WorkerThread(THEORAPLAY_Decoder* const ctx) {
 				if (th_decode_packetin(tdec, &packet, &granulepos) == 0)  // new frame!
                 {
                     th_ycbcr_buffer ycbcr;
-                    if (th_decode_ycbcr_out(tdec, ycbcr) == 0)
-                    {
+					if (th_granule_frame(tdec, granulepos) < skipVideoUntil) {
+						// only decoded as a reference for the frame we've seeked to
+					} else if (th_decode_ycbcr_out(tdec, ycbcr) == 0) {
                         const double videotime = th_granule_time(tdec, granulepos);
-						const auto item = new VideoFrame;
-                        if (item == nullptr) { goto cleanup; }
-						item->playms = static_cast<unsigned int>(videotime * 1000.0);
-						item->fps = fps;
-                        item->width = tinfo.pic_width;
-                        item->height = tinfo.pic_height;
-                        item->format = ctx->vidfmt;
-
+						// IYUV only needs 1.5 bytes per pixel
+						const size_t frameSize =
+						    static_cast<size_t>(tinfo.pic_width) * tinfo.pic_height * 3 / 2;
 						if (!ctx->ringBuffer) {
 							while (true) {
-								ringBufferSize = static_cast<size_t>(ctx->maxframes + 1) *
-								                 item->width * item->height * 2;
+								// the frames in the list plus the ones held by the caller:
+								framePoolSize = static_cast<size_t>(ctx->maxframes) + 2;
 								jngl::internal::debug("Allocating {} MB for video ring buffer.",
-								                      ringBufferSize / 1024 / 1024);
+								                      framePoolSize * frameSize / 1024 / 1024);
 								try {
-									ctx->ringBuffer = std::make_unique<uint8_t[]>(ringBufferSize);
+									ctx->ringBuffer =
+									    std::make_unique<uint8_t[]>(framePoolSize * frameSize);
+									ctx->framePool = std::make_unique<VideoFrame[]>(framePoolSize);
 									break;
 								} catch (std::bad_alloc&) {
+									ctx->ringBuffer.reset();
 									ctx->maxframes /= 2;
 									if (ctx->maxframes < 1) {
 										throw;
@@ -401,37 +534,33 @@ static void WorkerThread(THEORAPLAY_Decoder* const ctx) {
 								}
 							}
 						}
-						item->pixels = &ctx->ringBuffer[ringBufferPos];
-						ringBufferPos += item->width * item->height * 2;
-						assert(ringBufferPos <= ringBufferSize); // width and height mustn't change
-						if (ringBufferPos == ringBufferSize) {
-							ringBufferPos = 0;
-						}
-
-						ConvertVideoFrame420ToIYUV(&tinfo, ycbcr, item->pixels);
+						VideoFrame* const item = &ctx->framePool[framePoolPos];
+						item->playms = static_cast<unsigned int>(videotime * 1000.0);
+						item->fps = fps;
+						item->width = tinfo.pic_width;
+						item->height = tinfo.pic_height;
+						item->format = ctx->vidfmt;
+						item->pixels = &ctx->ringBuffer[framePoolPos * frameSize];
 						item->next = nullptr;
+						framePoolPos = (framePoolPos + 1) % framePoolSize;
 
-                        if (item->pixels == nullptr)
-                        {
-							delete item;
-                            goto cleanup;
-						}
+						ConvertVideoFrame420ToIYUV(&tinfo, ycbcr, item->pixels);
 
                         //printf("Decoded another video frame.\n");
                         ctx->lock.lock();
-                        if (ctx->videolisttail)
-                        {
-                            assert(ctx->videolist);
-                            ctx->videolisttail->next = item;
-						} else {
-                            assert(!ctx->videolist);
-                            ctx->videolist = item;
-                        }
-                        ctx->videolisttail = item;
-                        ctx->videocount++;
+						if (ctx->seekRequest == ctx->seekDone) {
+							if (ctx->videolisttail) {
+								assert(ctx->videolist);
+								ctx->videolisttail->next = item;
+							} else {
+								assert(!ctx->videolist);
+								ctx->videolist = item;
+							}
+							ctx->videolisttail = item;
+							ctx->videocount++;
+						} // otherwise it has been decoded before the seek and the slot can be reused
                         ctx->lock.unlock();
 
-                        saw_video_frame = 1;
 					}
 				}
 			}
@@ -443,66 +572,343 @@ static void WorkerThread(THEORAPLAY_Decoder* const ctx) {
 			if (rc == 0) {
 				eos = 1; // end of stream
 			} else if (rc < 0) {
-				goto cleanup; // i/o error, etc.
+				return fail(); // i/o error, etc.
 			} else {
 				while (!ctx->halt && (ogg_sync_pageout(&sync, &page) > 0)) {
-					queue_ogg_page(ctx);
+					queuePage();
 				}
 			}
 		}
 
-        // Sleep the process until we have space for more frames.
-        if (saw_video_frame)
-        {
-            int go_on = !ctx->halt;
-            //printf("Sleeping.\n");
-            while (go_on)
-            {
-                // !!! FIXME: This is stupid. I should use a semaphore for this.
-                ctx->lock.lock();
-                go_on = !ctx->halt && (ctx->videocount >= ctx->maxframes);
-                ctx->lock.unlock();
-				if (go_on) {
-					std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		return true;
+	}
+
+private:
+	bool init() {
+	    int bos = 1;
+	    while (!ctx->halt && bos)
+	    {
+			if (FeedMoreOggData(ctx->io, &sync) <= 0) {
+				return fail();
+			}
+			// parse out the initial header.
+	        while ( (!ctx->halt) && (ogg_sync_pageout(&sync, &page) > 0) )
+	        {
+	            ogg_stream_state test;
+
+	            if (!ogg_page_bos(&page))  // not a header.
+	            {
+	                queuePage();
+	                bos = 0;
+	                break;
+				}
+
+	            ogg_stream_init(&test, ogg_page_serialno(&page));
+	            ogg_stream_pagein(&test, &page);
+	            ogg_stream_packetout(&test, &packet);
+
+	            if (!tpackets && (th_decode_headerin(&tinfo, &tcomment, &tsetup, &packet) >= 0))
+	            {
+	                memcpy(&tstream, &test, sizeof (test));
+	                tpackets = 1;
+	            }
+	            else if (!vpackets && (vorbis_synthesis_headerin(&vinfo, &vcomment, &packet) >= 0))
+	            {
+	                memcpy(&vstream, &test, sizeof (test));
+	                vpackets = 1;
+				} else {
+					// whatever it is, we don't care about it
+	                ogg_stream_clear(&test);
 				}
 			}
 		}
+
+		// no audio OR video?
+		if (ctx->halt || (!vpackets && !tpackets)) {
+			return fail();
+		}
+		// apparently there are two more theora and two more vorbis headers next.
+	    while ((!ctx->halt) && ((tpackets && (tpackets < 3)) || (vpackets && (vpackets < 3))))
+	    {
+	        while (!ctx->halt && tpackets && (tpackets < 3))
+	        {
+				if (ogg_stream_packetout(&tstream, &packet) != 1) {
+					break; // get more data?
+				}
+				if (!th_decode_headerin(&tinfo, &tcomment, &tsetup, &packet)) {
+					return fail();
+				}
+				tpackets++;
+	        } // while
+
+	        while (!ctx->halt && vpackets && (vpackets < 3))
+	        {
+				if (ogg_stream_packetout(&vstream, &packet) != 1) {
+					break; // get more data?
+				}
+				if (vorbis_synthesis_headerin(&vinfo, &vcomment, &packet)) {
+					return fail();
+				}
+				vpackets++;
+	        } // while
+
+	        // get another page, try again?
+			if (ogg_sync_pageout(&sync, &page) > 0) {
+				queuePage();
+			} else if (FeedMoreOggData(ctx->io, &sync) <= 0) {
+				return fail();
+			}
+		} // while
+
+	    // okay, now we have our streams, ready to set up decoding.
+	    if (!ctx->halt && tpackets)
+	    {
+	        // th_decode_alloc() docs say to check for insanely large frames yourself.
+			if ((tinfo.frame_width > 99999) || (tinfo.frame_height > 99999)) {
+				return fail();
+			}
+			// We treat "unspecified" as NTSC. *shrug*
+	        if ( (tinfo.colorspace != TH_CS_UNSPECIFIED) &&
+	             (tinfo.colorspace != TH_CS_ITU_REC_470M) &&
+	             (tinfo.colorspace != TH_CS_ITU_REC_470BG) )
+	        {
+	            assert(0 && "Unsupported colorspace.");  // !!! FIXME
+	            return fail();
+	        } // if
+
+	        if (tinfo.pixel_fmt != TH_PF_420) { assert(0); return fail(); } // !!! FIXME
+
+			if (tinfo.fps_denominator != 0) {
+				fps = double(tinfo.fps_numerator) / double(tinfo.fps_denominator);
+			}
+			tdec = th_decode_alloc(&tinfo, tsetup);
+	        if (!tdec) return fail();
+
+	        // Set decoder to maximum post-processing level.
+	        //  Theoretically we could try dropping this level if we're not keeping up.
+	        int pp_level_max = 0;
+	        // !!! FIXME: maybe an API to set this?
+	        //th_decode_ctl(tdec, TH_DECCTL_GET_PPLEVEL_MAX, &pp_level_max, sizeof(pp_level_max));
+	        th_decode_ctl(tdec, TH_DECCTL_SET_PPLEVEL, &pp_level_max, sizeof(pp_level_max));
+	    } // if
+
+	    // Done with this now, unless we have to start over after seeking.
+	    if (tsetup != nullptr && !ctx->io->seek)
+	    {
+	        th_setup_free(tsetup);
+	        tsetup = nullptr;
+	    } // if
+
+	    if (!ctx->halt && vpackets)
+	    {
+	        vdsp_init = (vorbis_synthesis_init(&vdsp, &vinfo) == 0);
+			if (!vdsp_init) {
+				return fail();
+			}
+			vblock_init = (vorbis_block_init(&vdsp, &vblock) == 0);
+			if (!vblock_init) {
+				return fail();
+			}
+		} // if
+
+	    // Now we can start the actual decoding!
+	    // Note that audio and video don't _HAVE_ to start simultaneously.
+
+	    ctx->lock.lock();
+		ctx->fps = fps;
+		ctx->prepped = true;
+	    ctx->hasvideo = (tpackets != 0);
+	    ctx->hasaudio = (vpackets != 0);
+	    ctx->lock.unlock();
+		return true;
 	}
 
-    was_error = 0;
+	bool fail() {
+		ctx->decode_error = !ctx->halt;
+		return false;
+	}
 
-cleanup:
-    ctx->decode_error = (!ctx->halt && was_error);
-    if (tdec != nullptr) { th_decode_free(tdec); }
-    if (tsetup != nullptr) { th_setup_free(tsetup); }
-	if (vblock_init) {
-		vorbis_block_clear(&vblock);
+	// make sure we initialized the stream before using pagein, but the stream
+	//  will know to ignore pages that aren't meant for it, so pass to both.
+	void queuePage() {
+		if (tpackets) ogg_stream_pagein(&tstream, &page);
+		if (vpackets) ogg_stream_pagein(&vstream, &page);
 	}
-	if (vdsp_init) {
-		vorbis_dsp_clear(&vdsp);
+
+	THEORAPLAY_Decoder* const ctx;
+	bool initialized = false;
+
+    unsigned long audioframes = 0;
+    double fps = 0.0;
+    int eos = 0;  // end of stream flag.
+
+    // Too much Ogg/Vorbis/Theora state...
+    ogg_packet packet;
+    ogg_sync_state sync;
+    ogg_page page;
+    int vpackets = 0;
+    vorbis_info vinfo;
+    vorbis_comment vcomment;
+    ogg_stream_state vstream;
+    int vdsp_init = 0;
+    vorbis_dsp_state vdsp;
+    int tpackets = 0;
+    th_info tinfo;
+    th_comment tcomment;
+    ogg_stream_state tstream;
+    int vblock_init = 0;
+    vorbis_block vblock;
+    th_dec_ctx *tdec = nullptr;
+    th_setup_info *tsetup = nullptr;
+	size_t framePoolPos = 0;
+	size_t framePoolSize = 0;
+
+	// State after a seek:
+	std::shared_ptr<const KeyframeIndex> keyframeIndex;
+	bool waitForGranulepos = false; // skip Theora packets until the one of Keyframe::granulepos
+	bool resyncAudio = false;       // audioframes is unknown until Vorbis sees a granulepos
+	ogg_int64_t skipVideoUntil = 0; // frame number
+	unsigned long skipAudioUntil = 0;
+};
+
+namespace {
+
+/// Multiplexes all decoders onto a few threads, so that neither the number of threads nor the CPU
+/// load grows with the number of videos. Whichever decoder has the least video buffered goes first.
+class DecodePool {
+public:
+	static DecodePool& handle() {
+		static DecodePool pool;
+		return pool;
 	}
-	if (tpackets) {
-		ogg_stream_clear(&tstream);
+
+	DecodePool() = default;
+	DecodePool(const DecodePool&) = delete;
+	DecodePool& operator=(const DecodePool&) = delete;
+	DecodePool(DecodePool&&) = delete;
+	DecodePool& operator=(DecodePool&&) = delete;
+
+	~DecodePool() {
+		{
+			std::scoped_lock lock(mutex);
+			quit = true;
+		}
+		condition.notify_all();
+		for (auto& thread : threads) {
+			thread.join();
+		}
 	}
-	if (vpackets) {
-		ogg_stream_clear(&vstream);
+
+	void add(THEORAPLAY_Decoder* const ctx) {
+		{
+			std::scoped_lock lock(mutex);
+			decoders.push_back(ctx);
+			// only start as many threads as there is work for:
+			if (threads.size() < std::min<size_t>(maxThreads, decoders.size())) {
+				threads.emplace_back([this]() { work(); });
+			}
+		}
+		condition.notify_one();
 	}
-	th_info_clear(&tinfo);
-    th_comment_clear(&tcomment);
-    vorbis_comment_clear(&vcomment);
-    vorbis_info_clear(&vinfo);
-    ogg_sync_clear(&sync);
-    ctx->io->close(ctx->io);
-	ctx->thread_done = true;
-}
 
+	/// Stops \a ctx, waits until no thread works on it anymore
+	void remove(THEORAPLAY_Decoder* const ctx) {
+		std::unique_lock lock(mutex);
+		ctx->halt = true;
+		condition.wait(lock, [ctx]() { return !ctx->running; });
+		std::erase(decoders, ctx);
+	}
 
-static void *WorkerThreadEntry(void *_this)
-{
-	WorkerThread(static_cast<THEORAPLAY_Decoder*>(_this));
-    return nullptr;
-}
+	/// Call after something happened which might make a decoder runnable again
+	void wake() {
+		{
+			// Empty, but without it a thread which has just checked all decoders could miss the
+			// notification:
+			std::scoped_lock lock(mutex);
+		}
+		condition.notify_all();
+	}
+
+	void setThreads(const unsigned int count) {
+		std::scoped_lock lock(mutex);
+		maxThreads = std::max(1U, count);
+	}
+
+private:
+	void work() {
+		std::unique_lock lock(mutex);
+		while (!quit) {
+			THEORAPLAY_Decoder* next = nullptr;
+			double lowest = NOT_RUNNABLE;
+			for (auto* const ctx : decoders) {
+				if (const double buffered = bufferedSeconds(*ctx); buffered < lowest) {
+					lowest = buffered;
+					next = ctx;
+				}
+			}
+			if (!next) {
+				condition.wait(lock);
+				continue;
+			}
+			next->running = true;
+			lock.unlock();
+			const bool keepGoing = next->state->step();
+			if (!keepGoing) {
+				next->state.reset();
+				std::scoped_lock decoderLock(next->lock);
+				next->thread_done = true;
+			}
+			lock.lock();
+			next->running = false;
+			if (!keepGoing) {
+				std::erase(decoders, next);
+			}
+			if (next->halt) {
+				condition.notify_all(); // remove() is waiting
+			}
+		}
+	}
+
+	/// How much video \a ctx has buffered or NOT_RUNNABLE if it doesn't need to be decoded
+	static double bufferedSeconds(THEORAPLAY_Decoder& ctx) {
+		if (ctx.running || ctx.halt) {
+			return NOT_RUNNABLE;
+		}
+		std::scoped_lock lock(ctx.lock);
+		if (!ctx.prepped || ctx.seekRequest != ctx.seekDone) {
+			return 0;
+		}
+		if (ctx.idle || ctx.videocount >= ctx.maxframes) {
+			return NOT_RUNNABLE;
+		}
+		if (ctx.videocount > 0) {
+			// Has something to show. The order matters here, see THEORAPLAY_touch.
+			ctx.paused = true;
+			if (std::chrono::steady_clock::now().time_since_epoch().count() - ctx.lastUsed >
+			    std::chrono::duration_cast<std::chrono::steady_clock::duration>(PAUSE_AFTER)
+			        .count()) {
+				return NOT_RUNNABLE;
+			}
+			ctx.paused = false;
+		}
+		const double fps = ctx.fps;
+		return fps > 0 ? ctx.videocount / fps : 0;
+	}
+
+	constexpr static double NOT_RUNNABLE = std::numeric_limits<double>::infinity();
 
+	/// Decoders whose frames haven't been asked for in this time stop decoding
+	constexpr static std::chrono::milliseconds PAUSE_AFTER{ 100 };
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::vector<THEORAPLAY_Decoder*> decoders;
+	std::vector<std::thread> threads;
+	unsigned int maxThreads = 2;
+	bool quit = false;
+};
+
+} // namespace
 
 static long IoFopenRead(THEORAPLAY_Io *io, void *buf, long buflen)
 {
@@ -514,12 +920,19 @@ static long IoFopenRead(THEORAPLAY_Io *io, void *buf, long buflen)
     return (long) br;
 }
 
+static int IoFopenSeek(THEORAPLAY_Io* io, const long offset) {
+	return fseek(static_cast<FILE*>(io->userdata), offset, SEEK_SET);
+}
+
 static void IoFopenClose(THEORAPLAY_Io* io) {
 	FILE* f = static_cast<FILE*>(io->userdata);
 	fclose(f);
     free(io);
 }
 
+static THEORAPLAY_Decoder* StartDecode(THEORAPLAY_Io*, unsigned int maxframes,
+                                       THEORAPLAY_VideoFormat, std::string filename);
+
 THEORAPLAY_Decoder* THEORAPLAY_startDecodeFile(const char* fname, const unsigned int maxframes,
                                                THEORAPLAY_VideoFormat vidfmt) {
 	auto* io = static_cast<THEORAPLAY_Io*>(malloc(sizeof(THEORAPLAY_Io)));
@@ -536,58 +949,45 @@ THEORAPLAY_Decoder* THEORAPLAY_startDecodeFile(const char* fname, const unsigned
     io->read = IoFopenRead;
     io->close = IoFopenClose;
     io->userdata = f;
-    return THEORAPLAY_startDecode(io, maxframes, vidfmt);
+	io->seek = IoFopenSeek;
+	return StartDecode(io, maxframes, vidfmt, fname);
 }
 
-THEORAPLAY_Decoder *THEORAPLAY_startDecode(THEORAPLAY_Io *io,
-                                           const unsigned int maxframes,
-                                           THEORAPLAY_VideoFormat vidfmt)
-{
+THEORAPLAY_Decoder* THEORAPLAY_startDecode(THEORAPLAY_Io* io, const unsigned int maxframes,
+                                           THEORAPLAY_VideoFormat vidfmt) {
+	return StartDecode(io, maxframes, vidfmt, "");
+}
+
+static THEORAPLAY_Decoder* StartDecode(THEORAPLAY_Io* io, const unsigned int maxframes,
+                                       THEORAPLAY_VideoFormat vidfmt, std::string filename) {
 	const auto ctx = new THEORAPLAY_Decoder;
 
 	ctx->maxframes = maxframes;
     ctx->vidfmt = vidfmt;
     ctx->io = io;
+	ctx->filename = std::move(filename);
+	ctx->state = std::make_unique<DecoderState>(ctx); // closes io from now on
+	ctx->lastUsed = std::chrono::steady_clock::now().time_since_epoch().count();
 
     try {
-        ctx->worker = std::thread(WorkerThreadEntry, ctx);
-        ctx->thread_created = true;
+		DecodePool::handle().add(ctx);
     } catch (std::system_error&) {
-        goto startdecode_failed;
+		delete ctx;
+		return nullptr;
 	}
-	return static_cast<THEORAPLAY_Decoder*>(ctx);
-
-startdecode_failed:
-    io->close(io);
-    delete ctx;
-    return nullptr;
+	return ctx;
 }
 
 void THEORAPLAY_stopDecode(THEORAPLAY_Decoder* const ctx) {
 	if (!ctx) {
 		return;
 	}
-	if (ctx->thread_created) {
-        ctx->halt = 1;
-        ctx->worker.join();
-	}
-
-    VideoFrame *videolist = ctx->videolist;
-    while (videolist)
-    {
-        VideoFrame *next = videolist->next;
-        free(videolist);
-        videolist = next;
-	}
+	DecodePool::handle().remove(ctx);
+	ctx->state.reset();
 
-    AudioPacket *audiolist = ctx->audiolist;
-    while (audiolist)
-    {
-        AudioPacket *next = audiolist->next;
-        free(audiolist->samples);
-        free(audiolist);
-        audiolist = next;
-	}
+	// frames are owned by ctx->framePool
+	FreeAudioList(ctx->audiolist);
+	FreeAudioList(ctx->audiopool);
 
     delete ctx;
 }
@@ -598,7 +998,7 @@ bool THEORAPLAY_isDecoding(THEORAPLAY_Decoder* const ctx) {
     {
         ctx->lock.lock();
         retval = ( ctx && (ctx->audiolist || ctx->videolist ||
-                   (ctx->thread_created && !ctx->thread_done)) );
+                   (!ctx->thread_done && !ctx->idle)) );
         ctx->lock.unlock();
     }
     return retval;
@@ -641,6 +1041,7 @@ bool THEORAPLAY_decodingError(THEORAPLAY_Decoder* const decoder) {
 }
 
 const THEORAPLAY_AudioPacket* THEORAPLAY_getAudio(THEORAPLAY_Decoder* const ctx) {
+	THEORAPLAY_touch(ctx);
 	AudioPacket *retval;
 
     ctx->lock.lock();
@@ -660,16 +1061,19 @@ const THEORAPLAY_AudioPacket* THEORAPLAY_getAudio(THEORAPLAY_Decoder* const ctx)
 }
 
 void THEORAPLAY_freeAudio(const THEORAPLAY_AudioPacket* item) {
-    if (item != nullptr)
-    {
-        assert(item->next == nullptr);
-        free(item->samples);
-		free(const_cast<THEORAPLAY_AudioPacket*>(item));
+	if (item != nullptr) {
+		assert(item->next == nullptr);
+		auto* const packet = const_cast<THEORAPLAY_AudioPacket*>(item);
+		std::scoped_lock lock(packet->decoder->lock);
+		packet->next = packet->decoder->audiopool;
+		packet->decoder->audiopool = packet;
 	}
 }
 
 const THEORAPLAY_VideoFrame* THEORAPLAY_getVideo(THEORAPLAY_Decoder* const ctx) {
+	THEORAPLAY_touch(ctx);
 	VideoFrame* retval;
+	bool wasFull = false;
 
     ctx->lock.lock();
     retval = ctx->videolist;
@@ -681,18 +1085,20 @@ const THEORAPLAY_VideoFrame* THEORAPLAY_getVideo(THEORAPLAY_Decoder* const ctx)
 			ctx->videolisttail = nullptr;
 		}
 		assert(ctx->videocount > 0);
+		wasFull = (ctx->videocount >= ctx->maxframes);
         ctx->videocount--;
     } // if
     ctx->lock.unlock();
 
+	if (wasFull) {
+		DecodePool::handle().wake(); // there's space again
+	}
     return retval;
 }
 
-void THEORAPLAY_freeVideo(const THEORAPLAY_VideoFrame* item) {
-	if (item != nullptr) {
-		assert(item->next == nullptr);
-		delete item;
-	}
+void THEORAPLAY_freeVideo([[maybe_unused]] const THEORAPLAY_VideoFrame* item) {
+	// nothing to do, the slot of the frame gets reused once the decoder comes around again
+	assert(item == nullptr || item->next == nullptr);
 }
 
 bool THEORAPLAY_threadDone(THEORAPLAY_Decoder* const ctx) {
@@ -700,5 +1106,45 @@ bool THEORAPLAY_threadDone(THEORAPLAY_Decoder* const ctx) {
 		return true;
 	}
 	std::scoped_lock lock(ctx->lock);
-	return ctx->thread_done;
+	return ctx->thread_done || ctx->idle;
+}
+
+bool THEORAPLAY_seek(THEORAPLAY_Decoder* const ctx, const unsigned int ms) {
+	if (!ctx || !ctx->io->seek) {
+		return false;
+	}
+	std::unique_lock lock(ctx->lock);
+	if (!ctx->hasvideo || ctx->thread_done) {
+		return false;
+	}
+	++ctx->seekRequest;
+	ctx->seekms = ms;
+	ctx->idle = false;
+
+	// Everything in the lists is from before the seek. Frames don't need to be freed, their slots
+	// get reused.
+	while (AudioPacket* item = ctx->audiolist) {
+		ctx->audiolist = item->next;
+		item->next = ctx->audiopool;
+		ctx->audiopool = item;
+	}
+	ctx->audiolisttail = nullptr;
+	ctx->audioms = 0;
+	ctx->videolist = nullptr;
+	ctx->videolisttail = nullptr;
+	ctx->videocount = 0;
+	lock.unlock();
+	DecodePool::handle().wake();
+	return true;
+}
+
+void THEORAPLAY_touch(THEORAPLAY_Decoder* const ctx) {
+	ctx->lastUsed = std::chrono::steady_clock::now().time_since_epoch().count();
+	if (ctx->paused.exchange(false)) {
+		DecodePool::handle().wake();
+	}
+}
+
+void THEORAPLAY_setWorkerThreads(const unsigned int count) {
+	DecodePool::handle().setThreads(count);
 }
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 struct THEORAPLAY_Io
@@ -15,6 +16,9 @@ struct THEORAPLAY_Io
     long (*read)(THEORAPLAY_Io *io, void *buf, long buflen);
     void (*close)(THEORAPLAY_Io *io);
     void *userdata;
+    /// Jumps to \a offset bytes from the start, returns 0 on success. nullptr if the source can't
+    /// seek, THEORAPLAY_seek will fail then.
+    int (*seek)(THEORAPLAY_Io *io, long offset);
 };
 
 struct THEORAPLAY_Decoder;
@@ -44,6 +48,8 @@ struct THEORAPLAY_AudioPacket {
 	int frames;
 	float* samples; /* frames * channels float32 samples. */
 	struct THEORAPLAY_AudioPacket* next;
+	size_t capacity;             /* number of floats samples can hold */
+	THEORAPLAY_Decoder* decoder; /* THEORAPLAY_freeAudio puts the packet back into its pool */
 };
 
 THEORAPLAY_Decoder* THEORAPLAY_startDecodeFile(const char* fname, unsigned int maxframes,
@@ -60,11 +66,31 @@ bool THEORAPLAY_hasAudioStream(THEORAPLAY_Decoder*);
 unsigned int THEORAPLAY_availableVideo(THEORAPLAY_Decoder*);
 unsigned int THEORAPLAY_availableAudio(THEORAPLAY_Decoder*);
 
+/// Packets are recycled, so they have to be freed before calling THEORAPLAY_stopDecode
 const THEORAPLAY_AudioPacket *THEORAPLAY_getAudio(THEORAPLAY_Decoder*);
 void THEORAPLAY_freeAudio(const THEORAPLAY_AudioPacket *item);
 
+/// Frames live in a pool of maxframes + 2 slots which is reused in order, so at most two frames may
+/// be held at once and they are only valid until THEORAPLAY_stopDecode
 const THEORAPLAY_VideoFrame *THEORAPLAY_getVideo(THEORAPLAY_Decoder*);
 void THEORAPLAY_freeVideo(const THEORAPLAY_VideoFrame *item);
 
-/// is the background thread done decoding? (returns true before THEORAPLAY_isDecoding)
+/// is the background decoding done? (returns true before THEORAPLAY_isDecoding)
 bool THEORAPLAY_threadDone(THEORAPLAY_Decoder*);
+
+/// All decoders share a few threads. Decoders which haven't been touched for 100 ms stop decoding
+/// once they have at least one frame buffered. THEORAPLAY_getVideo and THEORAPLAY_getAudio touch
+/// the decoder, call this if a video is visible but doesn't need a new frame right now.
+void THEORAPLAY_touch(THEORAPLAY_Decoder*);
+
+/// Maximum number of threads shared by all decoders, 2 by default. Threads which have already been
+/// started keep running.
+void THEORAPLAY_setWorkerThreads(unsigned int count);
+
+/// Drops everything decoded so far and continues with the first video frame at \a ms
+///
+/// On the first call the decoder thread reads the whole file once to find the keyframes, that index
+/// is cached per file name. After that it only has to decode from the nearest keyframe before
+/// \a ms. Audio packets start at \a ms, too. Returns false if the video can't seek (no video
+/// stream, THEORAPLAY_Io::seek is nullptr or the decoder thread stopped because of an error).
+bool THEORAPLAY_seek(THEORAPLAY_Decoder*, unsigned int ms);
@@ -0,0 +1,45 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+
+#include "../TextureCache.hpp"
+#include "Fixture.hpp"
+
+#include <boost/ut.hpp>
+#include <fstream>
+#include <jngl.hpp>
+
+namespace {
+boost::ut::suite _ = [] {
+	using namespace boost::ut; // NOLINT
+	"loadAtlas"_test = [] {
+		{
+			std::ofstream manifest("atlas-test.txt");
+			manifest << "jngl-atlas 1\n"
+			            "page 600 300 ../data/jngl.png\n"
+			            "region 0 0 0 600 300 600 300 whole\n"
+			            "region 0 300 0 300 300 150 150 right half\n";
+		}
+		jngl::loadAtlas("atlas-test.txt");
+		std::string expected;
+		{
+			Fixture f(1);
+			jngl::Sprite sprite("../data/jngl.png");
+			sprite.setPos(-60, -30);
+			sprite.draw(jngl::modelview().scale(0.2f, 0.2f));
+			expected = f.getAsciiArt();
+		}
+		Fixture f(1);
+		jngl::Sprite whole("whole.png"); // the extension is optional
+		whole.setPos(-60, -30);
+		whole.draw(jngl::modelview().scale(0.2f, 0.2f));
+		expect(eq(f.getAsciiArt(), expected));
+
+		jngl::Sprite right("right half");
+		expect(approx(right.getWidth(), 150, 1e-9));
+		expect(approx(right.getHeight(), 150, 1e-9));
+		// Both regions share the texture of the page:
+		expect(jngl::TextureCache::handle().get("../data/jngl.png") != nullptr);
+		expect(throws([] { jngl::loadAtlas("non existing file"); }));
+	};
+};
+} // namespace
@@ -0,0 +1,99 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+
+#include "../audio/kernels.hpp"
+
+#include <algorithm>
+#include <boost/ut.hpp>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+boost::ut::suite _ = [] {
+	using namespace boost::ut; // NOLINT
+
+	"AudioKernels"_test = [] {
+		const auto all = jngl::audio::available_kernels();
+		expect(eq(std::string(all.front()->name), std::string("scalar")));
+		expect(eq(std::string(jngl::audio::kernels().name), std::string(all.back()->name)));
+		const auto& scalar = *all.front();
+
+		std::mt19937 gen(42); // NOLINT
+		std::uniform_real_distribution<float> dist(-1.5f, 1.5f);
+		// odd sizes so that every implementation has to handle its remainder
+		for (const std::size_t size : { 0, 1, 7, 30, 131, 1002 }) {
+			std::vector<float> src(size + 4);
+			std::vector<float> dst(size);
+			for (auto& s : src) { s = dist(gen); }
+			for (auto& s : dst) { s = dist(gen); }
+			std::vector<std::uint32_t> index(size / 2);
+			std::vector<float> frac(size / 2);
+			for (std::size_t i = 0; i < index.size(); ++i) {
+				index[i] = static_cast<std::uint32_t>(gen() % (size / 2));
+				frac[i] = std::uniform_real_distribution<float>(0.f, 1.f)(gen);
+			}
+
+			for (const auto* kernel : all) {
+				auto bitEqual = [](const auto& a, const auto& b) {
+					return a.size() == b.size() &&
+					       (a.empty() ||
+					        std::memcmp(a.data(), b.data(), a.size() * sizeof(a[0])) == 0);
+				};
+				{
+					auto expected = dst;
+					auto actual = dst;
+					scalar.mix_add(expected.data(), src.data(), size);
+					kernel->mix_add(actual.data(), src.data(), size);
+					expect(bitEqual(expected, actual)) << kernel->name << "mix_add" << size;
+				}
+				{
+					auto expected = dst;
+					auto actual = dst;
+					scalar.gain_stereo(expected.data(), size, 0.3f, 1.7f);
+					kernel->gain_stereo(actual.data(), size, 0.3f, 1.7f);
+					expect(bitEqual(expected, actual)) << kernel->name << "gain_stereo" << size;
+				}
+				{
+					std::vector<float> expected(index.size() * 2);
+					std::vector<float> actual(index.size() * 2);
+					scalar.lerp_stereo(expected.data(), src.data(), index.data(), frac.data(),
+					                   index.size());
+					kernel->lerp_stereo(actual.data(), src.data(), index.data(), frac.data(),
+					                    index.size());
+					expect(bitEqual(expected, actual)) << kernel->name << "lerp_stereo" << size;
+				}
+				{
+					constexpr std::size_t taps = 16;
+					std::vector<float> filter(2 * taps);
+					for (auto& c : filter) { c = dist(gen); }
+					std::vector<const float*> coefficients(index.size(), filter.data());
+					std::vector<float> wide(src.size() + 2 * taps);
+					std::copy(src.begin(), src.end(), wide.begin());
+					std::vector<float> expected(index.size() * 2);
+					std::vector<float> actual(index.size() * 2);
+					scalar.fir_stereo(expected.data(), wide.data(), index.data(),
+					                  coefficients.data(), index.size(), taps);
+					kernel->fir_stereo(actual.data(), wide.data(), index.data(),
+					                   coefficients.data(), index.size(), taps);
+					expect(bitEqual(expected, actual)) << kernel->name << "fir_stereo" << size;
+				}
+				{
+					std::vector<std::int16_t> expected(size);
+					std::vector<std::int16_t> actual(size);
+					scalar.to_s16(expected.data(), dst.data(), size);
+					kernel->to_s16(actual.data(), dst.data(), size);
+					expect(bitEqual(expected, actual)) << kernel->name << "to_s16" << size;
+				}
+			}
+		}
+
+		std::int16_t converted[3];
+		const float extremes[3] = { -2.f, 0.f, 2.f };
+		jngl::audio::kernels().to_s16(converted, extremes, 3);
+		expect(eq(converted[0], -32768));
+		expect(eq(converted[1], 0));
+		expect(eq(converted[2], 32767));
+	};
+};
+} // namespace
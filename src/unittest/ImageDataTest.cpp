@@ -3,6 +3,7 @@
 
 #include "../jngl/ImageData.hpp"
 
+#include <algorithm>
 #include <boost/ut.hpp>
 
 namespace {
@@ -26,6 +27,19 @@ boost::ut::suite _ = [] {
 		}
 		expect(eq(jngl::ImageData::load("../data/jngl.webp")->getImageWidth(), 600));
 		expect(eq(jngl::ImageData::load("../data/jngl")->getImageHeight(), 300));
+
+		const auto half = jngl::ImageData::load("../data/jngl.png", 0.5);
+		expect(eq(half->getWidth(), 300));
+		expect(eq(half->getHeight(), 150));
+		expect(eq(half->getImageWidth(), 600));
+		expect(eq(half->pixels()[3], 0)); // top left corner is transparent
+	};
+	"QOI"_test = [] {
+		const auto qoi = jngl::ImageData::load("../data/jngl.qoi");
+		const auto png = jngl::ImageData::load("../data/jngl.png");
+		expect(eq(qoi->getWidth(), 600));
+		expect(eq(qoi->getHeight(), 300));
+		expect(std::equal(qoi->pixels(), qoi->pixels() + 600 * 300 * 4, png->pixels()));
 	};
 };
 } // namespace
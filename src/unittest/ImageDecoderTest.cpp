@@ -0,0 +1,130 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+
+#include "../ImageDecoder.hpp"
+
+#include <boost/ut.hpp>
+
+namespace {
+
+void append32(std::vector<uint8_t>& out, const uint32_t value) {
+	for (int i = 0; i < 4; ++i) {
+		out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+	}
+}
+
+/// Minimal KTX 2.0 file with one level and no data format descriptor
+std::vector<uint8_t> ktx2(const uint32_t vkFormat, const uint32_t width, const uint32_t height,
+                          const std::vector<uint8_t>& blocks) {
+	const char identifier[] = "\xABKTX 20\xBB\r\n\x1A\n";
+	std::vector<uint8_t> file(identifier, identifier + 12);
+	for (const uint32_t value : { vkFormat, 1u, width, height, 0u, 0u, 1u, 1u, 0u, 0u, 0u, 0u,
+	                              0u, 0u, 0u, 0u, 0u }) {
+		append32(file, value); // vkFormat, typeSize, size, depth, counts and empty indices
+	}
+	for (const uint64_t value : { uint64_t(80 + 24), uint64_t(blocks.size()),
+	                              uint64_t(width * height * 4) }) {
+		append32(file, static_cast<uint32_t>(value));
+		append32(file, 0);
+	}
+	file.insert(file.end(), blocks.begin(), blocks.end());
+	return file;
+}
+
+/// Minimal KTX 1.1 file with one level and no key/value data
+std::vector<uint8_t> ktx1(const uint32_t glInternalFormat, const uint32_t width,
+                          const uint32_t height, const std::vector<uint8_t>& blocks) {
+	const char identifier[] = "\xABKTX 11\xBB\r\n\x1A\n";
+	std::vector<uint8_t> file(identifier, identifier + 12);
+	for (const uint32_t value : { 0x04030201u, 0u, 1u, 0u, glInternalFormat, 0x1908u, width,
+	                              height, 0u, 0u, 1u, 1u, 0u,
+	                              static_cast<uint32_t>(blocks.size()) }) {
+		append32(file, value);
+	}
+	file.insert(file.end(), blocks.begin(), blocks.end());
+	return file;
+}
+
+std::vector<uint8_t> decode(jngl::ImageDecoder& decoder) {
+	std::vector<uint8_t> pixels(static_cast<std::size_t>(decoder.getWidth()) *
+	                            decoder.getHeight() * 4);
+	decoder.decode(pixels.data(), static_cast<std::size_t>(decoder.getWidth()) * 4, true);
+	return pixels;
+}
+
+std::vector<int> pixel(const std::vector<uint8_t>& pixels, const int x, const int y,
+                       const int width = 4) {
+	const uint8_t* p = &pixels[(y * width + x) * 4];
+	return { p[0], p[1], p[2], p[3] };
+}
+
+boost::ut::suite _ = [] {
+	using namespace boost::ut;
+	"KTX"_test = [] {
+		{ // BC1: red and blue endpoints, the first row uses all four palette entries
+			const std::vector<uint8_t> block{ 0x00, 0xF8, 0x1F, 0x00, 0xE4, 0, 0, 0 };
+			const auto decoder = jngl::ImageDecoder::create("bc1.ktx2", ktx2(131, 4, 4, block));
+			expect(eq(decoder->getWidth(), 4));
+			expect(decoder->getCompressed() != nullptr);
+			expect(eq(decoder->getCompressed()->size, std::size_t(8)));
+			expect(decoder->getCompressed()->format == jngl::ImageDecoder::CompressedFormat::BC1);
+			const auto pixels = decode(*decoder);
+			expect(pixel(pixels, 0, 0) == std::vector<int>{ 255, 0, 0, 255 });
+			expect(pixel(pixels, 1, 0) == std::vector<int>{ 0, 0, 255, 255 });
+			expect(pixel(pixels, 2, 0) == std::vector<int>{ 170, 0, 85, 255 });
+			expect(pixel(pixels, 3, 0) == std::vector<int>{ 85, 0, 170, 255 });
+			expect(pixel(pixels, 3, 3) == std::vector<int>{ 255, 0, 0, 255 });
+		}
+		{ // ETC2 individual mode: left half bright red, right half black; pixels are column-major
+			const std::vector<uint8_t> block{ 0xF0, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x10 };
+			const auto decoder = jngl::ImageDecoder::create("etc.ktx2", ktx2(147, 4, 4, block));
+			const auto pixels = decode(*decoder);
+			expect(pixel(pixels, 0, 0) == std::vector<int>{ 253, 0, 0, 255 }); // -2
+			expect(pixel(pixels, 1, 0) == std::vector<int>{ 255, 8, 8, 255 }); // +8
+			expect(pixel(pixels, 0, 1) == std::vector<int>{ 255, 2, 2, 255 }); // +2
+			expect(pixel(pixels, 3, 3) == std::vector<int>{ 2, 2, 2, 255 });
+		}
+		{ // ETC2 planar mode (blue overflows), red gradient from left to right
+			const uint64_t bits = (uint64_t(1) << 42) | (uint64_t(1) << 33) | // planar mode
+			                      (uint64_t(0x1f) << 34) | (uint64_t(1) << 32); // RH = 63
+			std::vector<uint8_t> block(8);
+			for (int i = 0; i < 8; ++i) {
+				block[i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+			}
+			const auto decoder = jngl::ImageDecoder::create("planar.ktx2", ktx2(147, 4, 4, block));
+			const auto pixels = decode(*decoder);
+			expect(pixel(pixels, 0, 0) == std::vector<int>{ 0, 0, 0, 255 });
+			expect(pixel(pixels, 3, 0) == std::vector<int>{ 191, 0, 0, 255 });
+			expect(pixel(pixels, 3, 3) == std::vector<int>{ 191, 0, 0, 255 });
+		}
+		{ // ETC2 RGBA8 via KTX 1.1: EAC alpha 100 + table 0 * multiplier 2
+			const std::vector<uint8_t> block{ 100,  0x20, 0xE0, 0,    0,    0,    0,    0,
+				                              0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+			const auto decoder = jngl::ImageDecoder::create("etc.ktx", ktx1(0x9278, 4, 4, block));
+			const auto pixels = decode(*decoder);
+			expect(eq(pixel(pixels, 0, 0)[3], 100 + 28)); // index 7: +14 * 2
+			expect(eq(pixel(pixels, 1, 0)[3], 100 - 6));   // index 0: -3 * 2
+			expect(eq(pixel(pixels, 0, 0)[0], 255));
+		}
+		{ // Partial blocks at the right and bottom edge
+			const std::vector<uint8_t> block{ 0x00, 0xF8, 0x00, 0xF8, 0, 0, 0, 0 };
+			std::vector<uint8_t> blocks;
+			for (int i = 0; i < 4; ++i) {
+				blocks.insert(blocks.end(), block.begin(), block.end());
+			}
+			const auto decoder = jngl::ImageDecoder::create("edge.ktx2", ktx2(131, 5, 6, blocks));
+			const auto pixels = decode(*decoder);
+			expect(pixel(pixels, 4, 5, 5) == std::vector<int>{ 255, 0, 0, 255 });
+		}
+		{ // No CPU fallback for BC7
+			const auto decoder =
+			    jngl::ImageDecoder::create("bc7.ktx2", ktx2(145, 4, 4, std::vector<uint8_t>(16)));
+			expect(throws([&] { decode(*decoder); }));
+		}
+		expect(throws([] { // truncated
+			jngl::ImageDecoder::create("short.ktx2", ktx2(131, 8, 8, std::vector<uint8_t>(8)));
+		}));
+	};
+};
+
+} // namespace
@@ -0,0 +1,86 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+
+#include "../jngl/Mat3.hpp"
+#include "../jngl/Pixels.hpp"
+
+#include <boost/ut.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+boost::ut::suite _ = [] {
+	using namespace boost::ut; // NOLINT
+
+	"Mat3"_test = [] {
+		using boost::qvm::operator*;
+		std::mt19937 gen(42); // NOLINT
+		std::uniform_real_distribution<float> dist(-3.f, 3.f);
+		for (int i = 0; i < 100; ++i) {
+			jngl::Mat3 generic;
+			for (float& element : generic.data) {
+				element = dist(gen);
+			}
+			jngl::Mat3 fast = generic;
+			const float x = dist(gen);
+			const float y = dist(gen);
+			const float radian = dist(gen);
+
+			// The affine shortcuts have to match qvm's generic 3x3 multiplication:
+			generic = generic * boost::qvm::translation_mat(boost::qvm::vec<double, 2>{ { x, y } });
+			boost::qvm::rotate_z(generic, radian);
+			generic = generic * boost::qvm::diag_mat(boost::qvm::vec<float, 3>{ { x, y, 1 } });
+			fast.translate(jngl::Pixels(x), jngl::Pixels(y)).rotate(radian).scale(x, y);
+			for (int j = 0; j < 9; ++j) {
+				expect(approx(fast.data[j], generic.data[j], 1e-5f));
+			}
+
+			jngl::Mat3 other;
+			for (float& element : other.data) {
+				element = dist(gen);
+			}
+			expect(!other.isAffine());
+			generic = generic * other;
+			fast *= other;
+			for (int j = 0; j < 9; ++j) {
+				expect(approx(fast.data[j], generic.data[j], 1e-4f));
+			}
+		}
+	};
+
+	"transformBatch"_test = [] {
+		std::mt19937 gen(42); // NOLINT
+		std::uniform_real_distribution<float> dist(-3.f, 3.f);
+		const auto random = [&]() {
+			return jngl::Mat3()
+			    .translate(jngl::Pixels(dist(gen)), jngl::Pixels(dist(gen)))
+			    .rotate(dist(gen))
+			    .scale(dist(gen), dist(gen));
+		};
+		// sizes which aren't a multiple of the SIMD width, so that the remainder is tested too
+		for (const std::size_t size : { 0, 1, 3, 4, 7, 130 }) {
+			const jngl::Mat3 parent = random();
+			expect(parent.isAffine());
+			std::vector<jngl::Mat3> expected;
+			jngl::Mat3Batch children;
+			for (std::size_t i = 0; i < size; ++i) {
+				const jngl::Mat3 child = random();
+				children.push_back(child);
+				expected.push_back(parent);
+				expected.back() *= child;
+			}
+			jngl::Mat3Batch out;
+			jngl::transformBatch(parent, children, out);
+			jngl::transformBatch(parent, children, children); // in-place
+			expect(eq(out.size(), size));
+			for (std::size_t i = 0; i < size; ++i) {
+				for (int j = 0; j < 9; ++j) {
+					// bit-identical, no matter whether SIMD is used or not
+					expect(eq(out[i].data[j], expected[i].data[j]));
+					expect(eq(children[i].data[j], expected[i].data[j]));
+				}
+			}
+		}
+	};
+};
+} // namespace
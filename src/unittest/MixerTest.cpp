@@ -0,0 +1,201 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+
+#include "../audio/CallbackStatistics.hpp"
+#include "../audio/OfflineRenderer.hpp"
+#include "../audio/SubmixWorkers.hpp"
+#include "../audio/effect/volume.hpp"
+#include "../audio/mixer.hpp"
+#include "../jngl/sound.hpp"
+
+#include <boost/ut.hpp>
+#include <memory>
+#include <vector>
+
+namespace {
+
+/// Returns 1 for a fixed number of samples, counts how often it had to produce them
+struct Constant : jngl::Stream {
+	explicit Constant(std::size_t length) : length(length) {
+	}
+	std::size_t read(float* data, std::size_t sample_count) override {
+		++reads;
+		const auto count = std::min(sample_count, length - position);
+		std::fill(data, data + count, 1.f);
+		position += count;
+		return count;
+	}
+	std::size_t skip(std::size_t sample_count) override {
+		const auto count = std::min(sample_count, length - position);
+		position += count;
+		return count;
+	}
+	void rewind() override {
+		position = 0;
+	}
+	bool isPlaying() const override {
+		return position < length;
+	}
+	std::size_t length;
+	std::size_t position = 0;
+	int reads = 0;
+};
+
+boost::ut::suite _ = [] {
+	using namespace boost::ut; // NOLINT
+
+	"MixerVirtualVoices"_test = [] {
+		jngl::Mixer mixer;
+		std::vector<std::shared_ptr<Constant>> streams;
+		// more than 256 commands without the mixer thread reading, mustn't block or get lost
+		const std::size_t count = 300;
+		for (std::size_t i = 0; i < count; ++i) {
+			streams.emplace_back(std::make_shared<Constant>(1000));
+			mixer.add(jngl::audio::volume(streams.back(), i == 0 ? 0.f : 1.f),
+			          i == count - 1 ? 1 : 0);
+		}
+		float out[100];
+		jngl::Stream& stream = mixer;
+		expect(eq(stream.read(out, 100), std::size_t(100))); // only pops 256 commands
+		mixer.add(std::make_shared<Constant>(0)); // flushes the remaining ones
+		expect(eq(stream.read(out, 100), std::size_t(100)));
+
+		expect(eq(out[0], float(jngl::Mixer::MAX_MIXED_STREAMS)));
+		expect(eq(streams.front()->reads, 0)) << "muted streams are never mixed";
+		expect(eq(streams.back()->reads, 1)) << "higher priority wins";
+		std::size_t mixed = 0;
+		for (std::size_t i = 0; i < count; ++i) {
+			// the last ones have only been added by the second read
+			expect(eq(streams[i]->position, std::size_t(i < 256 ? 200 : 100)))
+			    << "virtual voices advance, too";
+			mixed += streams[i]->reads > 0 ? 1 : 0;
+		}
+		expect(le(mixed, 2 * jngl::Mixer::MAX_MIXED_STREAMS));
+	};
+
+	"MixerParallel"_test = [] {
+		// Every submix gets its own volume and length, so that the sum depends on all of them
+		const auto fill = [](jngl::Mixer& mixer) {
+			for (int i = 0; i < 16; ++i) {
+				auto submix = std::make_shared<jngl::Mixer>();
+				for (int j = 0; j < 4; ++j) {
+					submix->add(jngl::audio::volume(std::make_shared<Constant>(300 + 100 * j),
+					                                0.1f * static_cast<float>(j + 1)));
+				}
+				mixer.add(jngl::audio::volume(submix, 1.f / static_cast<float>(i + 1)));
+			}
+		};
+		jngl::Mixer serial;
+		fill(serial);
+		jngl::Mixer parallel;
+		fill(parallel);
+		jngl::audio::SubmixWorkers workers(3);
+		parallel.setWorkers(&workers);
+
+		float expected[128];
+		float out[128];
+		for (int block = 0; block < 8; ++block) {
+			jngl::Stream& serialStream = serial;
+			jngl::Stream& parallelStream = parallel;
+			expect(eq(parallelStream.read(out, 128), serialStream.read(expected, 128)));
+			for (std::size_t i = 0; i < 128; ++i) {
+				expect(eq(out[i], expected[i]));
+			}
+		}
+		expect(out[0] == 0.f) << "all Constants have ended";
+		// submixes never end on their own
+		expect(eq(parallel.activeStreamCount(), std::size_t(16)));
+		expect(eq(parallel.mixedStreamCount(), std::size_t(16)));
+	};
+
+	"MixerScheduling"_test = [] {
+		jngl::Mixer mixer;
+		auto channel = std::make_shared<jngl::Mixer>(mixer.clock());
+		mixer.add(channel);
+		auto stream = std::make_shared<Constant>(1000);
+		mixer.add(stream, 0, 100);
+		// two halves of 50 frames each, stitched together on a Mixer which doesn't own the clock
+		channel->add(std::make_shared<Constant>(100), 0, 10);
+		channel->add(std::make_shared<Constant>(100), 0, 60);
+
+		float out[256];
+		jngl::Stream& stream0 = mixer;
+		stream0.read(out, 256); // frames 0 to 127
+		expect(eq(mixer.clock()->frames.load(), std::int64_t(128)));
+		for (std::size_t i = 0; i < 256; ++i) {
+			const float expected = (i >= 20 && i < 220 ? 1.f : 0.f) + (i >= 200 ? 1.f : 0.f);
+			expect(eq(out[i], expected)) << i;
+		}
+		expect(eq(stream->position, std::size_t(56))) << "starts exactly at frame 100";
+
+		mixer.remove(stream.get(), 150);
+		stream0.read(out, 256); // frames 128 to 255
+		for (std::size_t i = 0; i < 256; ++i) {
+			expect(eq(out[i], i < 44 ? 1.f : 0.f)) << i;
+		}
+		expect(eq(stream->position, std::size_t(100))) << "stops exactly at frame 150";
+		expect(eq(channel->activeStreamCount(), std::size_t(0)));
+		expect(eq(mixer.activeStreamCount(), std::size_t(1))) << "only the channel is left";
+	};
+
+	"CallbackStatistics"_test = [] {
+		using std::chrono::milliseconds;
+		jngl::audio::CallbackStatistics callbackStatistics;
+		jngl::AudioStatistics statistics;
+		callbackStatistics.snapshot(statistics);
+		expect(eq(statistics.averageCallback.count(), 0));
+
+		// 256 frames at 51200 Hz give the callback 5 ms
+		for (int i = 0; i < 98; ++i) {
+			callbackStatistics.record(milliseconds(1), 256, 51200);
+		}
+		callbackStatistics.record(milliseconds(10), 256, 51200);
+		callbackStatistics.record(milliseconds(10), 256, 51200);
+		callbackStatistics.snapshot(statistics);
+		expect(statistics.minCallback == milliseconds(1));
+		expect(statistics.p99Callback == milliseconds(10));
+		expect(statistics.averageCallback == std::chrono::microseconds(1180));
+		expect(approx(statistics.load, 1.18f / 5.f, 1e-4f));
+		expect(eq(statistics.lateCallbacks, std::uint64_t(2)));
+		expect(eq(statistics.bufferFrames, 256u));
+		expect(eq(statistics.sampleRate, 51200));
+
+		// only the last HISTORY callbacks count
+		for (std::size_t i = 0; i < jngl::audio::CallbackStatistics::HISTORY; ++i) {
+			callbackStatistics.record(milliseconds(2), 256, 51200);
+		}
+		callbackStatistics.snapshot(statistics);
+		expect(statistics.p99Callback == milliseconds(2));
+		expect(eq(statistics.lateCallbacks, std::uint64_t(2)));
+	};
+
+	"Volume smoothing"_test = [] {
+		const auto volume = jngl::audio::volume(std::make_shared<Constant>(1 << 20), 1.f, 0.05f);
+		volume->gain(0.3f);
+		std::vector<float> out(1024);
+		for (int i = 0; i < 100; ++i) { // more than 10 times the smoothness
+			volume->read(out.data(), out.size());
+		}
+		// the smoothed gain has to reach its target exactly, not stall an ulp away from it
+		volume->read(out.data(), out.size());
+		for (const float sample : out) {
+			expect(eq(sample, .3f));
+		}
+	};
+
+	"OfflineRenderer"_test = [] {
+		auto mixer = std::make_shared<jngl::Mixer>();
+		mixer->add(jngl::audio::volume(std::make_shared<Constant>(1000), 0.5f));
+		jngl::audio::OfflineRenderer renderer(mixer, 128);
+		std::vector<float> out;
+		const auto statistics = renderer.render(1000, &out);
+		expect(eq(statistics.frames, std::size_t(1000)));
+		expect(eq(statistics.blocks, std::size_t(8)));
+		expect(le(statistics.min, statistics.p99) and le(statistics.p99, statistics.max));
+		expect(eq(out.size(), std::size_t(2000)));
+		expect(eq(out[0], .5f));
+		expect(eq(out[999], .5f));
+		expect(eq(out[1000], 0.f)) << "the Constant has ended";
+	};
+};
+} // namespace
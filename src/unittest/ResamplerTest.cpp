@@ -0,0 +1,117 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+
+#include "../audio/Resampler.hpp"
+#include "../audio/effect/pitch.hpp"
+
+#include <algorithm>
+#include <boost/ut.hpp>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+
+namespace {
+
+/// Plays back interleaved stereo samples once
+struct Samples : jngl::Stream {
+	explicit Samples(std::vector<float> samples) : samples(std::move(samples)) {
+	}
+	std::size_t read(float* data, std::size_t sample_count) override {
+		const auto count = std::min(sample_count, samples.size() - position);
+		std::copy_n(samples.begin() + static_cast<std::ptrdiff_t>(position), count, data);
+		position += count;
+		return count;
+	}
+	void rewind() override {
+		position = 0;
+	}
+	bool isPlaying() const override {
+		return position < samples.size();
+	}
+	std::vector<float> samples;
+	std::size_t position = 0;
+};
+
+boost::ut::suite _ = [] {
+	using namespace boost::ut; // NOLINT
+
+	"Resampler"_test = [] {
+		// DC passes unchanged away from the edges
+		const std::vector<float> dc(1000, 0.25f);
+		const auto up = jngl::audio::Resampler::convert(dc, 1, 22050, 44100);
+		expect(eq(up.size(), 2000));
+		for (std::size_t i = 20; i < up.size() - 20; ++i) {
+			expect(approx(up[i], 0.25f, 1e-5f)) << i;
+		}
+
+		// a quiet tone well below the Nyquist frequency survives going up and down again
+		std::vector<float> stereo(2000);
+		for (std::size_t i = 0; i < stereo.size(); ++i) {
+			stereo[i] = std::sin(static_cast<float>(i / 2) * 0.1f);
+		}
+		const auto roundTrip = jngl::audio::Resampler::convert(
+		    jngl::audio::Resampler::convert(stereo, 2, 22050, 48000), 2, 48000, 22050);
+		expect(eq(roundTrip.size(), stereo.size() - 2)); // rounding down twice loses one frame
+		for (std::size_t i = 100; i < roundTrip.size() - 100; ++i) {
+			expect(approx(roundTrip[i], stereo[i], 0.02f)) << i;
+		}
+
+		// A tone above the new Nyquist frequency must not alias into the output
+		std::vector<float> high(48000);
+		for (std::size_t i = 0; i < high.size(); ++i) {
+			high[i] = std::sin(2 * std::numbers::pi_v<float> * 20000.f * static_cast<float>(i) /
+			                   48000.f);
+		}
+		const auto down = jngl::audio::Resampler::convert(high, 1, 48000, 22050);
+		float peak = 0;
+		for (std::size_t i = 100; i < down.size() - 100; ++i) {
+			peak = std::max(peak, std::abs(down[i]));
+		}
+		expect(lt(peak, 0.01f));
+	};
+
+	"pitch"_test = [] {
+		std::vector<float> tone(20000);
+		for (std::size_t i = 0; i < tone.size(); ++i) {
+			// 15 kHz at 44.1 kHz, would alias to 14.1 kHz when played twice as fast
+			tone[i] = std::sin(2 * std::numbers::pi_v<float> * 15000.f *
+			                   static_cast<float>(i / 2) / 44100.f);
+		}
+
+		// at the original pitch the samples have to pass through unchanged
+		const auto control = jngl::audio::pitch(std::make_shared<Samples>(tone));
+		std::vector<float> output(tone.size() + 100);
+		expect(eq(control->read(output.data(), output.size()), tone.size()));
+		expect(std::equal(tone.begin(), tone.end(), output.begin()));
+
+		// the cutoff has to follow pitch changes after construction
+		control->rewind();
+		control->pitch(2.f);
+		const auto count = control->read(output.data(), output.size());
+		expect(ge(count, tone.size() / 2));
+		float peak = 0;
+		for (std::size_t i = 100; i < count - 100; ++i) {
+			peak = std::max(peak, std::abs(output[i]));
+		}
+		expect(lt(peak, 0.05f));
+
+		// back at the original pitch the samples have to pass through unchanged again, just
+		// shifted by whole frames
+		std::vector<float> ramp(20000);
+		std::iota(ramp.begin(), ramp.end(), 0.f);
+		const auto bent = jngl::audio::pitch(std::make_shared<Samples>(ramp), 1.3f);
+		expect(eq(bent->read(output.data(), 1000), std::size_t(1000)));
+		bent->pitch(1.f);
+		expect(eq(bent->read(output.data(), 2000), std::size_t(2000)));
+		expect(std::fmod(output[0], 2.f) == 0.f) << "starts with a left sample";
+		for (std::size_t i = 2; i < 2000; ++i) {
+			expect(output[i] == output[i - 2] + 2) << "at" << i;
+		}
+
+		using jngl::audio::Resampler;
+		expect(&Resampler::forCutoff(0.6f) == &Resampler::forCutoff(0.5f));
+		expect(&Resampler::forCutoff(1.f) != &Resampler::forCutoff(0.99f));
+		expect(&Resampler::forCutoff(0.01f) == &Resampler::forCutoff(0.125f));
+	};
+};
+} // namespace
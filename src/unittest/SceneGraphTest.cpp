@@ -0,0 +1,88 @@
+// Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
+// For conditions of distribution and use, see copyright notice in LICENSE.txt
+
+#include "../jngl/Pixels.hpp"
+#include "../jngl/SceneGraph.hpp"
+
+#include <boost/ut.hpp>
+#include <stdexcept>
+
+namespace {
+boost::ut::suite _ = [] {
+	using namespace boost::ut; // NOLINT
+
+	const auto translation = [](const float x, const float y) {
+		return jngl::Mat3().translate(jngl::Pixels(x), jngl::Pixels(y));
+	};
+	const auto position = [](const jngl::Mat3& matrix) {
+		return std::pair{ matrix.data[6], matrix.data[7] };
+	};
+
+	"SceneGraph"_test = [&] {
+		jngl::SceneGraph scene;
+		const auto a = scene.add(jngl::SceneGraph::ROOT, translation(10, 0));
+		const auto b = scene.add(a, translation(0, 5));
+		const auto c = scene.add(b, translation(1, 1));
+		const auto d = scene.add(jngl::SceneGraph::ROOT, translation(-3, 0));
+		expect(eq(scene.size(), std::size_t(5)));
+		scene.update();
+		expect(eq(scene.getRecomputed(), std::size_t(4)));
+		expect(position(scene.getWorld(c)) == std::pair{ 11.f, 6.f });
+		expect(position(scene.getWorld(d)) == std::pair{ -3.f, 0.f });
+
+		scene.update(); // nothing changed
+		expect(eq(scene.getRecomputed(), std::size_t(0)));
+
+		// only the subtree of b has to be recomputed:
+		scene.setLocal(b, translation(0, 7));
+		scene.update();
+		expect(eq(scene.getRecomputed(), std::size_t(2)));
+		expect(position(scene.getWorld(c)) == std::pair{ 11.f, 8.f });
+		expect(position(scene.getWorld(a)) == std::pair{ 10.f, 0.f });
+
+		scene.setLocal(jngl::SceneGraph::ROOT, jngl::Mat3().scale(2));
+		scene.update();
+		expect(eq(scene.getRecomputed(), std::size_t(5)));
+		expect(position(scene.getWorld(c)) == std::pair{ 22.f, 16.f });
+
+		scene.remove(b);
+		expect(eq(scene.size(), std::size_t(3)));
+		expect(throws<std::runtime_error>([&] { scene.setLocal(c, {}); }));
+		expect(throws<std::runtime_error>([&] { scene.remove(jngl::SceneGraph::ROOT); }));
+		expect(position(scene.getWorld(d)) == std::pair{ -6.f, 0.f });
+
+		// slots get reused, but the stale handles stay invalid:
+		const auto e = scene.add(d, translation(0, 1));
+		expect(e != b && e != c);
+		expect(throws<std::runtime_error>([&] { scene.setLocal(b, {}); }));
+		expect(throws<std::runtime_error>([&] { scene.setLocal(c, {}); }));
+		// the new node is stored after its parent:
+		scene.setLocal(d, translation(1, 0));
+		scene.update();
+		expect(eq(scene.getRecomputed(), std::size_t(2)));
+		expect(position(scene.getWorld(e)) == std::pair{ 2.f, 2.f });
+		expect(position(scene.getWorld(a)) == std::pair{ 20.f, 0.f });
+	};
+
+	"SceneGraph::remove"_test = [&] {
+		jngl::SceneGraph scene;
+		const auto a = scene.add(jngl::SceneGraph::ROOT, translation(1, 0));
+		const auto b = scene.add(jngl::SceneGraph::ROOT, translation(2, 0));
+		const auto c = scene.add(b, translation(0, 3));
+		const auto d = scene.add(jngl::SceneGraph::ROOT, translation(4, 0));
+		scene.update();
+
+		// removing doesn't make anything dirty
+		scene.remove(d);
+		scene.update();
+		expect(eq(scene.getRecomputed(), std::size_t(0)));
+
+		// but pending changes of nodes which moved are kept
+		scene.setLocal(c, translation(0, 5));
+		scene.remove(a);
+		scene.update();
+		expect(eq(scene.getRecomputed(), std::size_t(1)));
+		expect(position(scene.getWorld(c)) == std::pair{ 2.f, 5.f });
+	};
+};
+} // namespace
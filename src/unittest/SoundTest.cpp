@@ -1,6 +1,8 @@
 // Copyright 2024 Jan Niklas Hasse <jhasse@bixense.com>
 // For conditions of distribution and use, see copyright notice in LICENSE.txt
 
+#include "../audio/Track.hpp"
+#include "../jngl/SoundFile.hpp"
 #include "../jngl/sound.hpp"
 
 #include <jngl.hpp>
@@ -16,5 +18,50 @@ boost::ut::suite _ = [] {
 		jngl::stop("../data/test.ogg");
         expect(!jngl::isPlaying("../data/test.ogg"));
 	};
+	"PlayingTrack"_test = [] {
+		// full scale has to round-trip, SoundFile encodes 1.f as 32767
+		jngl::PcmBuffer mono{ { 0, 32767, -32767 }, 1 };
+		jngl::PlayingTrack track(mono);
+		jngl::Stream& stream = track;
+		float out[8];
+		expect(eq(stream.read(out, 8), size_t(6)));
+		expect(eq(out[0], 0.f) and eq(out[1], 0.f));
+		expect(eq(out[2], 1.f) and eq(out[3], 1.f));
+		expect(eq(out[4], -1.f) and eq(out[5], -1.f));
+		expect(!stream.isPlaying());
+		track.seek(2);
+		expect(approx(track.progress(), 1.f / 3.f, 1e-6f));
+		expect(eq(stream.read(out, 8), size_t(4)));
+		expect(eq(out[0], 1.f));
+		jngl::PcmBuffer stereo{ { -16384, 16384 }, 2 };
+		track.reset(stereo); // used by pooled Sounds
+		expect(stream.isPlaying());
+		expect(eq(stream.read(out, 8), size_t(2)));
+		expect(approx(out[0], -.5f, 1e-4f) and approx(out[1], .5f, 1e-4f));
+	};
+	"AsyncSoundFile"_test = [] {
+		jngl::SoundFile missing("does not exist.ogg", std::launch::async);
+		expect(throws<std::runtime_error>([&missing] { missing.load(); }));
+		jngl::SoundFile async("../data/test.ogg", std::launch::async);
+		jngl::SoundFile deferred("../data/test.ogg", std::launch::deferred);
+		expect(gt(async.length().count(), 0));
+		expect(eq(async.length().count(), deferred.length().count()));
+	};
+	"StreamingSound"_test = [] {
+		jngl::setStreamingThreshold(std::chrono::milliseconds(0));
+		jngl::SoundFile streamed("../data/test.ogg");
+		jngl::setStreamingThreshold(std::chrono::milliseconds::max());
+		jngl::SoundFile decoded("../data/test.ogg");
+		expect(streamed.isStreaming());
+		expect(!decoded.isStreaming());
+		// decoded file has been resampled, so there might be a rounding difference
+		expect(approx(streamed.length().count(), decoded.length().count(), 1));
+		streamed.play();
+		expect(streamed.isPlaying());
+		streamed.seek(streamed.length() / 2);
+		streamed.stop();
+		expect(!streamed.isPlaying());
+		jngl::setStreamingThreshold(std::chrono::seconds(30));
+	};
 };
 } // namespace
@@ -1,6 +1,7 @@
 // Copyright 2018-2024 Jan Niklas Hasse <jhasse@bixense.com>
 // For conditions of distribution and use, see copyright notice in LICENSE.txt
 
+#include "../TextureCache.hpp"
 #include "../jngl/sprite.hpp"
 #include "Fixture.hpp"
 
@@ -8,6 +9,7 @@
 
 #include <boost/ut.hpp>
 #include <cmath>
+#include <vector>
 
 namespace {
 boost::ut::suite _ = [] {
@@ -48,6 +50,59 @@ boost::ut::suite _ = [] {
 			expect(approx(sprite.getBottom(), -124.1f, 1e-5));
 		}
 	};
+	"Deduplication"_test = [] {
+		Fixture f(1);
+		jngl::Sprite png("../data/jngl.png");
+		jngl::Sprite qoi("../data/jngl.qoi"); // same pixels, should share the texture
+		auto& cache = jngl::TextureCache::handle();
+		expect(cache.get("../data/jngl.png") == cache.get("../data/jngl.qoi"));
+		expect(eq(cache.getBytesSaved(), std::size_t(600 * 300 * 4)));
+		expect(eq(jngl::getSpriteStatistics().deduplicatedBytes, cache.getBytesSaved()));
+
+		const auto drawQoi = [&]() {
+			qoi.draw(jngl::modelview().scale(0.2f));
+			return f.getAsciiArt();
+		};
+		const auto before = drawQoi();
+		const std::vector<uint8_t> transparent(std::size_t(600 * 300 * 4), 0);
+		png.setBytes(transparent.data());
+		expect(eq(drawQoi(), before)) << "setBytes mustn't change Sprites sharing the texture";
+	};
+	"Deduplication with trimming"_test = [] {
+		Fixture f(1);
+		jngl::Sprite png("../data/jngl.png");
+		jngl::setSpriteTrimming(true);
+		jngl::Sprite qoi("../data/jngl.qoi"); // same pixels, but gets an alpha hull
+		jngl::setSpriteTrimming(false);
+		auto& cache = jngl::TextureCache::handle();
+		expect(cache.get("../data/jngl.png") != cache.get("../data/jngl.qoi"));
+		expect(eq(cache.getBytesSaved(), std::size_t(0)));
+	};
+	"Trimming"_test = [] {
+		Fixture f(1);
+		jngl::setSpriteTrimming(true);
+		jngl::Sprite sprite("../data/jngl.png");
+		jngl::setSpriteTrimming(false);
+		const auto before = jngl::getSpriteStatistics();
+		sprite.draw(jngl::modelview());
+		const auto after = jngl::getSpriteStatistics();
+		expect(approx(after.rectanglePixels - before.rectanglePixels, 600 * 300, 1e-3));
+		// jngl.png has transparent corners, the octagon around the logo should be a lot smaller:
+		expect(lt(after.drawnPixels - before.drawnPixels, 0.9 * 600 * 300));
+	};
+	"setBytes resets the hull"_test = [] {
+		Fixture f(1);
+		jngl::setSpriteTrimming(true);
+		const auto imageData = jngl::ImageData::load("../data/jngl.png");
+		jngl::Sprite sprite(*imageData, 1); // not cached, so setBytes doesn't need to copy
+		jngl::setSpriteTrimming(false);
+		const std::vector<uint8_t> opaque(std::size_t(600 * 300 * 4), 255);
+		sprite.setBytes(opaque.data());
+		const auto before = jngl::getSpriteStatistics();
+		sprite.draw(jngl::modelview());
+		const auto after = jngl::getSpriteStatistics();
+		expect(approx(after.drawnPixels - before.drawnPixels, 600 * 300, 1e-3));
+	};
 	"Loader"_test = []() {
 		for (float factor : { 1.f, 2.f, 3.4f }) {
 			Fixture f(factor);
@@ -1,6 +1,7 @@
 // Copyright 2018-2024 Jan Niklas Hasse <jhasse@bixense.com>
 // For conditions of distribution and use, see copyright notice in LICENSE.txt
 
+#include "../helper.hpp"
 #include "../jngl/Finally.hpp"
 #include "../jngl/input.hpp"
 #include "../jngl/other.hpp"
@@ -9,6 +10,7 @@
 
 #include <boost/ut.hpp>
 #include <filesystem>
+#include <string_view>
 
 boost::ut::suite _ = [] {
 	using namespace boost::ut;
@@ -62,6 +64,18 @@ boost::ut::suite _ = [] {
 		expect(throws<std::runtime_error>([] { jngl::load("jngl"); }));
 	};
 
+	"hash64"_test = [] {
+		// known answers of XXH64, the 46 bytes one covers the 32 byte stripes
+		const auto hash = [](const std::string_view text, const uint64_t seed = 0) {
+			return jngl::hash64(text.data(), text.size(), seed);
+		};
+		expect(hash("") == 0xEF46DB3751D8E999);
+		expect(hash("a") == 0xD24EC4F1A98C6E5B);
+		expect(hash("abc") == 0x44BC2CF5AD770999);
+		expect(hash("0123456789abcdefghijklmnopqrstuvwxyz0123456789") == 0x4AE5684CD402FBB4);
+		expect(hash("", 1) == 0xD5AFBA1336A3BE4B);
+	};
+
 	"getBinaryPath"_test = [] { expect(!jngl::getBinaryPath().empty()); };
 
 	"readAsset"_test = [] {
@@ -4,6 +4,8 @@
 
 #include <boost/ut.hpp>
 #include <jngl/matrix.hpp>
+#include <jngl/other.hpp>
+#include <jngl/screen.hpp>
 #include <jngl/shapes.hpp>
 
 namespace {
@@ -31,5 +33,27 @@ boost::ut::suite _ = [] {
 )")));
 		}
 	};
+	"culling"_test = [] {
+		for (double scaleFactor : { 1, 2 }) {
+			Fixture f(scaleFactor);
+			const auto count = [before = jngl::getCullingStatistics()]() {
+				const auto after = jngl::getCullingStatistics();
+				return std::pair{ after.drawn - before.drawn, after.culled - before.culled };
+			};
+			const auto half = jngl::getScreenSize() / 2.;
+			const jngl::Vec2 size(10, 10);
+			const jngl::Color black(0, 0, 0);
+			jngl::drawRect(jngl::modelview().translate({ half.x + 1, 0 }), size, black);
+			jngl::drawRect(jngl::modelview().translate(half - jngl::Vec2(5, 5)), size, black);
+			jngl::drawCircle(jngl::modelview().translate({ 0, -half.y - 6 }), 5);
+			jngl::drawCircle(jngl::modelview().translate({ 0, -half.y - 4 }), 5);
+			expect(count() == std::pair{ std::size_t(2), std::size_t(2) });
+
+			jngl::setCulling(false);
+			jngl::drawRect(jngl::modelview().translate({ half.x + 1, 0 }), size, black);
+			jngl::setCulling(true);
+			expect(count() == std::pair{ std::size_t(3), std::size_t(2) });
+		}
+	};
 };
 } // namespace
@@ -4,12 +4,15 @@
 #include "window.hpp"
 
 #include "audio.hpp"
+#include "culling.hpp"
 #include "freetype.hpp"
 #include "jngl/ScaleablePixels.hpp"
 #include "jngl/font.hpp"
 #include "jngl/matrix.hpp"
 #include "jngl/other.hpp"
 #include "jngl/screen.hpp"
+#include "jngl/shapes.hpp"
+#include "jngl/sound.hpp"
 #include "jngl/time.hpp"
 #include "jngl/work.hpp"
 #include "log.hpp"
@@ -416,7 +419,8 @@ void Window::draw() const {
 	if (currentWork_) {
 		jngl::reset();
 		jngl::setColor(0xffffff_rgb, 255);
-		jngl::drawRect(-getScreenSize() / 2., jngl::Vec2(400, 100));
+		const auto audio = Audio::handleIfAlive();
+		jngl::drawRect(-getScreenSize() / 2., jngl::Vec2(400, audio ? 250 : 100));
 		jngl::setFontColor(0x000000_rgb, 1.f);
 		{
 			std::ostringstream tmp;
@@ -428,6 +432,31 @@ void Window::draw() const {
 			tmp << "draw: " << static_cast<double>(us.count()) / 1000. << " ms";
 			jngl::print(tmp.str(), -getScreenSize() / 2. + jngl::Vec2(50, 60));
 		}
+		if (audio) {
+			const auto statistics = audio->getStatistics();
+			const auto ms = [](std::chrono::nanoseconds duration) {
+				return static_cast<double>(duration.count()) / 1e6;
+			};
+			{
+				std::ostringstream tmp;
+				tmp << "audio: " << ms(statistics.minCallback) << " / "
+				    << ms(statistics.averageCallback) << " / " << ms(statistics.p99Callback)
+				    << " ms";
+				jngl::print(tmp.str(), -getScreenSize() / 2. + jngl::Vec2(50, 110));
+			}
+			{
+				std::ostringstream tmp;
+				tmp << std::lround(statistics.load * 100) << "% load, "
+				    << statistics.lateCallbacks << " late callbacks";
+				jngl::print(tmp.str(), -getScreenSize() / 2. + jngl::Vec2(50, 160));
+			}
+			{
+				std::ostringstream tmp;
+				tmp << "voices: " << statistics.mixedVoices << " / " << statistics.activeVoices
+				    << ", " << statistics.bufferFrames << " @ " << statistics.sampleRate << " Hz";
+				jngl::print(tmp.str(), -getScreenSize() / 2. + jngl::Vec2(50, 210));
+			}
+		}
 	}
 #endif
 }
@@ -554,33 +583,41 @@ void Window::drawLine(Mat3 modelview, const Vec2 b) const {
 }
 
 void Window::drawRect(const Vec2 pos, const Vec2 size) const {
-	glBindVertexArray(vaoRect);
 	pushMatrix();
 	translate(pos);
 	opengl::scale(static_cast<float>(size.x * getScaleFactor()),
 	              static_cast<float>(size.y * getScaleFactor()));
+	if (cull(opengl::modelview, Vec2(0, 0), Vec2(1, 1))) {
+		popMatrix();
+		return;
+	}
+	glBindVertexArray(vaoRect);
 	auto tmp = useSimpleShaderProgram();
 	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 	popMatrix();
 }
 
 void Window::drawRect(Mat3 modelview, const Vec2 size, Rgba color) const {
+	modelview.scale(size.x * jngl::getScaleFactor(), size.y * jngl::getScaleFactor());
+	if (cull(modelview, Vec2(0, 0), Vec2(1, 1))) {
+		return;
+	}
 	glBindVertexArray(vaoRect);
 	auto context = jngl::simpleShaderProgram->use();
 	glUniform4f(simpleColorUniform, color.getRed(), color.getGreen(), color.getBlue(),
 	            color.getAlpha());
-	glUniformMatrix3fv(
-	    simpleModelviewUniform, 1, GL_FALSE,
-	    modelview.scale(size.x * jngl::getScaleFactor(), size.y * jngl::getScaleFactor()).data);
+	glUniformMatrix3fv(simpleModelviewUniform, 1, GL_FALSE, modelview.data);
 	glEnableVertexAttribArray(0);
 	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 }
 
 void Window::drawRect(Mat3 modelview, const Vec2 size) const {
+	modelview.scale(size.x * jngl::getScaleFactor(), size.y * jngl::getScaleFactor());
+	if (cull(modelview, Vec2(0, 0), Vec2(1, 1))) {
+		return;
+	}
 	glBindVertexArray(vaoRect);
-	auto tmp = useSimpleShaderProgram(
-	    modelview.scale(size.x * jngl::getScaleFactor(), size.y * jngl::getScaleFactor()),
-	    gShapeColor);
+	auto tmp = useSimpleShaderProgram(modelview, gShapeColor);
 	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 }
 